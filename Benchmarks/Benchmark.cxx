@@ -0,0 +1,298 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+// ! Throughput of the lexer, the parser and the renderer over a small corpus
+// ! of representative templates, build and run it with
+// !     python3 Setup.py Benchmark
+// ! or by hand
+// !     g++ -std=c++17 -O2 -ILibraries -ISource Benchmarks/Benchmark.cxx -o Benchmark
+// !     ./Benchmark [--min-time=Seconds] [--visitor] [Filter]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Sydonia.hxx"
+
+namespace Benchmark{
+    using Sydonia::JSON;
+    using Clock = std::chrono::steady_clock;
+
+    struct Case{
+        std::string Name;
+        std::string Source;
+        JSON Data;
+        // ! Templates reachable through Include and Extends, in dependency order
+        std::vector<std::pair<std::string, std::string>> Includes;
+    };
+
+    // ! Keeps the optimizer from discarding the measured work
+    volatile size_t Sink {0};
+
+    // ! Runs Body until at least MinimumSeconds have passed and returns the
+    // ! average number of seconds per run
+    template<typename Function>
+    double Measure(Function &&Body, double MinimumSeconds){
+        Body();
+        size_t Iterations = 0;
+        double Elapsed = 0;
+        const auto Start = Clock::now();
+        do{
+            Body();
+            Iterations += 1;
+            Elapsed = std::chrono::duration<double>(Clock::now() - Start).count();
+        }while(Elapsed < MinimumSeconds);
+        return Elapsed / Iterations;
+    }
+
+    std::string Repeat(const std::string &Text, size_t Count){
+        std::string Result;
+        Result.reserve(Text.size() * Count);
+        for(size_t Iterator = 0; Iterator < Count; Iterator += 1)
+            Result += Text;
+        return Result;
+    }
+
+    Case StaticHtml(){
+        Case Result {"StaticHtml", "", JSON::object(), {}};
+        Result.Source = "<!DOCTYPE html><html><head><title>{{ Title }}</title></head><body>\n";
+        Result.Source += Repeat(
+            "<div class=\"card\">\n  <h2 class=\"card-title\">Lorem ipsum dolor sit amet</h2>\n"
+            "  <p class=\"card-body\">Consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+            "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris.</p>\n"
+            "  <a href=\"/articles/lorem-ipsum\" class=\"card-link\">Read more</a>\n</div>\n", 500);
+        Result.Source += "<footer>{{ Footer }}</footer></body></html>\n";
+        Result.Data["Title"] = "Static page";
+        Result.Data["Footer"] = "All rights reserved";
+        return Result;
+    }
+
+    // ! Inline CSS and JavaScript, full of braces and hashes that are not openers
+    Case ScriptHeavy(){
+        Case Result {"ScriptHeavy", "", JSON::object(), {}};
+        Result.Source = "<html><head><style>\n";
+        Result.Source += Repeat(".card{color:#333;background:#fafafa}#main .item{margin:0 auto;padding:4px}a:hover{color:#0a6}\n", 300);
+        Result.Source += "</style><script>\n";
+        Result.Source += Repeat("function Update(Item){ if(Item.Count > 0){ Item.Label = `#${Item.Id}`; } return {Id: Item.Id, Tags: []}; }\n", 300);
+        Result.Source += "</script></head><body><h1>{{ Title }}</h1></body></html>\n";
+        Result.Data["Title"] = "Script heavy page";
+        return Result;
+    }
+
+    Case DeepLoops(){
+        Case Result {"DeepLoops", "", JSON::object(), {}};
+        Result.Source =
+            "{% For Department In Departments %}<section>\n<h1>{{ Department.Name }}</h1>\n"
+            "{% For Team In Department.Teams %}<table>\n<caption>{{ Team.Name }} ({{ Loop.Parent.Index1 }}.{{ Loop.Index1 }})</caption>\n"
+            "{% For Member In Team.Members %}<tr class=\"{% If Loop.IsFirst %}first{% Else %}row{% EndIf %}\">"
+            "<td>{{ Member.Name }}</td><td>{{ Member.Age }}</td><td>{{ Member.Email }}</td>"
+            "<td>{% If Member.Active %}yes{% Else %}no{% EndIf %}</td></tr>\n{% EndFor %}</table>\n{% EndFor %}</section>\n{% EndFor %}";
+        JSON Departments = JSON::array();
+        for(int DepartmentIndex = 0; DepartmentIndex < 20; DepartmentIndex += 1){
+            JSON Department;
+            Department["Name"] = "Department " + std::to_string(DepartmentIndex);
+            for(int TeamIndex = 0; TeamIndex < 10; TeamIndex += 1){
+                JSON Team;
+                Team["Name"] = "Team " + std::to_string(TeamIndex);
+                for(int MemberIndex = 0; MemberIndex < 10; MemberIndex += 1){
+                    const std::string Name = "member" + std::to_string(DepartmentIndex) + "-" + std::to_string(TeamIndex) + "-" + std::to_string(MemberIndex);
+                    Team["Members"].push_back({{"Name", Name}, {"Age", 20 + MemberIndex * 3}, {"Email", Name + "@example.com"}, {"Active", MemberIndex % 3 != 0}});
+                }
+                Department["Teams"].push_back(Team);
+            }
+            Departments.push_back(Department);
+        }
+        Result.Data["Departments"] = Departments;
+        return Result;
+    }
+
+    Case IfChains(){
+        Case Result {"IfChains", "", JSON::object(), {}};
+        Result.Source =
+            "{% For Item In Items %}{{ Item.Id }}:"
+            "{% If Item.Score >= 90 %}A{% Else If Item.Score >= 80 %}B{% Else If Item.Score >= 70 %}C"
+            "{% Else If Item.Score >= 60 %}D{% Else If Item.Score >= 50 %}E{% Else %}F{% EndIf %} "
+            "{% If Item.Status == \"open\" %}open{% Else If Item.Status == \"closed\" %}closed"
+            "{% Else If Item.Status == \"blocked\" %}blocked{% Else %}unknown{% EndIf %}"
+            "{% If Item.Priority > 2 And Not Item.Archived %} !{% EndIf %}\n{% EndFor %}";
+        const char* Statuses[] = {"open", "closed", "blocked", "draft"};
+        for(int Iterator = 0; Iterator < 2000; Iterator += 1)
+            Result.Data["Items"].push_back({{"Id", Iterator}, {"Score", (Iterator * 37) % 100}, {"Status", Statuses[Iterator % 4]},
+                                            {"Priority", Iterator % 5}, {"Archived", Iterator % 7 == 0}});
+        return Result;
+    }
+
+    Case Inheritance(){
+        Case Result {"Inheritance", "", JSON::object(), {}};
+        Result.Includes = {
+            {"Header.html", "<header><nav>{% For Link In Navigation %}<a href=\"{{ Link.Url }}\">{{ Link.Title }}</a>{% EndFor %}</nav></header>\n"},
+            {"Footer.html", "<footer>{{ Site.Name }} - {{ Site.Year }}</footer>\n"},
+            {"Post.html", "<h2>{{ Post.Title }}</h2><p>{{ Post.Summary }}</p><small>{{ Post.Author }}</small>\n"},
+            {"Base.html", "<!DOCTYPE html><html><head><title>{% Block Title %}{{ Site.Name }}{% EndBlock %}</title></head><body>\n"
+                          "{% Include \"Header.html\" %}<main>{% Block Content %}{% EndBlock %}</main>\n{% Include \"Footer.html\" %}</body></html>\n"},
+        };
+        Result.Source =
+            "{% Extends \"Base.html\" %}{% Block Title %}{{ Page.Title }}{% EndBlock %}"
+            "{% Block Content %}{% For Post In Page.Posts %}<article>{% Include \"Post.html\" %}</article>\n{% EndFor %}{% EndBlock %}";
+        Result.Data["Site"] = {{"Name", "Example"}, {"Year", 2024}};
+        for(int Iterator = 0; Iterator < 8; Iterator += 1)
+            Result.Data["Navigation"].push_back({{"Url", "/section/" + std::to_string(Iterator)}, {"Title", "Section " + std::to_string(Iterator)}});
+        Result.Data["Page"]["Title"] = "Latest posts";
+        for(int Iterator = 0; Iterator < 200; Iterator += 1)
+            Result.Data["Page"]["Posts"].push_back({{"Title", "Post number " + std::to_string(Iterator)},
+                                                    {"Summary", "A short summary of what the post is about, long enough to look real."},
+                                                    {"Author", "Author " + std::to_string(Iterator % 13)}});
+        return Result;
+    }
+
+    Case Builtins(){
+        Case Result {"Builtins", "", JSON::object(), {}};
+        Result.Source =
+            "{% For Row In Rows %}{{ Upper(Row.Name) }} {{ Lower(Row.Tag) }} [{{ Join(Sort(Row.Words), \", \") }}] "
+            "{{ Length(Row.Words) }} {{ Max(Row.Numbers) }} {{ Min(Row.Numbers) }} {{ Round(Row.Ratio, 2) }} "
+            "{{ First(Row.Words) }}/{{ Last(Row.Words) }}{% If Even(Loop.Index) %} even{% EndIf %}"
+            "{% If Exists(\"Missing\") %}?{% EndIf %} {{ Default(Row.Nickname, Row.Name) }}\n{% EndFor %}";
+        const char* Words[] = {"delta", "alpha", "echo", "charlie", "bravo", "golf", "foxtrot", "hotel"};
+        for(int Iterator = 0; Iterator < 500; Iterator += 1){
+            JSON Row;
+            Row["Name"] = "row name " + std::to_string(Iterator);
+            Row["Tag"] = "TAG-" + std::to_string(Iterator % 17);
+            for(int Word = 0; Word < 8; Word += 1){
+                Row["Words"].push_back(Words[(Iterator + Word * 3) % 8]);
+                Row["Numbers"].push_back((Iterator * 31 + Word * 7) % 1000);
+            }
+            Row["Ratio"] = Iterator / 7.0;
+            if(Iterator % 2)
+                Row["Nickname"] = "nick" + std::to_string(Iterator);
+            Result.Data["Rows"].push_back(Row);
+        }
+        return Result;
+    }
+
+    // ! A report that is mostly arithmetic and comparisons on numbers
+    Case Numeric(){
+        Case Result {"Numeric", "", JSON::object(), {}};
+        Result.Source =
+            "{% For Line In Lines %}{{ Line.Quantity * Line.Price }} {{ Line.Quantity * Line.Price - Line.Discount }} "
+            "{{ (Line.Total + Line.Tax) % 1000 }} {{ Line.Ratio * 100 + 0.5 }} {{ Loop.Index ^ 2 }}"
+            "{% If Line.Total > 50000 And Line.Ratio < 0.5 %} large{% Else If Line.Total >= 10000 %} medium{% EndIf %}"
+            "{% If Line.Quantity == Line.Previous + 1 %} next{% EndIf %}\n{% EndFor %}";
+        for(int Iterator = 0; Iterator < 2000; Iterator += 1){
+            const long long Total = static_cast<long long>(Iterator) * 48271 % 100000;
+            Result.Data["Lines"].push_back({{"Quantity", Iterator % 37}, {"Price", 1000 + Iterator % 250}, {"Discount", Iterator % 13},
+                                            {"Total", Total}, {"Tax", Total / 5}, {"Ratio", (Iterator % 100) / 100.0}, {"Previous", (Iterator + 36) % 37}});
+        }
+        return Result;
+    }
+
+    // ! Conditions whose second half is only needed for some of the rows, and
+    // ! can only be evaluated for those
+    Case Guards(){
+        Case Result {"Guards", "", JSON::object(), {}};
+        Result.Source =
+            "{% For Row In Rows %}{{ Row.Id }}:"
+            "{% If Row.Active And Length(Sort(Row.Words)) > 4 %} words{% EndIf %}"
+            "{% If ExistsIn(Row, \"Extra\") And Row.Extra.Level > 2 %} extra{% EndIf %}"
+            "{% If Row.Hidden Or Max(Row.Numbers) < 500 %} low{% EndIf %}"
+            "{% If Row.Hidden Or Join(Sort(Row.Words), \"\") == \"\" %} none{% EndIf %}\n{% EndFor %}";
+        const char* Words[] = {"delta", "alpha", "echo", "charlie", "bravo", "golf", "foxtrot", "hotel"};
+        for(int Iterator = 0; Iterator < 1000; Iterator += 1){
+            JSON Row;
+            Row["Id"] = Iterator;
+            Row["Active"] = Iterator % 8 == 0;
+            Row["Hidden"] = Iterator % 8 != 0;
+            for(int Word = 0; Word < 8; Word += 1){
+                Row["Words"].push_back(Words[(Iterator + Word * 3) % 8]);
+                Row["Numbers"].push_back((Iterator * 31 + Word * 7) % 1000);
+            }
+            if(Iterator % 10 == 0)
+                Row["Extra"]["Level"] = Iterator % 5;
+            Result.Data["Rows"].push_back(Row);
+        }
+        return Result;
+    }
+
+    size_t CountTokens(const Sydonia::LexerConfiguration &Configuration, const std::string &Source){
+        Sydonia::Lexer LexerInstance(Configuration);
+        LexerInstance.Start(Source);
+        size_t Count = 0;
+        while(LexerInstance.Scan().KindInstance != Sydonia::Token::Kind::Eof)
+            Count += 1;
+        return Count;
+    }
+
+    void Run(const Case &CaseLocal, double MinimumSeconds, bool UseCompiledProgram){
+        Sydonia::LexerConfiguration LexerConfigurationInstance;
+        Sydonia::ParserConfiguration ParserConfigurationInstance;
+        Sydonia::RenderConfiguration RenderConfigurationInstance;
+        RenderConfigurationInstance.UseCompiledProgram = UseCompiledProgram;
+        Sydonia::FunctionStorage FunctionStorageInstance;
+        Sydonia::TemplateStorage TemplateStorageInstance;
+
+        for(const auto &Include : CaseLocal.Includes){
+            Sydonia::Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+            TemplateStorageInstance[Include.first] = std::make_shared<const Sydonia::Template>(ParserLocal.Parse(Include.second));
+        }
+
+        const size_t Tokens = CountTokens(LexerConfigurationInstance, CaseLocal.Source);
+        const double LexSeconds = Measure([&](){
+            Sink = Sink + CountTokens(LexerConfigurationInstance, CaseLocal.Source);
+        }, MinimumSeconds);
+
+        const double ParseSeconds = Measure([&](){
+            Sydonia::Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+            Sink = Sink + ParserLocal.Parse(CaseLocal.Source).Root.Nodes.size();
+        }, MinimumSeconds);
+
+        Sydonia::Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+        const Sydonia::Template TemplateLocal = ParserLocal.Parse(CaseLocal.Source);
+        std::string Output;
+        const double RenderSeconds = Measure([&](){
+            Output.clear();
+            Sydonia::OutputSink SinkLocal(Output);
+            Sydonia::Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance).RenderTo(SinkLocal, TemplateLocal, CaseLocal.Data);
+            Sink = Sink + Output.size();
+        }, MinimumSeconds);
+
+        std::printf("%-12s %9zu %12.2f %12.1f %12.1f %12.1f %12.1f %10zu\n", CaseLocal.Name.c_str(), CaseLocal.Source.size(),
+                    Tokens / LexSeconds / 1e6, CaseLocal.Source.size() / LexSeconds / 1e6, 1.0 / ParseSeconds, 1.0 / RenderSeconds, Output.size() / RenderSeconds / 1e6, Output.size());
+    }
+}; // ! Benchmark namespace
+
+int main(int ArgumentCount, char** ArgumentValues){
+    double MinimumSeconds = 0.5;
+    bool UseCompiledProgram = true;
+    std::string Filter;
+    for(int Iterator = 1; Iterator < ArgumentCount; Iterator += 1){
+        const std::string Argument = ArgumentValues[Iterator];
+        if(Argument.rfind("--min-time=", 0) == 0)
+            MinimumSeconds = std::atof(Argument.c_str() + 11);
+        else if(Argument == "--visitor")
+            UseCompiledProgram = false;
+        else
+            Filter = Argument;
+    }
+
+    const std::vector<Benchmark::Case> Corpus = {
+        Benchmark::StaticHtml(), Benchmark::ScriptHeavy(), Benchmark::DeepLoops(), Benchmark::IfChains(), Benchmark::Inheritance(), Benchmark::Builtins(),
+        Benchmark::Guards(), Benchmark::Numeric()
+    };
+    std::printf("Rendering with the %s\n", UseCompiledProgram ? "compiled program" : "AST visitor");
+    std::printf("%-12s %9s %12s %12s %12s %12s %12s %10s\n", "Case", "Bytes", "Lex Mtok/s", "Lex MB/s", "Parse /s", "Render /s", "Render MB/s", "Output");
+    for(const auto &CaseLocal : Corpus)
+        if(Filter.empty() || CaseLocal.Name.find(Filter) != std::string::npos)
+            Benchmark::Run(CaseLocal, MinimumSeconds, UseCompiledProgram);
+    return 0;
+}
\ No newline at end of file
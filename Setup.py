@@ -10,7 +10,7 @@
 # ****/
 
 from os import system
-import sys, platform, time
+import os, sys, platform, time
 
 k = {
     'OperativeSystem': platform.system(),
@@ -22,7 +22,11 @@ Configuration = {
         'Folder': 'Source/',
         'Main': 'Sydonia.hxx'
     },
-    'SingleFileOutput': 'Sydonia.hxx'
+    'SingleFileOutput': 'Sydonia.hxx',
+    'Benchmark': {
+        'Source': 'Benchmarks/Benchmark.cxx',
+        'Output': 'Benchmarks/Benchmark'
+    }
 }
 
 def ClearScreen() -> None:
@@ -84,8 +88,25 @@ def DoSingleFile() -> None:
 )
 ''')
 
+def DoBenchmark() -> None:
+    print('''\
+: Sydonia<Setup> - Running The Benchmarks
+
+: = The benchmarks are compiled with optimizations and then 
+: = executed, they measure how fast templates are lexed, parsed 
+: = and rendered, set the CXX environment variable to use another 
+: = compiler.
+''')
+    Compiler = os.environ.get('CXX', 'g++')
+    Source, Output = Configuration['Benchmark']['Source'], Configuration['Benchmark']['Output']
+    if system(f'{Compiler} -std=c++17 -O2 -DNDEBUG -ILibraries -I{Configuration["Source"]["Folder"]} {Source} -o {Output}') != 0:
+        print(': Sydonia<Setup> - The benchmarks could not be compiled.')
+        sys.exit(1)
+    system(f'./{Output}' if k.get('OperativeSystem', 'Linux') != 'Windows' else Output)
+
 ArgumentsCallback = {
-    'dosinglefile': DoSingleFile
+    'dosinglefile': DoSingleFile,
+    'benchmark': DoBenchmark
 }
 
 try:
@@ -114,7 +135,7 @@ try:
     time.sleep(7)
     ClearScreen()
     for Argument in k.get('CallArguments', []) :
-        if Argument in ArgumentsCallback:
+        if Argument.lower() in ArgumentsCallback:
             ArgumentsCallback[Argument.lower()]()
         else:
             print(f':-: Argument "{Argument}" is invalid.')
@@ -0,0 +1,287 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_ARITHMETIC_HXX
+#define SYDONIA_ARITHMETIC_HXX
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace Sydonia{
+    // ! Kernels of the arithmetic and comparison operators picked by the types of
+    // ! their operands, integers are computed in 64 bits, signed first and then
+    // ! unsigned when neither is negative, and become floats when the result
+    // ! does not fit, integers of either sign are compared exactly
+    namespace Arithmetic{
+        using Integer = JSON::number_integer_t;
+        using Unsigned = JSON::number_unsigned_t;
+        using Float = JSON::number_float_t;
+
+        enum class Kind : std::uint8_t{
+            Integer,
+            Unsigned,
+            Float,
+            String,
+            Other
+        };
+
+        inline Kind KindOf(const JSON &Value){
+            switch(Value.type()){
+                case JSON::value_t::number_integer: return Kind::Integer;
+                case JSON::value_t::number_unsigned: return Kind::Unsigned;
+                case JSON::value_t::number_float: return Kind::Float;
+                case JSON::value_t::string: return Kind::String;
+                default: return Kind::Other;
+            }
+        }
+
+        // ! An integer operand as a signed value, false when it does not fit
+        inline bool AsInteger(const JSON &Value, Integer &Result){
+            if(Value.is_number_integer() && !Value.is_number_unsigned()){
+                Result = *Value.get_ptr<const Integer*>();
+                return true;
+            }
+            if(Value.is_number_unsigned() && *Value.get_ptr<const Unsigned*>() <= static_cast<Unsigned>(std::numeric_limits<Integer>::max())){
+                Result = static_cast<Integer>(*Value.get_ptr<const Unsigned*>());
+                return true;
+            }
+            return false;
+        }
+
+        inline bool AsIntegers(const JSON &Left, const JSON &Right, Integer &First, Integer &Second){
+            return AsInteger(Left, First) && AsInteger(Right, Second);
+        }
+
+        // ! An integer operand as an unsigned value, false when it is negative
+        inline bool AsUnsigned(const JSON &Value, Unsigned &Result){
+            if(Value.is_number_unsigned()){
+                Result = *Value.get_ptr<const Unsigned*>();
+                return true;
+            }
+            if(Value.is_number_integer() && *Value.get_ptr<const Integer*>() >= 0){
+                Result = static_cast<Unsigned>(*Value.get_ptr<const Integer*>());
+                return true;
+            }
+            return false;
+        }
+
+        inline bool AsUnsigneds(const JSON &Left, const JSON &Right, Unsigned &First, Unsigned &Second){
+            return AsUnsigned(Left, First) && AsUnsigned(Right, Second);
+        }
+
+        inline bool AddChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_add_overflow(First, Second, &Result);
+#else
+            if((Second > 0 && First > std::numeric_limits<Integer>::max() - Second) || (Second < 0 && First < std::numeric_limits<Integer>::min() - Second))
+                return false;
+            Result = First + Second;
+            return true;
+#endif
+        }
+
+        inline bool SubtractChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_sub_overflow(First, Second, &Result);
+#else
+            if((Second < 0 && First > std::numeric_limits<Integer>::max() + Second) || (Second > 0 && First < std::numeric_limits<Integer>::min() + Second))
+                return false;
+            Result = First - Second;
+            return true;
+#endif
+        }
+
+        inline bool MultiplyChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(First, Second, &Result);
+#else
+            constexpr Integer Maximum = std::numeric_limits<Integer>::max(), Minimum = std::numeric_limits<Integer>::min();
+            if(First > 0 ? (Second > 0 ? First > Maximum / Second : Second < Minimum / First)
+                         : (Second > 0 ? First < Minimum / Second : (First != 0 && Second < Maximum / First)))
+                return false;
+            Result = First * Second;
+            return true;
+#endif
+        }
+
+        inline bool AddChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_add_overflow(First, Second, &Result);
+#else
+            Result = First + Second;
+            return Result >= First;
+#endif
+        }
+
+        inline bool SubtractChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_sub_overflow(First, Second, &Result);
+#else
+            if(First < Second)
+                return false;
+            Result = First - Second;
+            return true;
+#endif
+        }
+
+        inline bool MultiplyChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(First, Second, &Result);
+#else
+            if(First != 0 && Second > std::numeric_limits<Unsigned>::max() / First)
+                return false;
+            Result = First * Second;
+            return true;
+#endif
+        }
+
+        inline bool PowerChecked(Integer Base, Integer Exponent, Integer &Result){
+            Integer Value = 1;
+            while(Exponent > 0){
+                if((Exponent & 1) && !MultiplyChecked(Value, Base, Value))
+                    return false;
+                Exponent >>= 1;
+                if(Exponent > 0 && !MultiplyChecked(Base, Base, Base))
+                    return false;
+            }
+            Result = Value;
+            return true;
+        }
+
+        // ! Any number as JSON converts it, booleans included
+        inline Float AsFloat(const JSON &Value){
+            switch(Value.type()){
+                case JSON::value_t::number_integer: return static_cast<Float>(*Value.get_ptr<const Integer*>());
+                case JSON::value_t::number_unsigned: return static_cast<Float>(*Value.get_ptr<const Unsigned*>());
+                case JSON::value_t::number_float: return *Value.get_ptr<const Float*>();
+                default: return Value.get<Float>();
+            }
+        }
+
+        inline void Add(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(Left.is_string() && Right.is_string()){
+                // ! The result keeps the storage of the string it replaces
+                if(!Result.is_string())
+                    Result = std::string();
+                auto &Text = Result.get_ref<std::string&>();
+                Text.assign(Left.get_ref<const std::string&>());
+                Text.append(Right.get_ref<const std::string&>());
+            }else if(AsIntegers(Left, Right, First, Second) && AddChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && AddChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else
+                Result = AsFloat(Left) + AsFloat(Right);
+        }
+
+        inline void Subtract(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(AsIntegers(Left, Right, First, Second) && SubtractChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && SubtractChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && UnsignedSecond - UnsignedFirst - 1 <= static_cast<Unsigned>(std::numeric_limits<Integer>::max()))
+                // ! A negative difference of two unsigned values down to the minimum
+                Result = -static_cast<Integer>(UnsignedSecond - UnsignedFirst - 1) - 1;
+            else
+                Result = AsFloat(Left) - AsFloat(Right);
+        }
+
+        inline void Multiply(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(AsIntegers(Left, Right, First, Second) && MultiplyChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && MultiplyChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else
+                Result = AsFloat(Left) * AsFloat(Right);
+        }
+
+        inline void Power(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer Base, Exponent, Value;
+            if(AsIntegers(Left, Right, Base, Exponent) && Exponent >= 0 && PowerChecked(Base, Exponent, Value))
+                Result = Value;
+            else
+                Result = std::pow(AsFloat(Left), AsFloat(Right));
+        }
+
+        // ! False when the divisor is zero
+        inline bool Modulo(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second;
+            if(AsIntegers(Left, Right, First, Second)){
+                if(Second == 0)
+                    return false;
+                // ! The minimum divided by -1 overflows, its remainder is zero anyway
+                Result = (Second == -1) ? Integer(0) : First % Second;
+                return true;
+            }
+            Unsigned UnsignedFirst, UnsignedSecond;
+            if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond)){
+                if(UnsignedSecond == 0)
+                    return false;
+                Result = UnsignedFirst % UnsignedSecond;
+                return true;
+            }
+            const Float Divisor = AsFloat(Right);
+            if(Divisor == 0)
+                return false;
+            Result = std::fmod(AsFloat(Left), Divisor);
+            return true;
+        }
+
+        // ! Orders two integers of any signedness exactly, a negative one is less
+        // ! than any unsigned one, negative when Left is less and zero when equal
+        inline int CompareIntegers(const JSON &Left, const JSON &Right){
+            const bool LeftNegative = !Left.is_number_unsigned() && *Left.get_ptr<const Integer*>() < 0;
+            const bool RightNegative = !Right.is_number_unsigned() && *Right.get_ptr<const Integer*>() < 0;
+            if(LeftNegative != RightNegative)
+                return LeftNegative ? -1 : 1;
+            if(LeftNegative){
+                const Integer First = *Left.get_ptr<const Integer*>(), Second = *Right.get_ptr<const Integer*>();
+                return (First < Second) ? -1 : (First > Second);
+            }
+            Unsigned First, Second;
+            AsUnsigneds(Left, Right, First, Second);
+            return (First < Second) ? -1 : (First > Second);
+        }
+
+        inline bool Less(const JSON &Left, const JSON &Right){
+            const Kind First = KindOf(Left), Second = KindOf(Right);
+            if(First == Kind::Other || Second == Kind::Other || (First == Kind::String) != (Second == Kind::String))
+                return Left < Right;
+            if(First == Kind::String)
+                return Left.get_ref<const std::string&>() < Right.get_ref<const std::string&>();
+            if(First == Kind::Float || Second == Kind::Float)
+                return AsFloat(Left) < AsFloat(Right);
+            return CompareIntegers(Left, Right) < 0;
+        }
+
+        inline bool Equal(const JSON &Left, const JSON &Right){
+            const Kind First = KindOf(Left), Second = KindOf(Right);
+            if(First == Kind::Other || Second == Kind::Other || (First == Kind::String) != (Second == Kind::String))
+                return Left == Right;
+            if(First == Kind::String)
+                return Left.get_ref<const std::string&>() == Right.get_ref<const std::string&>();
+            if(First == Kind::Float || Second == Kind::Float)
+                return AsFloat(Left) == AsFloat(Right);
+            return CompareIntegers(Left, Right) == 0;
+        }
+    }; // ! Arithmetic namespace
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_ARITHMETIC_HXX
\ No newline at end of file
@@ -0,0 +1,133 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_CHARACTER_SCANNER_HXX
+#define SYDONIA_CHARACTER_SCANNER_HXX
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SYDONIA_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SYDONIA_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace Sydonia{
+    // ! Finds the next byte that belongs to a small set of characters, the
+    // ! lexer uses it to skip over static text until a possible opener, up to
+    // ! four characters are compared 32 (AVX2) or 16 (SSE2) bytes at a time
+    // ! and a lookup table handles larger sets and the remaining bytes
+    class CharacterScanner{
+        static constexpr size_t MaximumVectorCharacters {4};
+
+        std::array<bool, 256> Table {};
+        std::array<char, MaximumVectorCharacters> Characters {};
+        size_t Count {0};
+
+        static unsigned CountTrailingZeros(std::uint32_t Mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long Index;
+            _BitScanForward(&Index, Mask);
+            return static_cast<unsigned>(Index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(Mask));
+#endif
+        }
+
+        public:
+            explicit CharacterScanner(std::string_view Set){
+                for(const char Character : Set){
+                    if(Table[static_cast<unsigned char>(Character)])
+                        continue;
+                    Table[static_cast<unsigned char>(Character)] = true;
+                    if(Count < MaximumVectorCharacters)
+                        Characters[Count] = Character;
+                    Count += 1;
+                }
+                // ! Unused slots repeat the first character so every block is
+                // ! compared against a fixed number of characters
+                for(size_t Iterator = Count; Iterator < MaximumVectorCharacters && Count > 0; Iterator += 1)
+                    Characters[Iterator] = Characters[0];
+            }
+
+            // ! Position of the first character of the set at or after From for which
+            // ! Accept returns true, or npos, every candidate of a block is offered
+            // ! to Accept before the next block is loaded
+            template<typename Predicate>
+            size_t Find(std::string_view Input, size_t From, Predicate &&Accept) const{
+                const char* Data = Input.data();
+                const size_t Size = Input.size();
+                size_t Position = From;
+                if(Count == 0)
+                    return std::string_view::npos;
+                if(Count == 1){
+                    while(Position < Size){
+                        const void* Found = std::memchr(Data + Position, Characters[0], Size - Position);
+                        if(!Found)
+                            return std::string_view::npos;
+                        Position = static_cast<const char*>(Found) - Data;
+                        if(Accept(Position))
+                            return Position;
+                        Position += 1;
+                    }
+                    return std::string_view::npos;
+                }
+                if(Count <= MaximumVectorCharacters){
+#if defined(SYDONIA_SCAN_AVX2)
+                    const __m256i First = _mm256_set1_epi8(Characters[0]), Second = _mm256_set1_epi8(Characters[1]);
+                    const __m256i Third = _mm256_set1_epi8(Characters[2]), Fourth = _mm256_set1_epi8(Characters[3]);
+                    for(; Position + 32 <= Size; Position += 32){
+                        const __m256i Block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Data + Position));
+                        const __m256i Matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(Block, First), _mm256_cmpeq_epi8(Block, Second)),
+                                                                _mm256_or_si256(_mm256_cmpeq_epi8(Block, Third), _mm256_cmpeq_epi8(Block, Fourth)));
+                        for(std::uint32_t Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(Matches)); Mask; Mask &= Mask - 1)
+                            if(Accept(Position + CountTrailingZeros(Mask)))
+                                return Position + CountTrailingZeros(Mask);
+                    }
+#elif defined(SYDONIA_SCAN_SSE2)
+                    const __m128i First = _mm_set1_epi8(Characters[0]), Second = _mm_set1_epi8(Characters[1]);
+                    const __m128i Third = _mm_set1_epi8(Characters[2]), Fourth = _mm_set1_epi8(Characters[3]);
+                    for(; Position + 16 <= Size; Position += 16){
+                        const __m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + Position));
+                        const __m128i Matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, First), _mm_cmpeq_epi8(Block, Second)),
+                                                             _mm_or_si128(_mm_cmpeq_epi8(Block, Third), _mm_cmpeq_epi8(Block, Fourth)));
+                        for(std::uint32_t Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(Matches)); Mask; Mask &= Mask - 1)
+                            if(Accept(Position + CountTrailingZeros(Mask)))
+                                return Position + CountTrailingZeros(Mask);
+                    }
+#endif
+                }
+                for(; Position < Size; Position += 1)
+                    if(Table[static_cast<unsigned char>(Data[Position])] && Accept(Position))
+                        return Position;
+                return std::string_view::npos;
+            }
+
+            // ! Position of the first character of the set at or after From, or npos
+            size_t Find(std::string_view Input, size_t From) const{
+                return Find(Input, From, [](size_t){
+                    return true;
+                });
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_CHARACTER_SCANNER_HXX
\ No newline at end of file
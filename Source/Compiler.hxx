@@ -0,0 +1,374 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_COMPILER_HXX
+#define SYDONIA_COMPILER_HXX
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ConstantFolder.hxx"
+#include "Node.hxx"
+#include "Program.hxx"
+#include "Statistics.hxx"
+#include "Template.hxx"
+
+namespace Sydonia{
+    // ! Class for lowering the AST of a template into a flat program, given a
+    // ! folder it also evaluates what does not depend on the render data, drops
+    // ! the branches of constant conditions and joins the text around them
+    class Compiler : public NodeVisitor{
+        using Operation = FunctionStorage::Operation;
+        using Opcode = Instruction::Opcode;
+
+        // ! Longest text copied out of the template content to join it with more text
+        static constexpr size_t MaximumJoinedText {1024};
+
+        Program ProgramInstance;
+        std::vector<const BlockStatementNode*> PendingBlocks;
+        ConstantFolder* Folder;
+        std::string_view Content;
+        // ! Instruction a jump lands on last, text is not joined across it
+        size_t Label {0};
+        // ! Whether the expression compiled last left a single constant instruction
+        bool IsConstant {false};
+        // ! Names the template binds itself, the loop variables in scope and every
+        // ! Set, they are never read from the invariant data
+        std::vector<std::string_view> LocalNames;
+
+        bool IsLocalName(std::string_view Name) const{
+            return std::find(LocalNames.begin(), LocalNames.end(), Name) != LocalNames.end();
+        }
+
+        size_t Emit(Opcode OpcodeLocal, const AstNode* Node = nullptr, size_t Operand = 0, size_t Length = 0){
+            ProgramInstance.Instructions.emplace_back(OpcodeLocal, Node, Operand, Length);
+            return ProgramInstance.Instructions.size() - 1;
+        }
+
+        void PatchJump(size_t Index){
+            ProgramInstance.Instructions[Index].Operand = ProgramInstance.Instructions.size();
+            Label = ProgramInstance.Instructions.size();
+        }
+
+        void CompileExpressionList(const ExpressionListNode &Node){
+            IsConstant = false;
+            if(Node.Root)
+                Node.Root->Accept(*this);
+        }
+
+        void EmitConstant(JSON &&Value){
+            Emit(Opcode::Constant, nullptr, ProgramInstance.Constants.size());
+            ProgramInstance.Constants.emplace_back(std::move(Value));
+            IsConstant = true;
+        }
+
+        const JSON* ConstantValue(const Instruction &Step) const{
+            switch(Step.OpcodeInstance){
+                case Opcode::Literal:
+                    return &static_cast<const LiteralNode*>(Step.Node)->Value;
+                case Opcode::Constant:
+                    return &ProgramInstance.Constants[Step.Operand];
+                default:
+                    return ProgramInstance.Invariants[Step.Operand];
+            }
+        }
+
+        // ! Removes the last instruction, which pushes a constant
+        void DropConstant(){
+            const Instruction &Step = ProgramInstance.Instructions.back();
+            if(Step.OpcodeInstance == Opcode::Constant && Step.Operand + 1 == ProgramInstance.Constants.size())
+                ProgramInstance.Constants.pop_back();
+            else if(Step.OpcodeInstance == Opcode::Invariant && Step.Operand + 1 == ProgramInstance.Invariants.size())
+                ProgramInstance.Invariants.pop_back();
+            ProgramInstance.Instructions.pop_back();
+        }
+
+        // ! Replaces the constant arguments on top of the program by the result
+        // ! of the function, false when it has to be applied when rendering
+        bool FoldOperation(const FunctionNode &Node){
+            const size_t Count = Node.Arguments.size();
+            Arguments Values(Count);
+            for(size_t Iterator = 0; Iterator < Count; Iterator += 1)
+                Values[Iterator] = ConstantValue(ProgramInstance.Instructions[ProgramInstance.Instructions.size() - Count + Iterator]);
+            JSON Result;
+            if(!Folder->Apply(Node, Values, Result))
+                return false;
+            for(size_t Iterator = 0; Iterator < Count; Iterator += 1)
+                DropConstant();
+            EmitConstant(std::move(Result));
+            return true;
+        }
+
+        // ! The previous instruction when it writes text that more text can be added to
+        Instruction* OpenText(){
+            if(!Folder || ProgramInstance.Instructions.size() <= Label)
+                return nullptr;
+            Instruction &Last = ProgramInstance.Instructions.back();
+            if(Last.OpcodeInstance != Opcode::Text && Last.OpcodeInstance != Opcode::ConstantText)
+                return nullptr;
+            return &Last;
+        }
+
+        // ! Appends Text to the previous text instruction, which is moved out of
+        // ! the template content first, false when they are better kept apart
+        bool JoinText(std::string_view Text){
+            Instruction* Last = OpenText();
+            if(!Last || Last->Length + Text.size() > MaximumJoinedText)
+                return false;
+            if(Last->OpcodeInstance == Opcode::Text){
+                Last->OpcodeInstance = Opcode::ConstantText;
+                const size_t Position = Last->Operand;
+                Last->Operand = ProgramInstance.Text.size();
+                ProgramInstance.Text.append(Content.substr(Position, Last->Length));
+            }
+            ProgramInstance.Text.append(Text);
+            Last->Length += Text.size();
+            return true;
+        }
+
+        // ! Compiles a branch that is never taken and throws the code away, the
+        // ! blocks in it are kept since a child template may still render them
+        void DropBranch(const BlockNode &Branch){
+            const size_t Instructions = ProgramInstance.Instructions.size(), Constants = ProgramInstance.Constants.size();
+            const size_t Invariants = ProgramInstance.Invariants.size(), Text = ProgramInstance.Text.size();
+            const size_t PreviousLabel = Label;
+            Label = Instructions;
+            Branch.Accept(*this);
+            ProgramInstance.Instructions.erase(ProgramInstance.Instructions.begin() + Instructions, ProgramInstance.Instructions.end());
+            ProgramInstance.Constants.resize(Constants);
+            ProgramInstance.Invariants.resize(Invariants);
+            ProgramInstance.Text.resize(Text);
+            Label = PreviousLabel;
+        }
+
+        void EmitConstantText(std::string_view Text){
+            if(Text.empty() || JoinText(Text))
+                return;
+            Emit(Opcode::ConstantText, nullptr, ProgramInstance.Text.size(), Text.size());
+            ProgramInstance.Text.append(Text);
+        }
+
+        void Visit(const BlockNode &Node){
+            for(auto &SubNode : Node.Nodes)
+                SubNode->Accept(*this);
+        }
+
+        void Visit(const TextNode &Node){
+            Instruction* Last = OpenText();
+            if(Last && Last->OpcodeInstance == Opcode::Text && Last->Operand + Last->Length == Node.Position){
+                Last->Length += Node.Length;
+                return;
+            }
+            if(!JoinText(Content.substr(Node.Position, Node.Length)))
+                Emit(Opcode::Text, &Node, Node.Position, Node.Length);
+        }
+
+        void Visit(const ExpressionNode&){}
+
+        void Visit(const LiteralNode &Node){
+            Emit(Opcode::Literal, &Node);
+            IsConstant = Folder;
+        }
+
+        void Visit(const DataNode &Node){
+            const bool CanFold = Folder && Node.LoopAccessInstance.MemberInstance == DataNode::LoopAccess::Member::None && !IsLocalName(Node.Head());
+            const JSON* Value = CanFold ? Folder->FindInvariant(Node) : nullptr;
+            if(Value){
+                Emit(Opcode::Invariant, &Node, ProgramInstance.Invariants.size());
+                ProgramInstance.Invariants.emplace_back(Value);
+                auto &Heads = ProgramInstance.InvariantHeads;
+                if(std::find(Heads.begin(), Heads.end(), Node.Head()) == Heads.end())
+                    Heads.emplace_back(Node.Head());
+            }else
+                Emit(Opcode::Data, &Node);
+            IsConstant = Value;
+        }
+
+        void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    if(!Node.Arguments.empty())
+                        Node.Arguments[0]->Accept(*this);
+                    Emit(Opcode::AtId, &Node);
+                    IsConstant = false;
+                } break;
+                case Operation::Default: {
+                    // ! The fallback is only evaluated when the first argument is missing
+                    Node.Arguments[0]->Accept(*this);
+                    if(IsConstant)
+                        break;
+                    const size_t Jump = Emit(Opcode::JumpIfDefined, &Node);
+                    Node.Arguments[1]->Accept(*this);
+                    PatchJump(Jump);
+                    IsConstant = false;
+                } break;
+                case Operation::And:
+                case Operation::Or: {
+                    // ! The second argument is only evaluated when the first one does not decide
+                    Node.Arguments[0]->Accept(*this);
+                    if(IsConstant){
+                        const bool First = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                        DropConstant();
+                        if(First == (Node.OperationInstance == Operation::Or)){
+                            EmitConstant(First);
+                            break;
+                        }
+                        Node.Arguments[1]->Accept(*this);
+                        if(IsConstant){
+                            const bool Second = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                            DropConstant();
+                            EmitConstant(Second);
+                            break;
+                        }
+                        Emit(Opcode::Truthy, &Node);
+                        break;
+                    }
+                    const size_t Jump = Emit(Opcode::JumpIfDecided, &Node);
+                    Node.Arguments[1]->Accept(*this);
+                    Emit(Opcode::Truthy, &Node);
+                    PatchJump(Jump);
+                    IsConstant = false;
+                } break;
+                default: {
+                    // ! A lazy callback evaluates its arguments itself
+                    if(Node.OperationInstance == Operation::Callback && Node.Callback->LazyFunction){
+                        Emit(Opcode::Operation, &Node);
+                        IsConstant = false;
+                        break;
+                    }
+                    bool Constant = Folder;
+                    for(auto &Argument : Node.Arguments){
+                        Argument->Accept(*this);
+                        Constant = Constant && IsConstant;
+                    }
+                    if(Constant && FoldOperation(Node))
+                        break;
+                    Emit(Opcode::Operation, &Node);
+                    IsConstant = false;
+                }
+            }
+        }
+
+        void Visit(const ExpressionListNode &Node){
+            CompileExpressionList(Node);
+            if(IsConstant){
+                std::string Text;
+                Folder->Print(*ConstantValue(ProgramInstance.Instructions.back()), Text);
+                DropConstant();
+                EmitConstantText(Text);
+                return;
+            }
+            Emit(Opcode::Print, &Node);
+        }
+
+        void Visit(const StatementNode&){}
+        void Visit(const ForStatementNode&){}
+
+        void Visit(const ForArrayStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            const size_t Exit = Emit(Opcode::ForArray, &Node);
+            LocalNames.emplace_back(Node.Value);
+            Node.Body.Accept(*this);
+            LocalNames.pop_back();
+            Emit(Opcode::Next, &Node, Exit + 1);
+            PatchJump(Exit);
+        }
+
+        void Visit(const ForObjectStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            const size_t Exit = Emit(Opcode::ForObject, &Node);
+            LocalNames.emplace_back(Node.Key);
+            LocalNames.emplace_back(Node.Value);
+            Node.Body.Accept(*this);
+            LocalNames.resize(LocalNames.size() - 2);
+            Emit(Opcode::Next, &Node, Exit + 1);
+            PatchJump(Exit);
+        }
+
+        void Visit(const IfStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            if(IsConstant){
+                // ! Only the branch taken is compiled
+                const bool Taken = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                DropConstant();
+                if(Taken){
+                    Node.TrueStatement.Accept(*this);
+                    DropBranch(Node.FalseStatement);
+                }else{
+                    DropBranch(Node.TrueStatement);
+                    Node.FalseStatement.Accept(*this);
+                }
+                return;
+            }
+            const size_t FalseJump = Emit(Opcode::JumpIfFalse, &Node.Condition);
+            Node.TrueStatement.Accept(*this);
+            if(Node.HasFalseStatement){
+                const size_t EndJump = Emit(Opcode::Jump, &Node);
+                PatchJump(FalseJump);
+                Node.FalseStatement.Accept(*this);
+                PatchJump(EndJump);
+            }else
+                PatchJump(FalseJump);
+        }
+
+        void Visit(const IncludeStatementNode &Node){
+            Emit(Opcode::Include, &Node);
+        }
+
+        void Visit(const ExtendsStatementNode &Node){
+            Emit(Opcode::Extends, &Node);
+        }
+
+        void Visit(const BlockStatementNode &Node){
+            // ! Block bodies are placed out of line, the renderer decides which
+            // ! template in the inheritance chain provides the body to run
+            Emit(Opcode::Block, &Node);
+            PendingBlocks.emplace_back(&Node);
+        }
+
+        void Visit(const SetStatementNode &Node){
+            CompileExpressionList(Node.Expression);
+            Emit(Opcode::Set, &Node);
+        }
+
+        public:
+            explicit Compiler(ConstantFolder* FolderLocal = nullptr): Folder(FolderLocal){}
+
+            Program Compile(const Template &TemplateLocal){
+                ProgramInstance = Program();
+                PendingBlocks.clear();
+                Content = TemplateLocal.Content;
+                Label = 0;
+                LocalNames.clear();
+                if(Folder && Folder->HasInvariantData()){
+                    StatisticsVisitor Statistics;
+                    TemplateLocal.Root.Accept(Statistics);
+                    LocalNames = std::move(Statistics.AssignedNames);
+                }
+                TemplateLocal.Root.Accept(*this);
+                Emit(Opcode::Return);
+                for(size_t Iterator = 0; Iterator < PendingBlocks.size(); Iterator += 1){
+                    const auto Block = PendingBlocks[Iterator];
+                    Label = ProgramInstance.Instructions.size();
+                    ProgramInstance.Blocks.emplace(Block->Name, Label);
+                    Block->Block.Accept(*this);
+                    Emit(Opcode::Return);
+                }
+                return std::move(ProgramInstance);
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_COMPILER_HXX
\ No newline at end of file
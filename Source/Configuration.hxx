@@ -14,8 +14,10 @@
 #define SYDONIA_CONFIGURATION_HXX
 
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "OpenerMatcher.hxx"
 #include "Template.hxx"
 
 namespace Sydonia{
@@ -36,10 +38,16 @@ namespace Sydonia{
         std::string CommentClose {"#}"};
         std::string CommentCloseForceRstrip {"-#}"};
         std::string OpenCharacters {"#{"};
+        OpenerMatcher OpenerMatcherInstance;
 
         bool TrimBlocks {false};
         bool LstripBlocks {false};
 
+        LexerConfiguration(){
+            UpdateOpenCharacters();
+        }
+
+        // ! Rebuilds the first characters and the matcher of the opening sequences
         void UpdateOpenCharacters(){
             OpenCharacters = "";
             if(OpenCharacters.find(LineStatement[0]) == std::string::npos)
@@ -58,18 +66,37 @@ namespace Sydonia{
                 OpenCharacters += CommentOpen[0];
             if(OpenCharacters.find(CommentOpenForceLstrip[0]) == std::string::npos)
                 OpenCharacters += CommentOpenForceLstrip[0];
+
+            OpenerMatcherInstance.Clear();
+            OpenerMatcherInstance.Add(ExpressionOpen, Opener::Expression);
+            OpenerMatcherInstance.Add(ExpressionOpenForceLstrip, Opener::ExpressionForceLstrip);
+            OpenerMatcherInstance.Add(StatementOpen, Opener::Statement);
+            OpenerMatcherInstance.Add(StatementOpenNoLstrip, Opener::StatementNoLstrip);
+            OpenerMatcherInstance.Add(StatementOpenForceLstrip, Opener::StatementForceLstrip);
+            OpenerMatcherInstance.Add(CommentOpen, Opener::Comment);
+            OpenerMatcherInstance.Add(CommentOpenForceLstrip, Opener::CommentForceLstrip);
+            OpenerMatcherInstance.Add(LineStatement, Opener::LineStatement);
         }
     };
 
     // ! Struct for parser configuration
     struct ParserConfiguration{
         bool SearchIncludedTemplatesInFiles {true};
+        // ! Map template files instead of copying them into memory, a mapped file
+        // ! must not be truncated or rewritten in place while it is loaded
+        bool MapTemplateFiles {false};
+        // ! Evaluate what does not depend on the render data when compiling
+        bool FoldConstants {true};
+        // ! Values that are the same for every render, given by their top level key
+        std::shared_ptr<const JSON> InvariantData;
         std::function<Template(const std::string &, const std::string &)> IncludeCallback;
     };
 
     // ! Struct for render configuration
     struct RenderConfiguration{
         bool ThrowAtMissingIncludes {true};
+        // ! Run the compiled program of a template instead of walking its AST
+        bool UseCompiledProgram {true};
     };
 }; // ! Sydonia namespace
 
@@ -0,0 +1,185 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_CONSTANT_FOLDER_HXX
+#define SYDONIA_CONSTANT_FOLDER_HXX
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "Configuration.hxx"
+#include "FunctionStorage.hxx"
+#include "Node.hxx"
+#include "OutputSink.hxx"
+#include "Renderer.hxx"
+
+namespace Sydonia{
+    // ! Evaluates the parts of a template that do not depend on the render data,
+    // ! builtins are applied by a renderer so the result is the one a render
+    // ! would give, only calls that can not fail are folded since an error has
+    // ! to be reported when (and if) the expression is rendered
+    class ConstantFolder{
+        using Operation = FunctionStorage::Operation;
+
+        // ! Range() results longer than this are left to the render
+        static constexpr int MaximumRangeLength {65536};
+
+        const TemplateLookup TemplateStorageInstance;
+        const FunctionStorage &FunctionStorageInstance;
+        std::shared_ptr<const JSON> InvariantData;
+        // ! Built the first time something is folded
+        std::optional<Renderer> Evaluator;
+
+        Renderer &GetEvaluator(){
+            if(!Evaluator)
+                Evaluator.emplace(RenderConfiguration(), TemplateStorageInstance, FunctionStorageInstance);
+            return *Evaluator;
+        }
+
+        // ! A number the renderer may read with get<int>() without leaving the int range
+        static bool IsIntLike(const JSON* Value){
+            if(!Value->is_number())
+                return false;
+            if(!Value->is_number_float())
+                return true;
+            const double Number = Value->get<double>();
+            return Number > std::numeric_limits<int>::min() && Number < std::numeric_limits<int>::max();
+        }
+
+        static bool FitsInt(double Number){
+            return Number >= std::numeric_limits<int>::min() && Number <= std::numeric_limits<int>::max();
+        }
+
+        static bool IsRemainderDefined(const JSON* Dividend, const JSON* Divisor){
+            if(!IsIntLike(Dividend) || !IsIntLike(Divisor))
+                return false;
+            const int Value = Divisor->get<int>();
+            return Value != 0 && !(Value == -1 && Dividend->get<int>() == std::numeric_limits<int>::min());
+        }
+
+        // ! Whether the renderer gives the same value for these arguments on every
+        // ! render without throwing
+        static bool CanApply(const FunctionNode &Node, const Arguments &Values){
+            const auto Count = [&](size_t Expected){
+                return Values.size() == Expected;
+            };
+            switch(Node.OperationInstance){
+                case Operation::Not:
+                case Operation::Length:
+                case Operation::IsArray:
+                case Operation::IsBoolean:
+                case Operation::IsFloat:
+                case Operation::IsInteger:
+                case Operation::IsNumber:
+                case Operation::IsObject:
+                case Operation::IsString:
+                    return Count(1);
+                case Operation::And:
+                case Operation::Or:
+                case Operation::In:
+                case Operation::Equal:
+                case Operation::NotEqual:
+                case Operation::Greater:
+                case Operation::GreaterEqual:
+                case Operation::Less:
+                case Operation::LessEqual:
+                    return Count(2);
+                case Operation::Add:
+                    if(!Count(2))
+                        return false;
+                    return (Values[0]->is_string() && Values[1]->is_string()) || (Values[0]->is_number() && Values[1]->is_number());
+                // ! Integers that overflow become floats, these can not fail on numbers
+                case Operation::Subtract:
+                case Operation::Multiplication:
+                case Operation::Power:
+                    return Count(2) && Values[0]->is_number() && Values[1]->is_number();
+                case Operation::Division:
+                case Operation::Modulo:
+                    return Count(2) && Values[0]->is_number() && Values[1]->is_number() && Values[1]->get<double>() != 0;
+                case Operation::DivisibleBy:
+                    return Count(2) && IsIntLike(Values[0]) && IsIntLike(Values[1]) && (Values[1]->get<int>() == 0 || IsRemainderDefined(Values[0], Values[1]));
+                case Operation::Even:
+                case Operation::Odd:
+                    return Count(1) && IsIntLike(Values[0]);
+                case Operation::At: {
+                    if(!Count(2))
+                        return false;
+                    if(Values[0]->is_object())
+                        return Values[1]->is_string() && Values[0]->contains(Values[1]->get_ref<const std::string&>());
+                    return Values[0]->is_array() && IsIntLike(Values[1]) && Values[1]->get<int>() >= 0 &&
+                        static_cast<size_t>(Values[1]->get<int>()) < Values[0]->size();
+                }
+                case Operation::ExistsInObject:
+                    return Count(2) && Values[1]->is_string();
+                case Operation::First:
+                case Operation::Last:
+                case Operation::Max:
+                case Operation::Min:
+                    return Count(1) && !Values[0]->empty();
+                case Operation::Lower:
+                case Operation::Upper:
+                    return Count(1) && Values[0]->is_string();
+                case Operation::Range:
+                    return Count(1) && IsIntLike(Values[0]) && Values[0]->get<int>() >= 0 && Values[0]->get<int>() <= MaximumRangeLength;
+                case Operation::Round: {
+                    if(!Count(2) || !Values[0]->is_number() || !IsIntLike(Values[1]))
+                        return false;
+                    return Values[1]->get<int>() != 0 || FitsInt(std::round(Values[0]->get<double>()));
+                }
+                case Operation::Sort:
+                    return Count(1) && Values[0]->is_array();
+                case Operation::Join:
+                    return Count(2) && Values[1]->is_string();
+                // ! Exists looks at the render data, Float and Int leave parse errors
+                // ! to the render, callbacks and Super() may have side effects
+                default:
+                    return false;
+            }
+        }
+
+        public:
+            explicit ConstantFolder(const TemplateLookup &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal, std::shared_ptr<const JSON> InvariantDataLocal)
+                : TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal), InvariantData(std::move(InvariantDataLocal)){}
+
+            // ! Applies a builtin to constant arguments, false when it has to wait for the render
+            bool Apply(const FunctionNode &Node, const Arguments &Values, JSON &Result){
+                if(!CanApply(Node, Values))
+                    return false;
+                Result = GetEvaluator().Apply(Node, Values);
+                return true;
+            }
+
+            bool HasInvariantData() const{
+                return InvariantData != nullptr;
+            }
+
+            // ! Value of a variable whose head was declared render invariant
+            const JSON* FindInvariant(const DataNode &Node) const{
+                return InvariantData ? Node.Find(*InvariantData) : nullptr;
+            }
+
+            bool Truthy(const JSON &Value) const{
+                return Renderer::Truthy(&Value);
+            }
+
+            // ! Appends the text a render would print for Value
+            void Print(const JSON &Value, std::string &Output){
+                OutputSink Sink(Output);
+                GetEvaluator().PrintTo(Sink, Value);
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_CONSTANT_FOLDER_HXX
\ No newline at end of file
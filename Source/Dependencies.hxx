@@ -0,0 +1,329 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_DEPENDENCIES_HXX
+#define SYDONIA_DEPENDENCIES_HXX
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Node.hxx"
+#include "Template.hxx"
+
+namespace Sydonia{
+    // ! Collects the paths of the render data a template may read, following its
+    // ! includes, the templates it extends and the blocks they override. A path
+    // ! is dotted, '*' standing for every element of an array or object, and the
+    // ! whole value below it may be read. Loop variables and Set targets are
+    // ! resolved to what they were taken from, the result is a superset of what a
+    // ! render reads since every branch is assumed to be taken
+    class DependencyVisitor : public NodeVisitor{
+        using Operation = FunctionStorage::Operation;
+
+        // ! Set targets are resolved again until they stop changing, chains longer
+        // ! than this are cut short
+        static constexpr size_t MaximumPasses {8};
+
+        // ! A loop variable and the paths its values come from
+        struct Scope{
+            std::string_view Name;
+            std::vector<std::string> Sources;
+            bool Used;
+        };
+
+        const TemplateLookup TemplateStorageInstance;
+        std::vector<Scope> Scopes;
+        size_t LoopDepth {0};
+        // ! What each Set target may hold, gathered over the whole analysis
+        std::map<std::string, std::set<std::string>> Assignments;
+        bool AssignmentsChanged {false};
+        // ! Templates of the inheritance chain, the most derived one first
+        std::vector<const Template*> Chain;
+        // ! Templates and blocks being walked, so recursive ones are walked once
+        std::vector<const void*> Active;
+        const Template* CurrentTemplate {nullptr};
+        // ! Paths the value of the expression visited last comes from
+        std::vector<std::string> Sources;
+        std::set<std::string> Paths;
+
+        static std::string Join(const std::string &Path, std::string_view Tail){
+            if(Tail.empty())
+                return Path;
+            std::string Result = Path;
+            Result += '.';
+            Result.append(Tail.data(), Tail.size());
+            return Result;
+        }
+
+        // ! Whether Prefix is Path or one of its parents
+        static bool IsPrefix(std::string_view Prefix, std::string_view Path){
+            return Path.size() >= Prefix.size() && Path.compare(0, Prefix.size(), Prefix) == 0 &&
+                (Path.size() == Prefix.size() || Path[Prefix.size()] == '.');
+        }
+
+        bool IsActive(const void* Item) const{
+            return std::find(Active.begin(), Active.end(), Item) != Active.end();
+        }
+
+        // ! The value of the last expression is read as a whole
+        void Use(){
+            Paths.insert(Sources.begin(), Sources.end());
+            Sources.clear();
+        }
+
+        void Evaluate(const ExpressionListNode &Node){
+            Sources.clear();
+            if(Node.Root)
+                Node.Root->Accept(*this);
+        }
+
+        void WalkTemplate(const Template &TemplateLocal){
+            if(IsActive(&TemplateLocal))
+                return;
+            const Template* Previous = CurrentTemplate;
+            CurrentTemplate = &TemplateLocal;
+            Active.emplace_back(&TemplateLocal);
+            TemplateLocal.Root.Accept(*this);
+            Active.pop_back();
+            CurrentTemplate = Previous;
+        }
+
+        const Template* FindTemplate(const std::string &File) const{
+            return TemplateStorageInstance.Find(File);
+        }
+
+        void Visit(const BlockNode &Node){
+            for(auto &SubNode : Node.Nodes)
+                SubNode->Accept(*this);
+        }
+
+        void Visit(const TextNode&){}
+        void Visit(const ExpressionNode&){}
+
+        void Visit(const LiteralNode&){
+            Sources.clear();
+        }
+
+        void Visit(const DataNode &Node){
+            Sources.clear();
+            // ! Loop.* is answered by the running loops
+            if(Node.LoopAccessInstance.MemberInstance != DataNode::LoopAccess::Member::None && Node.LoopAccessInstance.Depth < LoopDepth)
+                return;
+            std::string Tail;
+            for(size_t Iterator = 1; Iterator < Node.Path.size(); Iterator += 1){
+                if(Iterator > 1)
+                    Tail += '.';
+                Tail += Node.Path[Iterator].Key;
+            }
+            for(auto Iterator = Scopes.rbegin(); Iterator != Scopes.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head())
+                    continue;
+                Iterator->Used = true;
+                for(const auto &Source : Iterator->Sources)
+                    Sources.emplace_back(Join(Source, Tail));
+                return;
+            }
+            const std::string Path = Join(Node.Head(), Tail);
+            // ! Render invariant values stand in for the render data, not for a Set
+            if(!CurrentTemplate->InvariantData || !Node.Find(*CurrentTemplate->InvariantData))
+                Sources.emplace_back(Path);
+            for(const auto &Assignment : Assignments){
+                if(IsPrefix(Assignment.first, Path)){
+                    const std::string_view Rest = std::string_view(Path).substr(std::min(Path.size(), Assignment.first.size() + 1));
+                    for(const auto &Source : Assignment.second)
+                        Sources.emplace_back(Join(Source, Rest));
+                }else if(IsPrefix(Path, Assignment.first))
+                    Sources.insert(Sources.end(), Assignment.second.begin(), Assignment.second.end());
+            }
+        }
+
+        void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    Node.Arguments[0]->Accept(*this);
+                    const auto Member = dynamic_cast<const DataNode*>(Node.Arguments[1]);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, Member ? std::string_view(Member->Name) : "*");
+                } break;
+                case Operation::Default: {
+                    Node.Arguments[0]->Accept(*this);
+                    std::vector<std::string> First;
+                    First.swap(Sources);
+                    Node.Arguments[1]->Accept(*this);
+                    Sources.insert(Sources.end(), First.begin(), First.end());
+                } break;
+                case Operation::At: {
+                    Node.Arguments[1]->Accept(*this);
+                    Use();
+                    const auto Key = dynamic_cast<const LiteralNode*>(Node.Arguments[1]);
+                    std::string Member = "*";
+                    if(Key && Key->Value.is_string())
+                        Member = Key->Value.get<std::string>();
+                    else if(Key && Key->Value.is_number_unsigned())
+                        Member = std::to_string(Key->Value.get<size_t>());
+                    Node.Arguments[0]->Accept(*this);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, Member);
+                } break;
+                case Operation::First:
+                case Operation::Last: {
+                    Node.Arguments[0]->Accept(*this);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, "*");
+                } break;
+                case Operation::Exists: {
+                    // ! The name is looked up in the render data when it is known
+                    const auto Name = dynamic_cast<const LiteralNode*>(Node.Arguments[0]);
+                    if(Name && Name->Value.is_string()){
+                        Paths.insert(Name->Value.get<std::string>());
+                        Sources.clear();
+                    }else{
+                        Node.Arguments[0]->Accept(*this);
+                        Use();
+                    }
+                } break;
+                default: {
+                    for(auto &Argument : Node.Arguments){
+                        Argument->Accept(*this);
+                        Use();
+                    }
+                }
+            }
+        }
+
+        void Visit(const ExpressionListNode &Node){
+            Evaluate(Node);
+            Use();
+        }
+
+        void Visit(const StatementNode&){}
+        void Visit(const ForStatementNode&){}
+
+        // ! Walks a loop body with its variables bound, the container is read as a
+        // ! whole when the body never looks into its values
+        void WalkLoop(const ExpressionListNode &Condition, const BlockNode &Body, std::string_view Key, std::string_view Value){
+            Evaluate(Condition);
+            std::vector<std::string> Container;
+            Container.swap(Sources);
+            std::vector<std::string> Items;
+            for(const auto &Source : Container)
+                Items.emplace_back(Join(Source, "*"));
+            const size_t Base = Scopes.size();
+            if(!Key.empty())
+                Scopes.push_back(Scope {Key, {}, false});
+            Scopes.push_back(Scope {Value, std::move(Items), false});
+            LoopDepth += 1;
+            Body.Accept(*this);
+            LoopDepth -= 1;
+            const bool Used = Scopes.back().Used;
+            Scopes.resize(Base);
+            if(!Used)
+                Paths.insert(Container.begin(), Container.end());
+        }
+
+        void Visit(const ForArrayStatementNode &Node){
+            WalkLoop(Node.Condition, Node.Body, std::string_view(), Node.Value);
+        }
+
+        void Visit(const ForObjectStatementNode &Node){
+            WalkLoop(Node.Condition, Node.Body, Node.Key, Node.Value);
+        }
+
+        void Visit(const IfStatementNode &Node){
+            Node.Condition.Accept(*this);
+            Node.TrueStatement.Accept(*this);
+            Node.FalseStatement.Accept(*this);
+        }
+
+        void Visit(const IncludeStatementNode &Node){
+            const auto Included = FindTemplate(Node.File);
+            if(!Included)
+                return;
+            // ! An included template renders its own blocks
+            auto Previous = std::move(Chain);
+            Chain = {Included};
+            WalkTemplate(*Included);
+            Chain = std::move(Previous);
+        }
+
+        void Visit(const ExtendsStatementNode &Node){
+            const auto Parent = FindTemplate(Node.File);
+            if(!Parent || IsActive(Parent))
+                return;
+            Chain.emplace_back(Parent);
+            WalkTemplate(*Parent);
+            Chain.pop_back();
+        }
+
+        void Visit(const BlockStatementNode &Node){
+            // ! Any template of the chain may provide the body, through Super() too
+            for(size_t Iterator = 0; Iterator < Chain.size(); Iterator += 1){
+                const auto Found = Chain[Iterator]->BlockStorage.find(Node.Name);
+                if(Found == Chain[Iterator]->BlockStorage.end() || IsActive(Found->second))
+                    continue;
+                const Template* Previous = CurrentTemplate;
+                CurrentTemplate = Chain[Iterator];
+                Active.emplace_back(Found->second);
+                Found->second->Block.Accept(*this);
+                Active.pop_back();
+                CurrentTemplate = Previous;
+            }
+        }
+
+        void Visit(const SetStatementNode &Node){
+            Evaluate(Node.Expression);
+            for(auto &Scope : Scopes){
+                if(Scope.Name != Node.Head)
+                    continue;
+                // ! Assigning into a loop variable, what is kept in it is read right away
+                Use();
+                return;
+            }
+            auto &Targets = Assignments[Node.Key];
+            for(const auto &Source : Sources)
+                AssignmentsChanged |= Targets.insert(Source).second;
+            Sources.clear();
+        }
+
+        public:
+            explicit DependencyVisitor(const TemplateLookup &TemplateStorageLocal): TemplateStorageInstance(TemplateStorageLocal){}
+
+            // ! Paths of the render data the template may read, a path is left out
+            // ! when one of its parents is in the result
+            std::set<std::string> Collect(const Template &TemplateLocal){
+                Assignments.clear();
+                for(size_t Pass = 0; Pass < MaximumPasses; Pass += 1){
+                    Paths.clear();
+                    AssignmentsChanged = false;
+                    Chain = {&TemplateLocal};
+                    WalkTemplate(TemplateLocal);
+                    if(!AssignmentsChanged)
+                        break;
+                }
+                std::set<std::string> Result;
+                for(const auto &Path : Paths){
+                    bool Covered = false;
+                    for(size_t Separator = Path.find('.'); !Covered && Separator != std::string::npos; Separator = Path.find('.', Separator + 1))
+                        Covered = Paths.count(Path.substr(0, Separator)) != 0;
+                    if(!Covered)
+                        Result.insert(Result.end(), Path);
+                }
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_DEPENDENCIES_HXX
\ No newline at end of file
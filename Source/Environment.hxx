@@ -13,22 +13,35 @@
 #ifndef SYDONIA_ENVIRONMENT_HXX
 #define SYDONIA_ENVIRONMENT_HXX
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
 
 #include "Configuration.hxx"
+#include "Dependencies.hxx"
 #include "FunctionStorage.hxx"
 #include "Parser.hxx"
 #include "Renderer.hxx"
 #include "Template.hxx"
+#include "TemplateCache.hxx"
+#include "TemplateStream.hxx"
 #include "Utilities.hxx"
 
 namespace Sydonia{
     // ! Class for changing the configuration
+    // !
+    // ! Once Freeze() has been called the configuration and the callbacks can no
+    // ! longer change, the environment can then parse and render from any number
+    // ! of threads at once (callbacks must be safe to call concurrently). The
+    // ! included templates are kept in an immutable snapshot, each render takes
+    // ! the current one and IncludeTemplate or a parse that discovers new
+    // ! includes publishes a new snapshot, renders already running keep theirs
     class Environment{
         std::string OutputPath;
         std::string InputPath;
@@ -37,8 +50,68 @@ namespace Sydonia{
         ParserConfiguration ParserConfigurationInstance;
         RenderConfiguration RenderConfigurationInstance;
 
+        // ! Lock of the template storage writers and the frozen flag, a copy of the
+        // ! environment gets its own lock and keeps whether it is frozen
+        struct Synchronization{
+            std::mutex TemplateStorageMutex;
+            std::atomic<bool> Frozen {false};
+
+            Synchronization() = default;
+
+            Synchronization(const Synchronization &Other): Frozen(Other.Frozen.load(std::memory_order_acquire)){}
+
+            Synchronization &operator=(const Synchronization &Other){
+                Frozen.store(Other.Frozen.load(std::memory_order_acquire), std::memory_order_release);
+                return *this;
+            }
+        };
+
         FunctionStorage FunctionStorageInstance;
-        TemplateStorage TemplateStorageInstance;
+        std::shared_ptr<const TemplateSnapshot> TemplateStorageInstance {std::make_shared<const TemplateSnapshot>()};
+        TemplateCache TemplateCacheInstance;
+        Synchronization SynchronizationInstance;
+
+        void ThrowIfFrozen() const{
+            if(IsFrozen())
+                SYDONIA_THROW(EnvironmentError("The environment is frozen and can not be modified"));
+        }
+
+        std::shared_ptr<const TemplateSnapshot> GetTemplateStorage() const{
+            return std::atomic_load(&TemplateStorageInstance);
+        }
+
+        // ! Publishes a snapshot with Added on top of the current one, an include a
+        // ! parse discovered never replaces a template published meanwhile
+        void PublishTemplates(TemplateStorage Added, bool Replace){
+            std::lock_guard<std::mutex> Lock(SynchronizationInstance.TemplateStorageMutex);
+            auto Current = GetTemplateStorage();
+            if(!Replace){
+                for(auto Iterator = Added.begin(); Iterator != Added.end();)
+                    Iterator = Current->Find(Iterator->first) ? Added.erase(Iterator) : std::next(Iterator);
+            }
+            std::atomic_store(&TemplateStorageInstance, TemplateSnapshot::Add(std::move(Current), std::move(Added)));
+        }
+
+        // ! Runs a parser that reads the current snapshot, the templates it discovered
+        // ! are published afterwards
+        template<typename ParseFunction>
+        Template ParseWithStorage(const ParserConfiguration &Configuration, ParseFunction &&Parse){
+            const auto Shared = GetTemplateStorage();
+            TemplateStorage Discovered;
+            Parser ParserLocal(Configuration, LexerConfigurationInstance, Discovered, FunctionStorageInstance, Shared.get());
+            Template Result = Parse(ParserLocal);
+            if(!Discovered.empty())
+                PublishTemplates(std::move(Discovered), false);
+            return Result;
+        }
+
+        Template ParseTemplate(const std::string &Filename, const ParserConfiguration &Configuration){
+            return ParseWithStorage(Configuration, [&](Parser &ParserLocal){
+                auto Result = Template(ParserLocal.LoadSource(InputPath + static_cast<std::string>(Filename)));
+                ParserLocal.ParseIntoTemplate(Result, InputPath + static_cast<std::string>(Filename));
+                return Result;
+            });
+        }
 
         public:
             Environment(): Environment(""){}
@@ -49,86 +122,195 @@ namespace Sydonia{
 
             // ! Sets the opener and closer for template statements
             void SetStatement(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.StatementOpen = Open;
                 LexerConfigurationInstance.StatementOpenNoLstrip = Open + "+";
                 LexerConfigurationInstance.StatementOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.StatementClose = Close;
                 LexerConfigurationInstance.StatementCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener for template line statement
             void SetLineStatement(const std::string &Open){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.LineStatement = Open;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener and closer for template expressions
             void SetExpression(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.ExpressionOpen = Open;
                 LexerConfigurationInstance.ExpressionOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.ExpressionClose = Close;
                 LexerConfigurationInstance.ExpressionCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener and closer for template comments
             void SetComment(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.CommentOpen = Open;
                 LexerConfigurationInstance.CommentOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.CommentClose = Close;
                 LexerConfigurationInstance.CommentCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether to remove the first newline after a block
             void SetTrimBlocks(bool TrimBlocks){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.TrimBlocks = TrimBlocks;
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether to strip the spaces and tabs from the start of a line to a block
             void SetLstripBlocks(bool LstripBlocks){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.LstripBlocks = LstripBlocks;
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the element notation syntax
             void SetSearchIncludedTemplatesInFiles(bool SearchInFiles){
+                ThrowIfFrozen();
                 ParserConfigurationInstance.SearchIncludedTemplatesInFiles = SearchInFiles;
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Sets whether template files are mapped into memory instead of copied,
+            // ! a mapped file must be replaced (not rewritten in place) while in use,
+            // ! files loaded through LoadTemplate are copied regardless
+            void SetMapTemplateFiles(bool MapTemplateFiles){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.MapTemplateFiles = MapTemplateFiles;
+            }
+
+            // ! Sets whether the parts of a template that do not depend on the render
+            // ! data are evaluated once when it is parsed
+            void SetFoldConstants(bool FoldConstants){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.FoldConstants = FoldConstants;
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Declares the top level keys of Data render invariant, templates parsed
+            // ! afterwards read them from Data and evaluate what depends on them once,
+            // ! they stand in for the render data, loop variables and Set win over them
+            void SetInvariantData(const JSON &Data){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.InvariantData = std::make_shared<const JSON>(Data);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether a missing include will throw an error
             void SetThrowAtMissingIncludes(bool WillThrow){
+                ThrowIfFrozen();
                 RenderConfigurationInstance.ThrowAtMissingIncludes = WillThrow;
             }
 
+            // ! Sets whether templates are rendered from their compiled program, when
+            // ! disabled the AST is walked instead, which is useful as a reference
+            void SetUseCompiledProgram(bool UseCompiledProgram){
+                ThrowIfFrozen();
+                RenderConfigurationInstance.UseCompiledProgram = UseCompiledProgram;
+            }
+
+            // ! Forbids any further change to the configuration and the callbacks,
+            // ! see the class comment for what may be used concurrently afterwards
+            void Freeze(){
+                SynchronizationInstance.Frozen.store(true, std::memory_order_release);
+            }
+
+            bool IsFrozen() const{
+                return SynchronizationInstance.Frozen.load(std::memory_order_acquire);
+            }
+
             Template Parse(std::string_view Input){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-                return ParserLocal.Parse(Input);
+                return ParseWithStorage(ParserConfigurationInstance, [&](Parser &ParserLocal){
+                    return ParserLocal.Parse(Input);
+                });
+            }
+
+            // ! Applies Edit to a template parsed from a string, only the part of the
+            // ! template around the edit is parsed again, the template is left as it
+            // ! was when the edited content fails to parse
+            void Reparse(Template &TemplateLocal, const TemplateEdit &Edit){
+                TemplateLocal = ParseWithStorage(ParserConfigurationInstance, [&](Parser &ParserLocal){
+                    return ParserLocal.Reparse(TemplateLocal, Edit);
+                });
             }
 
             Template ParseTemplate(const std::string &Filename){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-                auto Result = Template(ParserLocal.LoadFile(InputPath + static_cast<std::string>(Filename)));
-                ParserLocal.ParseIntoTemplate(Result, InputPath + static_cast<std::string>(Filename));
-                return Result;
+                return ParseTemplate(Filename, ParserConfigurationInstance);
             }
 
             Template ParseFile(const std::string &Filename){
                 return ParseTemplate(Filename);
             }
 
+            // ! Returns the parsed template of a file, it is only parsed again when
+            // ! the file was modified since the last time it was loaded or when a
+            // ! setter or a callback changed how it parses, the file is always
+            // ! copied, never mapped, as it may be rewritten in place
+            std::shared_ptr<const Template> LoadTemplate(const std::string &Filename){
+                return TemplateCacheInstance.Get(InputPath + Filename, [&](){
+                    auto Configuration = ParserConfigurationInstance;
+                    Configuration.MapTemplateFiles = false;
+                    return ParseTemplate(Filename, Configuration);
+                });
+            }
+
+            // ! Paths of the render data a template may read, through the templates
+            // ! it includes or extends too, see DependencyVisitor for their form
+            std::set<std::string> GetDependencies(const Template &TemplateLocal) const{
+                const auto Storage = GetTemplateStorage();
+                return DependencyVisitor(*Storage).Collect(TemplateLocal);
+            }
+
+            // ! Sets how many parsed template files are kept, zero disables the cache
+            void SetTemplateCacheCapacity(size_t Capacity){
+                TemplateCacheInstance.SetCapacity(Capacity);
+            }
+
+            void ClearTemplateCache(){
+                TemplateCacheInstance.Clear();
+            }
+
+            TemplateCacheStatistics GetTemplateCacheStatistics() const{
+                return TemplateCacheInstance.Statistics();
+            }
+
             std::string Render(std::string_view Input, const JSON &Data){
                 return Render(Parse(Input), Data);
             }
 
             std::string Render(const Template &TemplateLocal, const JSON &Data){
-                std::stringstream Stream;
-                RenderTo(Stream, TemplateLocal, Data);
-                return Stream.str();
+                std::string Result;
+                RenderInto(Result, TemplateLocal, Data);
+                return Result;
+            }
+
+            // ! Renders into the given string, its content is replaced but its
+            // ! capacity is kept so the same buffer can be reused across calls
+            std::string &RenderInto(std::string &Result, const Template &TemplateLocal, const JSON &Data){
+                Result.clear();
+                OutputSink Sink(Result);
+                RenderTo(Sink, TemplateLocal, Data);
+                return Result;
+            }
+
+            std::string &RenderInto(std::string &Result, std::string_view Input, const JSON &Data){
+                return RenderInto(Result, Parse(Input), Data);
             }
 
             std::string RenderFile(const std::string &Filename, const JSON &Data){
-                return Render(ParseTemplate(Filename), Data);
+                return Render(*LoadTemplate(Filename), Data);
             }
 
             std::string RenderFileWithJsonFile(const std::string &Filename, const std::string &FilenameData){
@@ -138,13 +320,13 @@ namespace Sydonia{
 
             void Write(const std::string &Filename, const JSON &Data, const std::string &FilenameOut){
                 std::ofstream File(OutputPath + FilenameOut);
-                File << RenderFile(Filename, Data);
+                RenderTo(File, *LoadTemplate(Filename), Data);
                 File.close();
             }
 
             void Write(const Template &TemplateLocal, const JSON &Data, const std::string &FilenameOut){
                 std::ofstream File(OutputPath + FilenameOut);
-                File << Render(TemplateLocal, Data);
+                RenderTo(File, TemplateLocal, Data);
                 File.close();
             }
 
@@ -159,12 +341,52 @@ namespace Sydonia{
             }
 
             std::ostream &RenderTo(std::ostream &Stream, const Template &TemplateLocal, const JSON &Data){
-                Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance).RenderTo(Stream, TemplateLocal, Data);
+                OutputSink Sink(Stream);
+                RenderTo(Sink, TemplateLocal, Data);
                 return Stream;
             }
 
+            // ! Reserves the expected output of the template up front (with an eighth
+            // ! of headroom) and feeds the actual size back into the estimate
+            OutputSink &RenderTo(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data){
+                const size_t Expected = TemplateLocal.OutputSize.Get();
+                Sink.Reserve(Expected + Expected / 8);
+                const size_t Start = Sink.Size();
+                const auto Storage = GetTemplateStorage();
+                Renderer(RenderConfigurationInstance, *Storage, FunctionStorageInstance).RenderTo(Sink, TemplateLocal, Data);
+                TemplateLocal.OutputSize.Update(Sink.Size() - Start);
+                return Sink;
+            }
+
+            // ! Renders a template read from Input piece by piece, the static text of
+            // ! a piece is written out and dropped before the next one is read, so
+            // ! only the statement being parsed is held in memory, templates read
+            // ! this way can not extend another one
+            std::ostream &RenderStream(std::istream &Input, std::ostream &Output, const JSON &Data){
+                const auto Shared = GetTemplateStorage();
+                TemplateStorage Discovered;
+                TemplateStream Pieces(Input, LexerConfigurationInstance);
+                Renderer RendererLocal(RenderConfigurationInstance, TemplateLookup(Discovered, Shared.get()), FunctionStorageInstance);
+                OutputSink Sink(Output);
+                std::string Piece;
+                size_t Offset = 0;
+                while(Pieces.Next(Piece, Offset)){
+                    Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, Discovered, FunctionStorageInstance, Shared.get());
+                    const Template PieceTemplate = ParserLocal.Parse(std::move(Piece), Offset, "./");
+                    for(const auto &Step : PieceTemplate.ProgramInstance.Instructions)
+                        if(Step.OpcodeInstance == Instruction::Opcode::Extends)
+                            SYDONIA_THROW(ParserError("Extends is not supported in a streamed template", PieceTemplate.Locate(Step.Node->Position)));
+                    RendererLocal.RenderPiece(Sink, PieceTemplate, Data);
+                }
+                Sink.Flush();
+                if(!Discovered.empty())
+                    PublishTemplates(std::move(Discovered), false);
+                return Output;
+            }
+
             std::string LoadFile(const std::string &Filename){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+                TemplateStorage Storage;
+                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, Storage, FunctionStorageInstance);
                 return ParserLocal.LoadFile(InputPath + Filename);
             }
 
@@ -188,27 +410,61 @@ namespace Sydonia{
 
             // ! Adds a callback with given number of arguments
             void AddCallback(const std::string &Name, int NumberArgs, const CallbackFunction &Callback){
+                ThrowIfFrozen();
                 FunctionStorageInstance.AddCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Adds a void callback with given number of arguments
             void AddVoidCallback(const std::string &Name, int NumberArgs, const VoidCallbackFunction &Callback){
+                ThrowIfFrozen();
                 FunctionStorageInstance.AddCallback(Name, NumberArgs, [Callback](Arguments &Args){
                     Callback(Args);
                     return JSON();
                 });
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Adds a variadic callback that writes its result into a slot
+            void AddResultCallback(const std::string &Name, const ResultCallbackFunction &Callback){
+                AddResultCallback(Name, -1, Callback);
+            }
+
+            // ! Adds a callback with given number of arguments that writes its result
+            // ! into a slot, nothing is allocated to call it
+            void AddResultCallback(const std::string &Name, int NumberArgs, const ResultCallbackFunction &Callback){
+                ThrowIfFrozen();
+                FunctionStorageInstance.AddResultCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Adds a variadic callback that evaluates its arguments on demand
+            void AddLazyCallback(const std::string &Name, const LazyCallbackFunction &Callback){
+                AddLazyCallback(Name, -1, Callback);
+            }
+
+            // ! Adds a callback with given number of arguments that evaluates them on
+            // ! demand, an argument that is never asked for is never evaluated
+            void AddLazyCallback(const std::string &Name, int NumberArgs, const LazyCallbackFunction &Callback){
+                ThrowIfFrozen();
+                FunctionStorageInstance.AddLazyCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Includes a template with a given name into the environment
             // ! then a template can be rendered in another template using
-            // ! the include "<Name>" syntax
+            // ! the include "<Name>" syntax, allowed on a frozen environment
             void IncludeTemplate(const std::string &Name, const Template &TemplateLocal){
-                TemplateStorageInstance[Name] = TemplateLocal;
+                TemplateStorage Added;
+                Added.emplace(Name, std::make_shared<const Template>(TemplateLocal));
+                PublishTemplates(std::move(Added), true);
             }
 
             // ! Sets a function that is called when an included file is not found
             void SetIncludeCallback(const std::function<Template(const std::string &, const std::string &)>& Callback){
+                ThrowIfFrozen();
                 ParserConfigurationInstance.IncludeCallback = Callback;
+                TemplateCacheInstance.Clear();
             }
     };
 
@@ -51,6 +51,10 @@ namespace Sydonia{
     struct DataError : public SydoniaError{
         explicit DataError(const std::string &Message, SourceLocation Location): SydoniaError("DataError", Message, Location){}
     };
+
+    struct EnvironmentError : public SydoniaError{
+        explicit EnvironmentError(const std::string &Message): SydoniaError("EnvironmentError", Message){}
+    };
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_EXCEPTIONS_HXX
\ No newline at end of file
@@ -13,13 +13,64 @@
 #ifndef SYDONIA_FUNCTION_STORAGE_HXX
 #define SYDONIA_FUNCTION_STORAGE_HXX
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
 namespace Sydonia{
     using Arguments = std::vector<const JSON*>;
+
+    // ! The arguments of a call as they sit in the renderer, nothing is copied
+    class ArgumentSpan{
+        const JSON* const* Data;
+        size_t Count;
+
+        public:
+            ArgumentSpan(const JSON* const* DataLocal, size_t CountLocal): Data(DataLocal), Count(CountLocal){}
+
+            size_t Size() const{
+                return Count;
+            }
+
+            const JSON &operator[](size_t Index) const{
+                return *Data[Index];
+            }
+
+            const JSON* const* begin() const{
+                return Data;
+            }
+
+            const JSON* const* end() const{
+                return Data + Count;
+            }
+    };
+
+    // ! The arguments of a lazy callback, each one is evaluated the first time
+    // ! it is asked for and kept for the rest of the call
+    class LazyArguments{
+        public:
+            virtual ~LazyArguments() = default;
+
+            virtual size_t Size() const = 0;
+            virtual const JSON &operator[](size_t Index) = 0;
+    };
+
     using CallbackFunction = std::function<JSON(Arguments &LocalArguments)>;
     using VoidCallbackFunction = std::function<void(Arguments &LocalArguments)>;
+    // ! Writes its result into a slot owned by the renderer, the slot may still
+    // ! hold the value of an earlier call so its storage can be reused
+    using ResultCallbackFunction = std::function<void(ArgumentSpan LocalArguments, JSON &Result)>;
+    using LazyCallbackFunction = std::function<void(LazyArguments &LocalArguments, JSON &Result)>;
+
+    // ! A user callback in any of its forms, shared by the storage and the nodes bound to it
+    struct Callable{
+        CallbackFunction Function;
+        ResultCallbackFunction ResultFunction;
+        LazyCallbackFunction LazyFunction;
+    };
 
     // ! Class for builtin functions and user-defined callbacks
     class FunctionStorage{
@@ -77,68 +128,141 @@ namespace Sydonia{
             };
 
             struct FunctionData{
-                explicit FunctionData(const Operation &OperationLocal, const CallbackFunction &CallbackLocal = CallbackFunction{})
-                    : OperationInstance(OperationLocal), Callback(CallbackLocal){}
+                explicit FunctionData(const Operation &OperationLocal, std::shared_ptr<const Callable> CallbackLocal = nullptr)
+                    : OperationInstance(OperationLocal), Callback(std::move(CallbackLocal)){}
                 const Operation OperationInstance;
-                const CallbackFunction Callback;
+                const std::shared_ptr<const Callable> Callback;
             };
         private:
-            const int Variadic {-1};
-
-            std::map<std::pair<std::string, int>, FunctionData> FunctionStorage = {
-                {std::make_pair("At", 2), FunctionData {Operation::At}},
-                {std::make_pair("Default", 2), FunctionData {Operation::Default}},
-                {std::make_pair("DivisibleBy", 2), FunctionData {Operation::DivisibleBy}},
-                {std::make_pair("Even", 1), FunctionData {Operation::Even}},
-                {std::make_pair("Exists", 1), FunctionData {Operation::Exists}},
-                {std::make_pair("ExistsIn", 2), FunctionData {Operation::ExistsInObject}},
-                {std::make_pair("First", 1), FunctionData {Operation::First}},
-                {std::make_pair("Float", 1), FunctionData {Operation::Float}},
-                {std::make_pair("Int", 1), FunctionData {Operation::Int}},
-                {std::make_pair("IsArray", 1), FunctionData {Operation::IsArray}},
-                {std::make_pair("IsBoolean", 1), FunctionData {Operation::IsBoolean}},
-                {std::make_pair("IsFloat", 1), FunctionData {Operation::IsFloat}},
-                {std::make_pair("IsInteger", 1), FunctionData {Operation::IsInteger}},
-                {std::make_pair("IsNumber", 1), FunctionData {Operation::IsNumber}},
-                {std::make_pair("IsObject", 1), FunctionData {Operation::IsObject}},
-                {std::make_pair("IsString", 1), FunctionData {Operation::IsString}},
-                {std::make_pair("Last", 1), FunctionData {Operation::Last}},
-                {std::make_pair("Length", 1), FunctionData {Operation::Length}},
-                {std::make_pair("Lower", 1), FunctionData {Operation::Lower}},
-                {std::make_pair("Max", 1), FunctionData {Operation::Max}},
-                {std::make_pair("Min", 1), FunctionData {Operation::Min}},
-                {std::make_pair("Odd", 1), FunctionData {Operation::Odd}},
-                {std::make_pair("Range", 1), FunctionData {Operation::Range}},
-                {std::make_pair("Round", 2), FunctionData {Operation::Round}},
-                {std::make_pair("Sort", 1), FunctionData {Operation::Sort}},
-                {std::make_pair("Upper", 1), FunctionData {Operation::Upper}},
-                {std::make_pair("Super", 0), FunctionData {Operation::Super}},
-                {std::make_pair("Super", 1), FunctionData {Operation::Super}},
-                {std::make_pair("Join", 2), FunctionData {Operation::Join}},  
+            static constexpr int Variadic {-1};
+
+            struct Entry{
+                std::string Name;
+                int NumArgs;
+                size_t Hash;
+                FunctionData Data;
+            };
+
+            struct Builtin{
+                std::string_view Name;
+                int NumArgs;
+                Operation OperationInstance;
             };
 
+            // ! Functions in the order they were added, the first one added under a
+            // ! name and number of arguments is the one that is found
+            std::vector<Entry> Entries;
+            // ! Open addressing table of indexes into Entries plus one, zero is an
+            // ! empty slot, its size is a power of two kept at least twice Entries
+            std::vector<uint32_t> Slots;
+
+            static size_t HashOf(std::string_view Name, int NumArgs){
+                // ! FNV-1a over the name, then the number of arguments mixed in
+                uint64_t Hash = 14695981039346656037ull;
+                for(const char Character : Name){
+                    Hash ^= static_cast<unsigned char>(Character);
+                    Hash *= 1099511628211ull;
+                }
+                Hash ^= static_cast<uint64_t>(static_cast<uint32_t>(NumArgs));
+                Hash *= 1099511628211ull;
+                return static_cast<size_t>(Hash ^ (Hash >> 32));
+            }
+
+            const Entry* Find(std::string_view Name, int NumArgs) const{
+                if(Slots.empty())
+                    return nullptr;
+                const size_t Hash = HashOf(Name, NumArgs);
+                const size_t Mask = Slots.size() - 1;
+                for(size_t Slot = Hash & Mask; Slots[Slot] != 0; Slot = (Slot + 1) & Mask){
+                    const Entry &Candidate = Entries[Slots[Slot] - 1];
+                    if(Candidate.Hash == Hash && Candidate.NumArgs == NumArgs && Candidate.Name == Name)
+                        return &Candidate;
+                }
+                return nullptr;
+            }
+
+            void Insert(size_t Index){
+                const size_t Mask = Slots.size() - 1;
+                size_t Slot = Entries[Index].Hash & Mask;
+                while(Slots[Slot] != 0)
+                    Slot = (Slot + 1) & Mask;
+                Slots[Slot] = static_cast<uint32_t>(Index + 1);
+            }
+
+            void Add(std::string_view Name, int NumArgs, FunctionData &&Data){
+                if(Find(Name, NumArgs))
+                    return;
+                Entries.push_back(Entry {static_cast<std::string>(Name), NumArgs, HashOf(Name, NumArgs), std::move(Data)});
+                if(Entries.size() * 2 > Slots.size()){
+                    Slots.assign(std::max<size_t>(64, Slots.size() * 2), 0);
+                    for(size_t Index = 0; Index < Entries.size(); Index += 1)
+                        Insert(Index);
+                }else
+                    Insert(Entries.size() - 1);
+            }
+
         public:
+            FunctionStorage(){
+                static constexpr Builtin Builtins[] = {
+                    {"At", 2, Operation::At},
+                    {"Default", 2, Operation::Default},
+                    {"DivisibleBy", 2, Operation::DivisibleBy},
+                    {"Even", 1, Operation::Even},
+                    {"Exists", 1, Operation::Exists},
+                    {"ExistsIn", 2, Operation::ExistsInObject},
+                    {"First", 1, Operation::First},
+                    {"Float", 1, Operation::Float},
+                    {"Int", 1, Operation::Int},
+                    {"IsArray", 1, Operation::IsArray},
+                    {"IsBoolean", 1, Operation::IsBoolean},
+                    {"IsFloat", 1, Operation::IsFloat},
+                    {"IsInteger", 1, Operation::IsInteger},
+                    {"IsNumber", 1, Operation::IsNumber},
+                    {"IsObject", 1, Operation::IsObject},
+                    {"IsString", 1, Operation::IsString},
+                    {"Last", 1, Operation::Last},
+                    {"Length", 1, Operation::Length},
+                    {"Lower", 1, Operation::Lower},
+                    {"Max", 1, Operation::Max},
+                    {"Min", 1, Operation::Min},
+                    {"Odd", 1, Operation::Odd},
+                    {"Range", 1, Operation::Range},
+                    {"Round", 2, Operation::Round},
+                    {"Sort", 1, Operation::Sort},
+                    {"Upper", 1, Operation::Upper},
+                    {"Super", 0, Operation::Super},
+                    {"Super", 1, Operation::Super},
+                    {"Join", 2, Operation::Join},
+                };
+                for(const auto &BuiltinLocal : Builtins)
+                    AddBuiltin(BuiltinLocal.Name, BuiltinLocal.NumArgs, BuiltinLocal.OperationInstance);
+            }
+
             void AddBuiltin(std::string_view Name, int NumArgs, Operation OperationLocal){
-                FunctionStorage.emplace(std::make_pair(static_cast<std::string>(Name), NumArgs), FunctionData {OperationLocal});
+                Add(Name, NumArgs, FunctionData {OperationLocal});
             }
 
             void AddCallback(std::string_view Name, int NumArgs, const CallbackFunction &CallbackLocal){
-                FunctionStorage.emplace(std::make_pair(static_cast<std::string>(Name), NumArgs), FunctionData {Operation::Callback, CallbackLocal});
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {CallbackLocal, nullptr, nullptr})});
             }
 
-            FunctionData FindFunction(std::string_view Name, int NumArgs) const{
-                auto Iterator = FunctionStorage.find(std::make_pair(static_cast<std::string>(Name), NumArgs));
-                if(Iterator != FunctionStorage.end())
-                    return Iterator->second;
-                // ! Find variadic function
-                else if(NumArgs > 0){
-                    Iterator = FunctionStorage.find(std::make_pair(static_cast<std::string>(Name), Variadic));
-                    if(Iterator != FunctionStorage.end())
-                        return Iterator->second;
-                }
+            void AddResultCallback(std::string_view Name, int NumArgs, const ResultCallbackFunction &CallbackLocal){
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {nullptr, CallbackLocal, nullptr})});
+            }
 
-                return FunctionData {Operation::None};
-            };
+            void AddLazyCallback(std::string_view Name, int NumArgs, const LazyCallbackFunction &CallbackLocal){
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {nullptr, nullptr, CallbackLocal})});
+            }
+
+            // ! The reference is valid until the next function is added
+            const FunctionData &FindFunction(std::string_view Name, int NumArgs) const{
+                static const FunctionData NotFound {Operation::None};
+                const Entry* Found = Find(Name, NumArgs);
+                // ! Find variadic function
+                if(!Found && NumArgs > 0)
+                    Found = Find(Name, Variadic);
+                return Found ? Found->Data : NotFound;
+            }
     };
 }; // ! Sydonia namespace
 
@@ -16,6 +16,7 @@
 #include <cctype>
 #include <locale>
 
+#include "CharacterScanner.hxx"
 #include "Configuration.hxx"
 #include "Token.hxx"
 #include "Utilities.hxx"
@@ -45,6 +46,7 @@ namespace Sydonia{
     };
 
     const LexerConfiguration& LexerConfigurationInstance;
+    const CharacterScanner OpenScanner;
 
     State StateInstance;
     MinusState MinusStateInstance;
@@ -190,7 +192,8 @@ namespace Sydonia{
           break;
         Position += 1;
       }
-      return MakeToken(Token::Kind::Id);
+      const std::string_view Text = StringView::Slice(M_IN, TokenStart, Position);
+      return Token(Token::Kind::Id, Keywords::Classify(Text), Text);
     }
 
     Token ScanNumber(){
@@ -212,12 +215,12 @@ namespace Sydonia{
         if(Position >= M_IN.size())
           break;
         const char Character = M_IN[Position++];
-        if(Character == '\\')
+        if(Escape)
+          Escape = false;
+        else if(Character == '\\')
           Escape = true;
-        else if(!Escape && Character == M_IN[TokenStart])
+        else if(Character == M_IN[TokenStart])
           break;
-        else
-          Escape = false;
       }
       return MakeToken(Token::Kind::String);
     }
@@ -263,25 +266,41 @@ namespace Sydonia{
       return Result;
     }
 
+    // ! Openers that start at Offset, a variant (force lstrip and so on) only
+    // ! counts together with its plain opener and a line statement only at the
+    // ! start of a line
+    OpenerMatcher::Set MatchOpeners(size_t Offset) const{
+      OpenerMatcher::Set Matches = LexerConfigurationInstance.OpenerMatcherInstance.Match(M_IN.substr(Offset));
+      if(Offset != 0 && M_IN[Offset - 1] != '\n')
+        Matches &= ~OpenerMatcher::Bit(Opener::LineStatement);
+      constexpr OpenerMatcher::Set Plain = OpenerMatcher::Bit(Opener::Expression) | OpenerMatcher::Bit(Opener::Statement) |
+        OpenerMatcher::Bit(Opener::Comment) | OpenerMatcher::Bit(Opener::LineStatement);
+      return (Matches & Plain) ? Matches : 0;
+    }
+
   public:
     explicit Lexer(const LexerConfiguration& LexerConfigurationLocal)
-      : LexerConfigurationInstance(LexerConfigurationLocal), StateInstance(State::Text), 
+      : LexerConfigurationInstance(LexerConfigurationLocal), OpenScanner(LexerConfigurationLocal.OpenCharacters), StateInstance(State::Text), 
         MinusStateInstance(MinusState::Number){}
 
     SourceLocation CurrentPosition() const{
       return GetSourceLocation(M_IN, TokenStart);
     }
 
-    void Start(std::string_view Input){
+    // ! Starts lexing Input in the text state at Offset, which has to be the
+    // ! start of a text token when it isn't zero
+    void Start(std::string_view Input, size_t Offset = 0){
       M_IN = Input;
-      TokenStart = 0;
-      Position = 0;
       StateInstance = State::Text;
       MinusStateInstance = MinusState::Number;
 
       // ! Consume byte order mark (BOM) for UTF-8
-      if(StringView::StartsWith(M_IN, "\xEF\xBB\xBF"))
+      if(StringView::StartsWith(M_IN, "\xEF\xBB\xBF")){
         M_IN = M_IN.substr(3);
+        Offset = (Offset > 3) ? Offset - 3 : 0;
+      }
+      TokenStart = Offset;
+      Position = Offset;
     }
 
     Token Scan(){
@@ -294,49 +313,52 @@ namespace Sydonia{
       switch(StateInstance){
         default:
         case State::Text: {
-          // ! Fast-scan to first open character
-          const size_t OpenStart = M_IN.substr(Position).find_first_of(LexerConfigurationInstance.OpenCharacters);
+          // ! Fast-scan to first open character, classifying each candidate once
+          OpenerMatcher::Set Matches = 0;
+          const size_t OpenStart = OpenScanner.Find(M_IN, Position, [this, &Matches](size_t Candidate){
+            Matches = MatchOpeners(Candidate);
+            return Matches != 0;
+          });
           if(OpenStart == std::string_view::npos){
             // ! Didn't find open, return remaining text as text token
             Position = M_IN.size();
             return MakeToken(Token::Kind::Text);
           }
-          Position += OpenStart;
+          Position = OpenStart;
 
-          // ! Try to match one of the opening sequences, and get the close
-          std::string_view OpenString = M_IN.substr(Position);
+          // ! Pick the opening sequence, and get the close
+          const auto Has = [Matches](Opener OpenerLocal){
+            return (Matches & OpenerMatcher::Bit(OpenerLocal)) != 0;
+          };
           bool MustLstrip = false;
-          if(StringView::StartsWith(OpenString, LexerConfigurationInstance.ExpressionOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.ExpressionOpenForceLstrip)){
+          if(Has(Opener::Expression)){
+            if(Has(Opener::ExpressionForceLstrip)){
               StateInstance = State::ExpressionStartForceLstrip;
               MustLstrip = true;
             }else
               StateInstance = State::ExpressionStart;
-          }else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpenNoLstrip))
+          }else if(Has(Opener::Statement)){
+            if(Has(Opener::StatementNoLstrip))
               StateInstance = State::StatementStartNoLstrip;
-            else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpenForceLstrip)){
+            else if(Has(Opener::StatementForceLstrip)){
               StateInstance = State::StatementStartForceLstrip;
               MustLstrip = true;
             }else{
               StateInstance = State::StatementStart;
               MustLstrip = LexerConfigurationInstance.LstripBlocks;
             }
-          }else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.CommentOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.CommentOpenForceLstrip)){
+          }else if(Has(Opener::Comment)){
+            if(Has(Opener::CommentForceLstrip)){
               StateInstance = State::CommentStartForceLstrip;
               MustLstrip = true;
             }else{
               StateInstance = State::CommentStart;
               MustLstrip = LexerConfigurationInstance.LstripBlocks;
             }
-          }else if((Position == 0 || M_IN[Position - 1] == '\n') && StringView::StartsWith(OpenString, LexerConfigurationInstance.LineStatement))
+          }else
             StateInstance = State::LineStart;
-          else{
-            // ! Wasn't actually an opening sequence
-            Position += 1;
-            goto Again;
-          }
+          // ! Every tag starts lexing the same way, whatever the previous one ended with
+          MinusStateInstance = MinusState::Number;
 
           std::string_view Text = StringView::Slice(M_IN, TokenStart, Position);
           if(MustLstrip)
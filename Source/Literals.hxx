@@ -0,0 +1,301 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_LITERALS_HXX
+#define SYDONIA_LITERALS_HXX
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace Sydonia{
+    // ! Decoding of literal tokens straight into values, the result is the same
+    // ! JSON::parse gives for the token text
+    namespace Literals{
+        inline bool IsDigit(char Character){
+            return Character >= '0' && Character <= '9';
+        }
+
+        inline bool DecodeFloat(std::string_view Text, JSON &Value){
+            double Result = 0;
+#if defined(__cpp_lib_to_chars)
+            const auto Status = std::from_chars(Text.data(), Text.data() + Text.size(), Result);
+            if(Status.ec == std::errc()){
+                Value = Result;
+                return true;
+            }
+#endif
+            // ! Out of range (underflow is accepted as JSON::parse does)
+            const std::string Terminated(Text);
+            Result = std::strtod(Terminated.c_str(), nullptr);
+            if(!std::isfinite(Result))
+                return false;
+            Value = Result;
+            return true;
+        }
+
+        // ! Number in JSON syntax, a non negative integer becomes unsigned and a
+        // ! negative one signed, integers that do not fit become floats
+        inline bool DecodeNumber(std::string_view Text, JSON &Value){
+            size_t Iterator = 0;
+            const bool Negative = !Text.empty() && Text[0] == '-';
+            if(Negative)
+                Iterator += 1;
+            if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                return false;
+            if(Text[Iterator] == '0')
+                Iterator += 1;
+            else
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            bool IsInteger = true;
+            if(Iterator < Text.size() && Text[Iterator] == '.'){
+                IsInteger = false;
+                Iterator += 1;
+                if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                    return false;
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            }
+            if(Iterator < Text.size() && (Text[Iterator] == 'e' || Text[Iterator] == 'E')){
+                IsInteger = false;
+                Iterator += 1;
+                if(Iterator < Text.size() && (Text[Iterator] == '+' || Text[Iterator] == '-'))
+                    Iterator += 1;
+                if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                    return false;
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            }
+            if(Iterator != Text.size())
+                return false;
+
+            if(IsInteger){
+                const char* First = Text.data();
+                const char* Last = Text.data() + Text.size();
+                if(Negative){
+                    std::int64_t Result;
+                    if(std::from_chars(First, Last, Result).ec == std::errc()){
+                        Value = Result;
+                        return true;
+                    }
+                }else{
+                    std::uint64_t Result;
+                    if(std::from_chars(First, Last, Result).ec == std::errc()){
+                        Value = Result;
+                        return true;
+                    }
+                }
+            }
+            return DecodeFloat(Text, Value);
+        }
+
+        inline void AppendCodePoint(std::string &Output, std::uint32_t CodePoint){
+            if(CodePoint < 0x80)
+                Output += static_cast<char>(CodePoint);
+            else if(CodePoint < 0x800){
+                Output += static_cast<char>(0xC0 | (CodePoint >> 6));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }else if(CodePoint < 0x10000){
+                Output += static_cast<char>(0xE0 | (CodePoint >> 12));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }else{
+                Output += static_cast<char>(0xF0 | (CodePoint >> 18));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }
+        }
+
+        inline bool ReadHex(std::string_view Text, size_t Position, std::uint32_t &CodePoint){
+            if(Position + 4 > Text.size())
+                return false;
+            CodePoint = 0;
+            for(size_t Iterator = Position; Iterator < Position + 4; Iterator += 1){
+                const char Character = Text[Iterator];
+                CodePoint <<= 4;
+                if(IsDigit(Character))
+                    CodePoint |= Character - '0';
+                else if(Character >= 'a' && Character <= 'f')
+                    CodePoint |= Character - 'a' + 10;
+                else if(Character >= 'A' && Character <= 'F')
+                    CodePoint |= Character - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        }
+
+        // ! Double quoted string token with JSON escapes, the runs between escapes
+        // ! are copied at once
+        inline bool DecodeString(std::string_view Text, std::string &Output){
+            if(Text.size() < 2 || Text.front() != '"' || Text.back() != '"')
+                return false;
+            const size_t End = Text.size() - 1;
+            Output.clear();
+            Output.reserve(End - 1);
+            size_t Iterator = 1;
+            while(Iterator < End){
+                size_t RunEnd = Iterator;
+                while(RunEnd < End && Text[RunEnd] != '\\'){
+                    if(static_cast<unsigned char>(Text[RunEnd]) < 0x20)
+                        return false;
+                    RunEnd += 1;
+                }
+                Output.append(Text.data() + Iterator, RunEnd - Iterator);
+                if(RunEnd == End)
+                    return true;
+                // ! The lexer ends the token at the first quote that is not escaped
+                if(RunEnd + 1 >= End)
+                    return false;
+                Iterator = RunEnd + 2;
+                switch(Text[RunEnd + 1]){
+                    case '"': Output += '"'; break;
+                    case '\\': Output += '\\'; break;
+                    case '/': Output += '/'; break;
+                    case 'b': Output += '\b'; break;
+                    case 'f': Output += '\f'; break;
+                    case 'n': Output += '\n'; break;
+                    case 'r': Output += '\r'; break;
+                    case 't': Output += '\t'; break;
+                    case 'u': {
+                        std::uint32_t CodePoint;
+                        if(!ReadHex(Text.substr(0, End), Iterator, CodePoint))
+                            return false;
+                        Iterator += 4;
+                        if(CodePoint >= 0xDC00 && CodePoint <= 0xDFFF)
+                            return false;
+                        if(CodePoint >= 0xD800 && CodePoint <= 0xDBFF){
+                            std::uint32_t Low;
+                            if(Iterator + 2 > End || Text[Iterator] != '\\' || Text[Iterator + 1] != 'u' ||
+                                !ReadHex(Text.substr(0, End), Iterator + 2, Low) || Low < 0xDC00 || Low > 0xDFFF)
+                                return false;
+                            Iterator += 6;
+                            CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+                        }
+                        AppendCodePoint(Output, CodePoint);
+                    } break;
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // ! Builds an array or object literal from its tokens as the parser reads
+        // ! them, every call returns false when the token can not appear there
+        class Builder{
+            enum class Expect : std::uint8_t{
+                ValueOrClose,
+                Value,
+                KeyOrClose,
+                Key,
+                Colon,
+                CommaOrClose,
+            };
+
+            struct Level{
+                JSON Value;
+                std::string Key;
+                Expect ExpectInstance;
+            };
+
+            std::vector<Level> Levels;
+
+            bool ExpectsValue() const{
+                return Levels.empty() || Levels.back().ExpectInstance == Expect::ValueOrClose || Levels.back().ExpectInstance == Expect::Value;
+            }
+
+            public:
+                size_t Depth() const{
+                    return Levels.size();
+                }
+
+                void Clear(){
+                    Levels.clear();
+                }
+
+                bool Open(bool IsObject){
+                    if(!ExpectsValue())
+                        return false;
+                    Levels.push_back({IsObject ? JSON::object() : JSON::array(), std::string(), IsObject ? Expect::KeyOrClose : Expect::ValueOrClose});
+                    return true;
+                }
+
+                bool Add(JSON &&Value){
+                    if(Levels.empty())
+                        return false;
+                    Level &Current = Levels.back();
+                    switch(Current.ExpectInstance){
+                        case Expect::ValueOrClose:
+                        case Expect::Value: {
+                            if(Current.Value.is_array())
+                                Current.Value.push_back(std::move(Value));
+                            else
+                                Current.Value[Current.Key] = std::move(Value);
+                            Current.ExpectInstance = Expect::CommaOrClose;
+                        } return true;
+                        case Expect::KeyOrClose:
+                        case Expect::Key: {
+                            if(!Value.is_string())
+                                return false;
+                            Current.Key = std::move(Value.get_ref<std::string&>());
+                            Current.ExpectInstance = Expect::Colon;
+                        } return true;
+                        default:
+                            return false;
+                    }
+                }
+
+                bool Comma(){
+                    if(Levels.empty() || Levels.back().ExpectInstance != Expect::CommaOrClose)
+                        return false;
+                    Levels.back().ExpectInstance = Levels.back().Value.is_array() ? Expect::Value : Expect::Key;
+                    return true;
+                }
+
+                bool Colon(){
+                    if(Levels.empty() || Levels.back().ExpectInstance != Expect::Colon)
+                        return false;
+                    Levels.back().ExpectInstance = Expect::Value;
+                    return true;
+                }
+
+                // ! Closes the innermost literal, Result holds the whole literal once
+                // ! the outermost one is closed
+                bool Close(bool IsObject, JSON &Result){
+                    if(Levels.empty() || Levels.back().Value.is_object() != IsObject)
+                        return false;
+                    const Expect ExpectLocal = Levels.back().ExpectInstance;
+                    if(ExpectLocal != Expect::CommaOrClose && ExpectLocal != Expect::ValueOrClose && ExpectLocal != Expect::KeyOrClose)
+                        return false;
+                    JSON Value = std::move(Levels.back().Value);
+                    Levels.pop_back();
+                    if(Levels.empty()){
+                        Result = std::move(Value);
+                        return true;
+                    }
+                    return Add(std::move(Value));
+                }
+        };
+    }; // ! Literals namespace
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_LITERALS_HXX
\ No newline at end of file
@@ -13,9 +13,11 @@
 #ifndef SYDONIA_NODE_HXX
 #define SYDONIA_NODE_HXX
 
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "FunctionStorage.hxx"
 #include "Utilities.hxx"
@@ -72,7 +74,8 @@ namespace Sydonia{
 
     class BlockNode : public AstNode{
         public:
-            std::vector<std::shared_ptr<AstNode>> Nodes;
+            // ! Owned by the NodeArena of the template
+            std::vector<AstNode*> Nodes;
             explicit BlockNode(): AstNode(0){}
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
@@ -99,7 +102,7 @@ namespace Sydonia{
     class LiteralNode : public ExpressionNode{
         public:
             const JSON Value;
-            explicit LiteralNode(std::string_view DataText, size_t Position): ExpressionNode(Position), Value(JSON::parse(DataText)){}
+            explicit LiteralNode(JSON ValueLocal, size_t Position): ExpressionNode(Position), Value(std::move(ValueLocal)){}
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
             }
@@ -107,8 +110,64 @@ namespace Sydonia{
 
     class DataNode : public ExpressionNode{
         public:
+            // ! A segment of a dotted name, Index holds the segment as an array
+            // ! index when it is a number so arrays are walked without parsing
+            struct PathSegment{
+                std::string Key;
+                size_t Index;
+            };
+
             const std::string Name;
-            const JSON::json_pointer Pointer;
+            const std::vector<PathSegment> Path;
+
+            // ! Member of the Loop variable a name refers to, Depth counts the
+            // ! Parent segments in between, anything else materializes the frame
+            struct LoopAccess{
+                enum class Member{
+                    None,
+                    Frame,
+                    Index,
+                    Index1,
+                    IsFirst,
+                    IsLast
+                };
+
+                Member MemberInstance;
+                size_t Depth;
+            };
+
+            const LoopAccess LoopAccessInstance;
+            // ! Callback taking no arguments the name was bound to while parsing,
+            // ! called when the render data does not hold the name
+            std::shared_ptr<const Callable> Callback;
+
+            static LoopAccess ParseLoopAccess(std::string_view PointerName){
+                using Member = LoopAccess::Member;
+                std::string_view Part;
+                std::tie(Part, PointerName) = StringView::Split(PointerName, '.');
+                if(Part != "Loop")
+                    return LoopAccess {Member::None, 0};
+                size_t Depth = 0;
+                while(!PointerName.empty()){
+                    std::tie(Part, PointerName) = StringView::Split(PointerName, '.');
+                    if(Part == "Parent"){
+                        Depth += 1;
+                        continue;
+                    }
+                    if(!PointerName.empty())
+                        break;
+                    if(Part == "Index")
+                        return LoopAccess {Member::Index, Depth};
+                    if(Part == "Index1")
+                        return LoopAccess {Member::Index1, Depth};
+                    if(Part == "IsFirst")
+                        return LoopAccess {Member::IsFirst, Depth};
+                    if(Part == "IsLast")
+                        return LoopAccess {Member::IsLast, Depth};
+                    break;
+                }
+                return LoopAccess {Member::Frame, 0};
+            }
 
             static std::string ConvertDotToPointer(std::string_view PointerName){
                 std::string Result;
@@ -121,7 +180,62 @@ namespace Sydonia{
                 return Result;
             }
 
-            explicit DataNode(std::string_view PointerNameLocal, size_t Position):  ExpressionNode(Position), Name(PointerNameLocal), Pointer(JSON::json_pointer(ConvertDotToPointer(PointerNameLocal))){}
+            static std::vector<PathSegment> SplitPath(std::string_view PointerName){
+                std::vector<PathSegment> Result;
+                do{
+                    // ! Slashes separate segments too, as they do in the JSON pointer
+                    const size_t Separator = PointerName.find_first_of("./");
+                    const std::string_view Part = PointerName.substr(0, Separator);
+                    PointerName = (Separator == std::string_view::npos) ? std::string_view() : PointerName.substr(Separator + 1);
+                    size_t Index = std::string_view::npos;
+                    if(!Part.empty() && (Part.size() == 1 || Part[0] != '0')){
+                        size_t Value;
+                        const auto Parsed = std::from_chars(Part.data(), Part.data() + Part.size(), Value);
+                        if(Parsed.ec == std::errc() && Parsed.ptr == Part.data() + Part.size())
+                            Index = Value;
+                    }
+                    Result.push_back(PathSegment {std::string(Part), Index});
+                }while(!PointerName.empty());
+                return Result;
+            }
+
+            // ! Walks Root along the path starting at segment From, a single
+            // ! lookup per segment instead of contains() followed by operator[]
+            const JSON* Find(const JSON &Root, size_t From = 0) const{
+                const JSON* Current = &Root;
+                for(size_t Iterator = From; Iterator < Path.size(); Iterator += 1){
+                    const auto &Segment = Path[Iterator];
+                    if(Current->is_object()){
+                        const auto &Object = Current->get_ref<const JSON::object_t&>();
+                        const auto Found = Object.find(Segment.Key);
+                        if(Found == Object.end())
+                            return nullptr;
+                        Current = &Found->second;
+                    }else if(Current->is_array() && Segment.Index < Current->size())
+                        Current = &(*Current)[Segment.Index];
+                    else
+                        return nullptr;
+                }
+                return Current;
+            }
+
+            const std::string &Head() const{
+                return Path.front().Key;
+            }
+
+            static std::string_view HeadOf(std::string_view PointerName){
+                return PointerName.substr(0, PointerName.find_first_of("./"));
+            }
+
+            static std::string TailOf(std::string_view PointerName){
+                const size_t Separator = PointerName.find_first_of("./");
+                if(Separator == std::string_view::npos || Separator + 1 >= PointerName.size())
+                    return "";
+                return ConvertDotToPointer(PointerName.substr(Separator + 1));
+            }
+
+            explicit DataNode(std::string_view PointerNameLocal, size_t Position):  ExpressionNode(Position), Name(PointerNameLocal),
+                Path(SplitPath(PointerNameLocal)), LoopAccessInstance(ParseLoopAccess(PointerNameLocal)){}
 
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
@@ -145,8 +259,8 @@ namespace Sydonia{
             std::string Name;
             // ! Should also be negative -> -1 for unknown number
             int NumberArgs;
-            std::vector<std::shared_ptr<ExpressionNode>> Arguments;
-            CallbackFunction Callback;
+            std::vector<ExpressionNode*> Arguments;
+            std::shared_ptr<const Callable> Callback;
 
             explicit FunctionNode(std::string_view NameLocal, size_t Position)
                 : ExpressionNode(Position), Precedence(8), AssociativityInstance(Associativity::Left), OperationInstance(Operation::Callback), Name(NameLocal), NumberArgs(1){} 
@@ -252,7 +366,7 @@ namespace Sydonia{
 
     class ExpressionListNode : public AstNode{
         public:
-            std::shared_ptr<ExpressionNode> Root;
+            ExpressionNode* Root {nullptr};
             explicit ExpressionListNode(): AstNode(0){}
             explicit ExpressionListNode(size_t Position): AstNode(Position){}
 
@@ -358,9 +472,13 @@ namespace Sydonia{
     class SetStatementNode : public StatementNode{
         public:
             const std::string Key;
+            const JSON::json_pointer Pointer;
+            const std::string Head;
+            const JSON::json_pointer Tail;
             ExpressionListNode Expression;
 
-            explicit SetStatementNode(const std::string &KeyLocal, size_t Position): StatementNode(Position), Key(KeyLocal){}
+            explicit SetStatementNode(const std::string &KeyLocal, size_t Position): StatementNode(Position), Key(KeyLocal), Pointer(JSON::json_pointer(DataNode::ConvertDotToPointer(KeyLocal))),
+                Head(DataNode::HeadOf(KeyLocal)), Tail(JSON::json_pointer(DataNode::TailOf(KeyLocal))){}
 
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
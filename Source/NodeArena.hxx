@@ -0,0 +1,86 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_NODE_ARENA_HXX
+#define SYDONIA_NODE_ARENA_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Node.hxx"
+
+namespace Sydonia{
+    // ! Bump allocator owning the nodes of a template, nodes are laid out one
+    // ! after another in a few large chunks, never move and are all destroyed
+    // ! together with the arena
+    class NodeArena{
+        static constexpr size_t InitialChunkSize {4096};
+        static constexpr size_t MaximumChunkSize {65536};
+
+        std::vector<std::unique_ptr<std::byte[]>> Chunks;
+        std::byte* Current {nullptr};
+        size_t Remaining {0};
+        size_t NextChunkSize {InitialChunkSize};
+        // ! Nodes in creation order so they can be destroyed in reverse
+        std::vector<AstNode*> Nodes;
+
+        void* Allocate(size_t Size, size_t Alignment){
+            size_t Padding = (Alignment - reinterpret_cast<std::uintptr_t>(Current) % Alignment) % Alignment;
+            if(!Current || Padding + Size > Remaining){
+                const size_t ChunkSize = std::max(NextChunkSize, Size + Alignment);
+                Chunks.emplace_back(new std::byte[ChunkSize]);
+                Current = Chunks.back().get();
+                Remaining = ChunkSize;
+                NextChunkSize = std::min(NextChunkSize * 2, MaximumChunkSize);
+                Padding = (Alignment - reinterpret_cast<std::uintptr_t>(Current) % Alignment) % Alignment;
+            }
+            void* Result = Current + Padding;
+            Current += Padding + Size;
+            Remaining -= Padding + Size;
+            return Result;
+        }
+
+        public:
+            NodeArena() = default;
+            NodeArena(const NodeArena&) = delete;
+            NodeArena &operator=(const NodeArena&) = delete;
+
+            ~NodeArena(){
+                for(auto Iterator = Nodes.rbegin(); Iterator != Nodes.rend(); ++Iterator)
+                    (*Iterator)->~AstNode();
+            }
+
+            template<typename NodeType, typename... Parameters>
+            NodeType* Create(Parameters&&... ParametersLocal){
+                static_assert(std::is_base_of<AstNode, NodeType>::value, "NodeArena only holds AST nodes");
+                // ! Grow the list first so recording the node can not throw
+                if(Nodes.size() == Nodes.capacity())
+                    Nodes.reserve(std::max<size_t>(64, Nodes.capacity() * 2));
+                auto Result = new (Allocate(sizeof(NodeType), alignof(NodeType))) NodeType(std::forward<Parameters>(ParametersLocal)...);
+                Nodes.emplace_back(Result);
+                return Result;
+            }
+
+            // ! Number of nodes held by the arena
+            size_t Size() const{
+                return Nodes.size();
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_NODE_ARENA_HXX
\ No newline at end of file
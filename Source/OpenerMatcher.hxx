@@ -0,0 +1,110 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_OPENER_MATCHER_HXX
+#define SYDONIA_OPENER_MATCHER_HXX
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Sydonia{
+    // ! Opening sequences the lexer looks for in static text
+    enum class Opener : std::uint8_t{
+        Expression,
+        ExpressionForceLstrip,
+        Statement,
+        StatementNoLstrip,
+        StatementForceLstrip,
+        Comment,
+        CommentForceLstrip,
+        LineStatement,
+    };
+
+    // ! Trie over the opening sequences of a lexer configuration, one walk from
+    // ! a candidate position reports every opener that starts there, so custom
+    // ! delimiters cost the same as the default ones
+    class OpenerMatcher{
+        struct Node{
+            // ! Few children per node, a linear search beats a table here
+            std::vector<std::pair<char, std::uint16_t>> Children;
+            std::uint8_t Terminals {0};
+        };
+
+        // ! First character of the sequences, zero when no sequence starts with it
+        std::array<std::uint16_t, 256> RootChildren {};
+        std::vector<Node> Nodes {Node()};
+
+        public:
+            using Set = std::uint8_t;
+
+            static constexpr Set Bit(Opener OpenerLocal){
+                return static_cast<Set>(1u << static_cast<unsigned>(OpenerLocal));
+            }
+
+            void Clear(){
+                RootChildren.fill(0);
+                Nodes.assign(1, Node());
+            }
+
+            void Add(std::string_view Sequence, Opener OpenerLocal){
+                if(Sequence.empty())
+                    return;
+                std::uint16_t Current = RootChildren[static_cast<unsigned char>(Sequence[0])];
+                if(Current == 0){
+                    Current = static_cast<std::uint16_t>(Nodes.size());
+                    Nodes.emplace_back();
+                    RootChildren[static_cast<unsigned char>(Sequence[0])] = Current;
+                }
+                for(size_t Iterator = 1; Iterator < Sequence.size(); Iterator += 1){
+                    std::uint16_t Next = 0;
+                    for(const auto &Child : Nodes[Current].Children)
+                        if(Child.first == Sequence[Iterator]){
+                            Next = Child.second;
+                            break;
+                        }
+                    if(Next == 0){
+                        Next = static_cast<std::uint16_t>(Nodes.size());
+                        Nodes.emplace_back();
+                        Nodes[Current].Children.emplace_back(Sequence[Iterator], Next);
+                    }
+                    Current = Next;
+                }
+                Nodes[Current].Terminals |= Bit(OpenerLocal);
+            }
+
+            // ! Set of the openers that are a prefix of Input
+            Set Match(std::string_view Input) const{
+                if(Input.empty())
+                    return 0;
+                std::uint16_t Current = RootChildren[static_cast<unsigned char>(Input[0])];
+                Set Result = 0;
+                for(size_t Iterator = 1; Current != 0; Iterator += 1){
+                    Result |= Nodes[Current].Terminals;
+                    if(Iterator >= Input.size())
+                        break;
+                    std::uint16_t Next = 0;
+                    for(const auto &Child : Nodes[Current].Children)
+                        if(Child.first == Input[Iterator]){
+                            Next = Child.second;
+                            break;
+                        }
+                    Current = Next;
+                }
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_OPENER_MATCHER_HXX
\ No newline at end of file
@@ -0,0 +1,96 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_OUTPUT_SINK_HXX
+#define SYDONIA_OUTPUT_SINK_HXX
+
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Sydonia{
+    // ! Contiguous append buffer the renderer writes through, it either grows
+    // ! a caller supplied string or batches writes for an output stream
+    class OutputSink{
+        static constexpr size_t StreamChunkSize {16384};
+
+        std::string StreamBuffer;
+        std::string* Buffer;
+        std::ostream* Stream {nullptr};
+        size_t Written {0};
+
+        public:
+            explicit OutputSink(std::string &Target): Buffer(&Target){}
+
+            explicit OutputSink(std::ostream &StreamLocal): Buffer(&StreamBuffer), Stream(&StreamLocal){
+                StreamBuffer.reserve(StreamChunkSize);
+            }
+
+            OutputSink(const OutputSink&) = delete;
+            OutputSink &operator=(const OutputSink&) = delete;
+
+            ~OutputSink(){
+                Flush();
+            }
+
+            // ! Hint that about Size more bytes are going to be written
+            void Reserve(size_t Size){
+                if(!Stream)
+                    Buffer->reserve(Buffer->size() + Size);
+            }
+
+            void Write(const char* Data, size_t Length){
+                Written += Length;
+                if(Stream && Buffer->size() + Length > StreamChunkSize){
+                    Flush();
+                    if(Length > StreamChunkSize){
+                        Stream->write(Data, Length);
+                        return;
+                    }
+                }
+                Buffer->append(Data, Length);
+            }
+
+            void Write(std::string_view Text){
+                Write(Text.data(), Text.size());
+            }
+
+            // ! Integers are formatted without going through the stream locale
+            void WriteInteger(std::int64_t Value){
+                char Digits[24];
+                const auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+                Write(Digits, Result.ptr - Digits);
+            }
+
+            void WriteUnsigned(std::uint64_t Value){
+                char Digits[24];
+                const auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+                Write(Digits, Result.ptr - Digits);
+            }
+
+            // ! Number of bytes written through this sink
+            size_t Size() const{
+                return Written;
+            }
+
+            void Flush(){
+                if(Stream && !Buffer->empty()){
+                    Stream->write(Buffer->data(), Buffer->size());
+                    Buffer->clear();
+                }
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_OUTPUT_SINK_HXX
\ No newline at end of file
@@ -19,10 +19,13 @@
 #include <utility>
 #include <vector>
 
+#include "Compiler.hxx"
 #include "Configuration.hxx"
+#include "ConstantFolder.hxx"
 #include "Exceptions.hxx"
 #include "FunctionStorage.hxx"
 #include "Lexer.hxx"
+#include "Literals.hxx"
 #include "Node.hxx"
 #include "Template.hxx"
 #include "Token.hxx"
@@ -33,23 +36,129 @@ namespace Sydonia{
     class Parser{
         const ParserConfiguration &ParserConfigurationInstance;
         Lexer LexerInstance;
+        // ! Templates this parse discovered, those of SharedTemplates are only read
         TemplateStorage &TemplateStorageInstance;
+        const TemplateSnapshot* SharedTemplates;
         const FunctionStorage &FunctionStorageInstance;
         Token TokenInstance, PeekToken;
         bool HavePeekToken {false};
         size_t CurrentParenLevel {0};
-        size_t CurrentBracketLevel {0};
-        size_t CurrentBraceLevel {0};
+        Literals::Builder LiteralBuilder;
         std::string_view LiteralStart;
+        NodeArena* Arena {nullptr};
         BlockNode* CurrentBlock {nullptr};
         ExpressionListNode* CurrentExpressionList {nullptr};
         std::stack<std::pair<FunctionNode*, size_t>> FunctionStack;
-        std::vector<std::shared_ptr<ExpressionNode>> Arguments;
-        std::stack<std::shared_ptr<FunctionNode>> OperatorStack;
+        std::vector<ExpressionNode*> Arguments;
+        std::stack<FunctionNode*> OperatorStack;
         std::stack<IfStatementNode*> IfStatementStack;
         std::stack<ForStatementNode*> ForStatementStack;
         std::stack<BlockStatementNode*> BlockStatementStack;
 
+        // ! Root nodes of a previous parse that follow an edit, a reparse takes them
+        // ! over once it produces one of their text nodes at the shifted position
+        struct Splice{
+            std::vector<AstNode*> Nodes;
+            std::vector<std::pair<std::string, BlockStatementNode*>> Blocks;
+            size_t Next {0};
+            // ! First byte after the inserted text in the new content
+            size_t EditEnd {0};
+            std::ptrdiff_t Delta {0};
+        };
+        Splice* SpliceInstance {nullptr};
+
+        // ! Moves every node of a subtree by Delta bytes, the nodes are created
+        // ! mutable by the arena so dropping the visitor's const is fine
+        class PositionShifter : public NodeVisitor{
+            const std::ptrdiff_t Delta;
+
+            void Shift(const AstNode &Node){
+                const_cast<AstNode&>(Node).Position += Delta;
+            }
+
+            void Visit(const BlockNode &Node){
+                Shift(Node);
+                for(auto &SubNode : Node.Nodes)
+                    SubNode->Accept(*this);
+            }
+
+            void Visit(const TextNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ExpressionNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const LiteralNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const DataNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const FunctionNode &Node){
+                Shift(Node);
+                for(auto &SubNode : Node.Arguments)
+                    SubNode->Accept(*this);
+            }
+
+            void Visit(const ExpressionListNode &Node){
+                Shift(Node);
+                if(Node.Root)
+                    Node.Root->Accept(*this);
+            }
+
+            void Visit(const StatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ForStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ForArrayStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.Body.Accept(*this);
+            }
+
+            void Visit(const ForObjectStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.Body.Accept(*this);
+            }
+
+            void Visit(const IfStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.TrueStatement.Accept(*this);
+                Node.FalseStatement.Accept(*this);
+            }
+
+            void Visit(const IncludeStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ExtendsStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const BlockStatementNode &Node){
+                Shift(Node);
+                Node.Block.Accept(*this);
+            }
+
+            void Visit(const SetStatementNode &Node){
+                Shift(Node);
+                Node.Expression.Accept(*this);
+            }
+
+            public:
+                explicit PositionShifter(std::ptrdiff_t DeltaLocal): Delta(DeltaLocal){}
+        };
+
         inline void ThrowParserError(const std::string &Message) const{
             SYDONIA_THROW(ParserError(Message, LexerInstance.CurrentPosition()));
         }
@@ -69,9 +178,78 @@ namespace Sydonia{
             }
         }
 
-        inline void AddLiteral(const char* ContentPointer){
-            std::string_view DataText(LiteralStart.data(), TokenInstance.Text.data() - LiteralStart.data() + TokenInstance.Text.size());
-            Arguments.emplace_back(std::make_shared<LiteralNode>(DataText, DataText.data() - ContentPointer));
+        template<typename NodeType, typename... Parameters>
+        inline NodeType* CreateNode(Parameters&&... ParametersLocal){
+            return Arena->Create<NodeType>(std::forward<Parameters>(ParametersLocal)...);
+        }
+
+        inline void AddLiteral(JSON &&Value, std::string_view Start, const char* ContentPointer){
+            Arguments.emplace_back(CreateNode<LiteralNode>(std::move(Value), Start.data() - ContentPointer));
+        }
+
+        // ! Value of a string, number or constant token, false for any other token
+        bool DecodeLiteral(JSON &Value){
+            switch(TokenInstance.KindInstance){
+                case Token::Kind::String: {
+                    std::string Text;
+                    if(!Literals::DecodeString(TokenInstance.Text, Text))
+                        ThrowParserError("Invalid string literal " + static_cast<std::string>(TokenInstance.Text));
+                    Value = std::move(Text);
+                } return true;
+                case Token::Kind::Number: {
+                    if(!Literals::DecodeNumber(TokenInstance.Text, Value))
+                        ThrowParserError("Invalid number literal '" + static_cast<std::string>(TokenInstance.Text) + "'");
+                } return true;
+                case Token::Kind::Id: {
+                    switch(TokenInstance.KeywordInstance){
+                        case Token::Keyword::True:
+                            Value = true;
+                            return true;
+                        case Token::Keyword::False:
+                            Value = false;
+                            return true;
+                        case Token::Keyword::Null:
+                            Value = nullptr;
+                            return true;
+                        default:
+                            return false;
+                    }
+                }
+                default:
+                    return false;
+            }
+        }
+
+        // ! Feeds a token inside an array or object literal to the builder, the
+        // ! literal is added once its outermost bracket is closed
+        void ParseLiteralToken(Template &TemplateLocal){
+            JSON Value;
+            bool Valid = true;
+            switch(TokenInstance.KindInstance){
+                case Token::Kind::LeftBracket:
+                case Token::Kind::LeftBrace:
+                    Valid = LiteralBuilder.Open(TokenInstance.KindInstance == Token::Kind::LeftBrace);
+                    break;
+                case Token::Kind::RightBracket:
+                case Token::Kind::RightBrace: {
+                    Valid = LiteralBuilder.Close(TokenInstance.KindInstance == Token::Kind::RightBrace, Value);
+                    if(Valid && LiteralBuilder.Depth() == 0)
+                        AddLiteral(std::move(Value), LiteralStart, TemplateLocal.Content.data());
+                } break;
+                case Token::Kind::Comma:
+                    Valid = LiteralBuilder.Comma();
+                    break;
+                case Token::Kind::Colon:
+                    Valid = LiteralBuilder.Colon();
+                    break;
+                default: {
+                    if(!DecodeLiteral(Value))
+                        ThrowParserError("Unexpected '" + TokenInstance.Describe() + "' in literal");
+                    Valid = LiteralBuilder.Add(std::move(Value));
+                } break;
+            }
+            if(!Valid)
+                ThrowParserError("Malformed literal");
         }
 
         inline void AddOperator(){
@@ -84,8 +262,16 @@ namespace Sydonia{
             Arguments.emplace_back(Function);
         }
 
+        std::shared_ptr<const TemplateSource> OpenFile(const std::string &Filename) const{
+            return ParserConfigurationInstance.MapTemplateFiles ? TemplateSource::Map(Filename) : TemplateSource::Read(Filename);
+        }
+
+        bool IsKnownTemplate(const std::string &TemplateName) const{
+            return TemplateLookup(TemplateStorageInstance, SharedTemplates).Find(TemplateName) != nullptr;
+        }
+
         void AddToTemplateStorage(std::string_view Path, std::string &TemplateName){
-            if(TemplateStorageInstance.find(TemplateName) != TemplateStorageInstance.end())
+            if(IsKnownTemplate(TemplateName))
                 return;
             std::string OriginalPath = static_cast<std::string>(Path);
             std::string OriginalName = TemplateName;
@@ -94,15 +280,12 @@ namespace Sydonia{
                 TemplateName = OriginalPath + OriginalName;
                 if(TemplateName.compare(0, 2, "./") == 0)
                     TemplateName.erase(0, 2);
-                if(TemplateStorageInstance.find(TemplateName) == TemplateStorageInstance.end()){
+                if(!IsKnownTemplate(TemplateName)){
                     // ! Load file
-                    std::ifstream File;
-                    File.open(TemplateName);
-                    if(!File.fail()){
-                        std::string Text((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
-                        auto IncludeTemplate = Template(Text);
+                    if(auto Source = OpenFile(TemplateName)){
+                        auto IncludeTemplate = std::make_shared<Template>(std::move(Source));
                         TemplateStorageInstance.emplace(TemplateName, IncludeTemplate);
-                        ParseIntoTemplate(TemplateStorageInstance[TemplateName], TemplateName);
+                        ParseIntoTemplate(*IncludeTemplate, TemplateName);
                         return;
                     }else if(!ParserConfigurationInstance.IncludeCallback)
                         SYDONIA_THROW(FileError("Failed accessing file at '" + TemplateName + "'"));
@@ -112,7 +295,7 @@ namespace Sydonia{
             // ! Try include callback
             if(ParserConfigurationInstance.IncludeCallback){
                 auto IncludeTemplate = ParserConfigurationInstance.IncludeCallback(OriginalPath, OriginalName);
-                TemplateStorageInstance.emplace(TemplateName, IncludeTemplate);
+                TemplateStorageInstance.emplace(TemplateName, std::make_shared<const Template>(std::move(IncludeTemplate)));
             }
         }
 
@@ -126,65 +309,60 @@ namespace Sydonia{
         }
 
         bool ParseExpression(Template &TemplateLocal, Token::Kind Closing){
+            // ! Nesting left open by a malformed expression must not leak into this one
+            CurrentParenLevel = 0;
+            LiteralBuilder.Clear();
+            FunctionStack = {};
+            OperatorStack = {};
+            Arguments.clear();
             while(TokenInstance.KindInstance != Closing && TokenInstance.KindInstance != Token::Kind::Eof){
+                if(LiteralBuilder.Depth() != 0){
+                    ParseLiteralToken(TemplateLocal);
+                    GetNextToken();
+                    continue;
+                }
                 // ! Literals
                 switch(TokenInstance.KindInstance){
-                    case Token::Kind::String: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            LiteralStart = TokenInstance.Text;
-                            AddLiteral(TemplateLocal.Content.c_str());
-                        }
-                    } break;
+                    case Token::Kind::String:
                     case Token::Kind::Number: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            LiteralStart = TokenInstance.Text;
-                            AddLiteral(TemplateLocal.Content.c_str());
-                        }
-                    } break;
-                    case Token::Kind::LeftBracket: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            LiteralStart = TokenInstance.Text;
-                        CurrentBracketLevel += 1;
+                        JSON Value;
+                        DecodeLiteral(Value);
+                        AddLiteral(std::move(Value), TokenInstance.Text, TemplateLocal.Content.data());
                     } break;
+                    case Token::Kind::LeftBracket:
                     case Token::Kind::LeftBrace: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            LiteralStart = TokenInstance.Text;
-                        CurrentBraceLevel += 1;
+                        LiteralStart = TokenInstance.Text;
+                        LiteralBuilder.Open(TokenInstance.KindInstance == Token::Kind::LeftBrace);
                     } break;
                     case Token::Kind::RightBracket: {
-                        if(CurrentBracketLevel == 0)
-                            ThrowParserError("Unexpected ']'");
-                        CurrentBracketLevel -= 1;
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            AddLiteral(TemplateLocal.Content.c_str());
+                        ThrowParserError("Unexpected ']'");
                     } break;
                     case Token::Kind::RightBrace: {
-                        if(CurrentBraceLevel == 0)
-                            ThrowParserError("Unexpected '}'");
-                        CurrentBraceLevel -= 1;
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            AddLiteral(TemplateLocal.Content.c_str());
+                        ThrowParserError("Unexpected '}'");
                     } break;
                     case Token::Kind::Id: {
                         GetPeekToken();
+                        JSON Value;
                         // ! Data literal
-                        if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("True") || TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("False") ||
-                            TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("NULL")){
-                                if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                                    LiteralStart = TokenInstance.Text;
-                                    AddLiteral(TemplateLocal.Content.c_str());
-                                }
-                            }
+                        if(DecodeLiteral(Value))
+                            AddLiteral(std::move(Value), TokenInstance.Text, TemplateLocal.Content.data());
                         // ! Operator
-                        else if(TokenInstance.Text == "And" || TokenInstance.Text == "Or" || TokenInstance.Text == "In" || TokenInstance.Text == "Not")
+                        else if(TokenInstance.KeywordInstance == Token::Keyword::And || TokenInstance.KeywordInstance == Token::Keyword::Or ||
+                            TokenInstance.KeywordInstance == Token::Keyword::In || TokenInstance.KeywordInstance == Token::Keyword::Not)
                             goto ParseOperator;
                         // ! Functions
                         else if(PeekToken.KindInstance == Token::Kind::LeftParen){
-                            OperatorStack.emplace(std::make_shared<FunctionNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                            FunctionStack.emplace(OperatorStack.top().get(), CurrentParenLevel);
+                            OperatorStack.emplace(CreateNode<FunctionNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                            FunctionStack.emplace(OperatorStack.top(), CurrentParenLevel);
                         // ! Variables
-                        }else
-                            Arguments.emplace_back(std::make_shared<DataNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
+                        }else{
+                            auto Data = CreateNode<DataNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.data());
+                            // ! Bound now so a missing variable is not looked up on every render
+                            const auto &FunctionData = FunctionStorageInstance.FindFunction(TokenInstance.Text, 0);
+                            if(FunctionData.OperationInstance == FunctionStorage::Operation::Callback)
+                                Data->Callback = FunctionData.Callback;
+                            Arguments.emplace_back(Data);
+                        }
                     // ! Operators
                     } break;
                     case Token::Kind::Equal:
@@ -204,16 +382,22 @@ namespace Sydonia{
                             FunctionStorage::Operation OperationInstance;
                             switch(TokenInstance.KindInstance){
                                 case Token::Kind::Id: {
-                                    if(TokenInstance.Text == "And")
-                                        OperationInstance = FunctionStorage::Operation::And;
-                                    else if(TokenInstance.Text == "Or")
-                                        OperationInstance = FunctionStorage::Operation::Or;
-                                    else if(TokenInstance.Text == "In")
-                                        OperationInstance = FunctionStorage::Operation::In;
-                                    else if(TokenInstance.Text == "Not")
-                                        OperationInstance = FunctionStorage::Operation::Not;
-                                    else
-                                        ThrowParserError("Unknown operator in parser.");
+                                    switch(TokenInstance.KeywordInstance){
+                                        case Token::Keyword::And:
+                                            OperationInstance = FunctionStorage::Operation::And;
+                                            break;
+                                        case Token::Keyword::Or:
+                                            OperationInstance = FunctionStorage::Operation::Or;
+                                            break;
+                                        case Token::Keyword::In:
+                                            OperationInstance = FunctionStorage::Operation::In;
+                                            break;
+                                        case Token::Keyword::Not:
+                                            OperationInstance = FunctionStorage::Operation::Not;
+                                            break;
+                                        default:
+                                            ThrowParserError("Unknown operator in parser.");
+                                    }
                                 } break;
                                 case Token::Kind::Equal: {
                                     OperationInstance = FunctionStorage::Operation::Equal;
@@ -258,7 +442,7 @@ namespace Sydonia{
                                     ThrowParserError("Unknown operator in parser.");
                                 }
                             }
-                            auto FunctionNodeInstance = std::make_shared<FunctionNode>(OperationInstance, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
+                            auto FunctionNodeInstance = CreateNode<FunctionNode>(OperationInstance, TokenInstance.Text.data() - TemplateLocal.Content.data());
                             while(!OperatorStack.empty() &&
                                 ((OperatorStack.top()->Precedence > FunctionNodeInstance->Precedence) ||
                                 (OperatorStack.top()->Precedence == FunctionNodeInstance->Precedence && FunctionNodeInstance->AssociativityInstance == FunctionNode::Associativity::Left)) && 
@@ -268,19 +452,16 @@ namespace Sydonia{
                             OperatorStack.emplace(FunctionNodeInstance);
                     } break;
                     case Token::Kind::Comma: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            if(FunctionStack.empty())
-                                ThrowParserError("Unexpected ','");
-                            FunctionStack.top().first->NumberArgs += 1;
-                        }
+                        if(FunctionStack.empty())
+                            ThrowParserError("Unexpected ','");
+                        FunctionStack.top().first->NumberArgs += 1;
                     } break;
                     case Token::Kind::Colon: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            ThrowParserError("Unexpected ':'");
+                        ThrowParserError("Unexpected ':'");
                     } break;
                     case Token::Kind::LeftParen: {
                         CurrentParenLevel += 1;
-                        OperatorStack.emplace(std::make_shared<FunctionNode>(FunctionStorage::Operation::ParenLeft, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
+                        OperatorStack.emplace(CreateNode<FunctionNode>(FunctionStorage::Operation::ParenLeft, TokenInstance.Text.data() - TemplateLocal.Content.data()));
                         GetPeekToken();
                         if(PeekToken.KindInstance == Token::Kind::RightParen)
                             if(!FunctionStack.empty() && FunctionStack.top().second == CurrentParenLevel - 1)
@@ -294,7 +475,7 @@ namespace Sydonia{
                             OperatorStack.pop();
                         if(!FunctionStack.empty() && FunctionStack.top().second == CurrentParenLevel){
                             auto Function = FunctionStack.top().first;
-                            auto FunctionData = FunctionStorageInstance.FindFunction(Function->Name, Function->NumberArgs);
+                            const auto &FunctionData = FunctionStorageInstance.FindFunction(Function->Name, Function->NumberArgs);
                             if(FunctionData.OperationInstance == FunctionStorage::Operation::None)
                                 ThrowParserError("Unknown function " + Function->Name);
                             Function->OperationInstance = FunctionData.OperationInstance;
@@ -311,6 +492,8 @@ namespace Sydonia{
                 }
                 GetNextToken();
             }
+            if(LiteralBuilder.Depth() != 0)
+                ThrowParserError("Unclosed literal");
             while(!OperatorStack.empty())
                 AddOperator();
             if(Arguments.size() == 1){
@@ -321,137 +504,198 @@ namespace Sydonia{
             return true;
         }
 
+        // ! Whether the current block is a branch of an If, closing statements have
+        // ! to match the innermost open one so the root block is only reached once
+        // ! every statement is closed
+        bool IsBranchOf(const IfStatementNode* IfStatementNodeInstance) const{
+            return CurrentBlock == &IfStatementNodeInstance->TrueStatement || CurrentBlock == &IfStatementNodeInstance->FalseStatement;
+        }
+
         bool ParseStatement(Template &TemplateLocal, Token::Kind Closing, std::string_view Path){
             if(TokenInstance.KindInstance != Token::Kind::Id)
                 return false;
-            if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("If")){
-                GetNextToken();
-                auto IfStatementNodeInstance = std::make_shared<IfStatementNode>(CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
-                IfStatementStack.emplace(IfStatementNodeInstance.get());
-                CurrentBlock = &IfStatementNodeInstance->TrueStatement;
-                CurrentExpressionList = &IfStatementNodeInstance->Condition;
-                if(!ParseExpression(TemplateLocal, Closing))
-                    return false;
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Else")){
-                if(IfStatementStack.empty())
-                    ThrowParserError("Else without matching If");
-                auto &IfStatementData = IfStatementStack.top();
-                GetNextToken();
-                IfStatementData->HasFalseStatement = true;
-                CurrentBlock = &IfStatementData->FalseStatement;
-                // ! Chained Else If
-                if(TokenInstance.KindInstance == Token::Kind::Id && TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("If")){
+            switch(TokenInstance.KeywordInstance){
+                case Token::Keyword::If: {
                     GetNextToken();
-                    auto IfStatementNodeInstance = std::make_shared<IfStatementNode>(true, CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
+                    auto IfStatementNodeInstance = CreateNode<IfStatementNode>(CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
                     CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
-                    IfStatementStack.emplace(IfStatementNodeInstance.get());
+                    IfStatementStack.emplace(IfStatementNodeInstance);
                     CurrentBlock = &IfStatementNodeInstance->TrueStatement;
                     CurrentExpressionList = &IfStatementNodeInstance->Condition;
                     if(!ParseExpression(TemplateLocal, Closing))
                         return false;
-                }
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndIf")){
-                if(IfStatementStack.empty())
-                    ThrowParserError("EndIf without matching If");
-                // ! Nested if statements
-                while(IfStatementStack.top()->IsNested)
+                } break;
+                case Token::Keyword::Else: {
+                    if(IfStatementStack.empty() || !IsBranchOf(IfStatementStack.top()))
+                        ThrowParserError("Else without matching If");
+                    auto &IfStatementData = IfStatementStack.top();
+                    GetNextToken();
+                    IfStatementData->HasFalseStatement = true;
+                    CurrentBlock = &IfStatementData->FalseStatement;
+                    // ! Chained Else If
+                    if(TokenInstance.Is(Token::Keyword::If)){
+                        GetNextToken();
+                        auto IfStatementNodeInstance = CreateNode<IfStatementNode>(true, CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
+                        IfStatementStack.emplace(IfStatementNodeInstance);
+                        CurrentBlock = &IfStatementNodeInstance->TrueStatement;
+                        CurrentExpressionList = &IfStatementNodeInstance->Condition;
+                        if(!ParseExpression(TemplateLocal, Closing))
+                            return false;
+                    }
+                } break;
+                case Token::Keyword::EndIf: {
+                    if(IfStatementStack.empty() || !IsBranchOf(IfStatementStack.top()))
+                        ThrowParserError("EndIf without matching If");
+                    // ! Nested if statements
+                    while(IfStatementStack.top()->IsNested)
+                        IfStatementStack.pop();
+                    auto &IfStatementData = IfStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = IfStatementData->Parent;
                     IfStatementStack.pop();
-                auto &IfStatementData = IfStatementStack.top();
-                GetNextToken();
-                CurrentBlock = IfStatementData->Parent;
-                IfStatementStack.pop();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Block")){
-                GetNextToken();
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected block name, got '" + TokenInstance.Describe() + "'");
-                const std::string BlockName = static_cast<std::string>(TokenInstance.Text);
-                auto BlockStatementNodeInstance = std::make_shared<BlockStatementNode>(CurrentBlock, BlockName, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(BlockStatementNodeInstance);
-                BlockStatementStack.emplace(BlockStatementNodeInstance.get());
-                CurrentBlock = &BlockStatementNodeInstance->Block;
-                auto Success = TemplateLocal.BlockStorage.emplace(BlockName, BlockStatementNodeInstance);
-                if(!Success.second)
-                    ThrowParserError("Block with the name '" + BlockName + "' does already exists");
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndBlock")){
-                if(BlockStatementStack.empty())
-                    ThrowParserError("EndBlock without matching block");
-                auto &BlockStatementData = BlockStatementStack.top();
-                GetNextToken();
-                CurrentBlock = BlockStatementData->Parent;
-                BlockStatementStack.top();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("For")){
-                GetNextToken();
-                // ! Options: For X, Y In Obj
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
-                Token ValueToken = TokenInstance;
-                GetNextToken();
-                // ! Object type
-                std::shared_ptr<ForStatementNode> ForStatementNodeInstance;
-                if(TokenInstance.KindInstance == Token::Kind::Comma){
+                } break;
+                case Token::Keyword::Block: {
+                    GetNextToken();
+                    if(TokenInstance.KindInstance != Token::Kind::Id)
+                        ThrowParserError("Expected block name, got '" + TokenInstance.Describe() + "'");
+                    const std::string BlockName = static_cast<std::string>(TokenInstance.Text);
+                    auto BlockStatementNodeInstance = CreateNode<BlockStatementNode>(CurrentBlock, BlockName, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                    CurrentBlock->Nodes.emplace_back(BlockStatementNodeInstance);
+                    BlockStatementStack.emplace(BlockStatementNodeInstance);
+                    CurrentBlock = &BlockStatementNodeInstance->Block;
+                    auto Success = TemplateLocal.BlockStorage.emplace(BlockName, BlockStatementNodeInstance);
+                    if(!Success.second)
+                        ThrowParserError("Block with the name '" + BlockName + "' does already exists");
+                    GetNextToken();
+                } break;
+                case Token::Keyword::EndBlock: {
+                    if(BlockStatementStack.empty() || CurrentBlock != &BlockStatementStack.top()->Block)
+                        ThrowParserError("EndBlock without matching block");
+                    auto &BlockStatementData = BlockStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = BlockStatementData->Parent;
+                    BlockStatementStack.pop();
+                } break;
+                case Token::Keyword::For: {
                     GetNextToken();
+                    // ! Options: For X, Y In Obj
                     if(TokenInstance.KindInstance != Token::Kind::Id)
                         ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
-                    Token KeyToken = std::move(ValueToken);
-                    ValueToken = TokenInstance;
+                    Token ValueToken = TokenInstance;
                     GetNextToken();
-                    ForStatementNodeInstance = std::make_shared<ForObjectStatementNode>(static_cast<std::string>(KeyToken.Text), static_cast<std::string>(ValueToken.Text),
-                                                                                        CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                    // ! Array type
-                }else{
-                    ForStatementNodeInstance = std::make_shared<ForArrayStatementNode>(static_cast<std::string>(ValueToken.Text), CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                    CurrentBlock->Nodes.emplace_back(ForStatementNodeInstance);
-                    ForStatementStack.emplace(ForStatementNodeInstance.get());
-                    CurrentBlock = &ForStatementNodeInstance->Body;
-                    CurrentExpressionList = &ForStatementNodeInstance->Condition;
-                    if(TokenInstance.KindInstance != Token::Kind::Id || TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("In"))
-                        ThrowParserError("Expected 'In', got '" + TokenInstance.Describe() + "'");
+                    // ! Object type
+                    ForStatementNode* ForStatementNodeInstance;
+                    if(TokenInstance.KindInstance == Token::Kind::Comma){
+                        GetNextToken();
+                        if(TokenInstance.KindInstance != Token::Kind::Id)
+                            ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
+                        Token KeyToken = std::move(ValueToken);
+                        ValueToken = TokenInstance;
+                        GetNextToken();
+                        ForStatementNodeInstance = CreateNode<ForObjectStatementNode>(static_cast<std::string>(KeyToken.Text), static_cast<std::string>(ValueToken.Text),
+                                                                                            CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        // ! Array type
+                    }else{
+                        ForStatementNodeInstance = CreateNode<ForArrayStatementNode>(static_cast<std::string>(ValueToken.Text), CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        CurrentBlock->Nodes.emplace_back(ForStatementNodeInstance);
+                        ForStatementStack.emplace(ForStatementNodeInstance);
+                        CurrentBlock = &ForStatementNodeInstance->Body;
+                        CurrentExpressionList = &ForStatementNodeInstance->Condition;
+                        if(!TokenInstance.Is(Token::Keyword::In))
+                            ThrowParserError("Expected 'In', got '" + TokenInstance.Describe() + "'");
+                        GetNextToken();
+                        if(!ParseExpression(TemplateLocal, Closing))
+                            return false;
+                    }
+                } break;
+                case Token::Keyword::EndFor: {
+                    if(ForStatementStack.empty() || CurrentBlock != &ForStatementStack.top()->Body)
+                        ThrowParserError("EndFor without matching For");
+                    auto &ForStatementData = ForStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = ForStatementData->Parent;
+                    ForStatementStack.pop();
+                } break;
+                case Token::Keyword::Include: {
+                    GetNextToken();
+                    std::string TemplateName = ParseFilename(TokenInstance);
+                    AddToTemplateStorage(Path, TemplateName);
+                    CurrentBlock->Nodes.emplace_back(CreateNode<IncludeStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                    GetNextToken();
+                } break;
+                case Token::Keyword::Extends: {
+                    GetNextToken();
+                    std::string TemplateName = ParseFilename(TokenInstance);
+                    AddToTemplateStorage(Path, TemplateName);
+                    CurrentBlock->Nodes.emplace_back(CreateNode<ExtendsStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                    GetNextToken();
+                } break;
+                case Token::Keyword::Set: {
+                    GetNextToken();
+                    if(TokenInstance.KindInstance != Token::Kind::Id)
+                        ThrowParserError("Expected variable name, got '" + TokenInstance.Describe() + "'");
+                    std::string Key = static_cast<std::string>(TokenInstance.Text);
+                    GetNextToken();
+                    auto SetStatementNodeInstance = CreateNode<SetStatementNode>(Key, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                    CurrentBlock->Nodes.emplace_back(SetStatementNodeInstance);
+                    CurrentExpressionList = &SetStatementNodeInstance->Expression;
+                    if(TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("="))
+                        ThrowParserError("Expected '=', got '" + TokenInstance.Describe() + "'");
                     GetNextToken();
                     if(!ParseExpression(TemplateLocal, Closing))
                         return false;
-                }
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndFor")){
-                if(ForStatementStack.empty())
-                    ThrowParserError("EndFor without matching For");
-                auto &ForStatementData = ForStatementStack.top();
-                GetNextToken();
-                CurrentBlock = ForStatementData->Parent;
-                ForStatementStack.pop();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Include")){
-                GetNextToken();
-                std::string TemplateName = ParseFilename(TokenInstance);
-                AddToTemplateStorage(Path, TemplateName);
-                CurrentBlock->Nodes.emplace_back(std::make_shared<IncludeStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Extends")){
-                GetNextToken();
-                std::string TemplateName = ParseFilename(TokenInstance);
-                AddToTemplateStorage(Path, TemplateName);
-                CurrentBlock->Nodes.emplace_back(std::make_shared<ExtendsStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Set")){
-                GetNextToken();
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected variable name, got '" + TokenInstance.Describe() + "'");
-                std::string Key = static_cast<std::string>(TokenInstance.Text);
-                GetNextToken();
-                auto SetStatementNodeInstance = std::make_shared<SetStatementNode>(Key, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(SetStatementNodeInstance);
-                CurrentExpressionList = &SetStatementNodeInstance->Expression;
-                if(TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("="))
-                    ThrowParserError("Expected '=', got '" + TokenInstance.Describe() + "'");
-                GetNextToken();
-                if(!ParseExpression(TemplateLocal, Closing))
+                } break;
+                default:
                     return false;
-            }else
+            }
+            return true;
+        }
+
+        // ! Appends the spliced nodes to the root once the text node just lexed is
+        // ! one of them, the rest of the content is then known to parse the same
+        bool TakeSplice(Template &TemplateLocal, size_t TextPosition, size_t Length){
+            Splice &SpliceLocal = *SpliceInstance;
+            if(TextPosition < SpliceLocal.EditEnd)
+                return false;
+            const size_t PreviousPosition = static_cast<size_t>(static_cast<std::ptrdiff_t>(TextPosition) - SpliceLocal.Delta);
+            while(SpliceLocal.Next < SpliceLocal.Nodes.size() && SpliceLocal.Nodes[SpliceLocal.Next]->Position < PreviousPosition)
+                SpliceLocal.Next += 1;
+            if(SpliceLocal.Next == SpliceLocal.Nodes.size())
                 return false;
+            const auto TextNodeInstance = dynamic_cast<const TextNode*>(SpliceLocal.Nodes[SpliceLocal.Next]);
+            if(!TextNodeInstance || TextNodeInstance->Position != PreviousPosition || TextNodeInstance->Length != Length)
+                return false;
+            // ! A block name taken by the new nodes is reported by the regular parse
+            for(const auto &Block : SpliceLocal.Blocks)
+                if(Block.second->Position >= PreviousPosition && TemplateLocal.BlockStorage.count(Block.first))
+                    return false;
+            for(const auto &Block : SpliceLocal.Blocks)
+                if(Block.second->Position >= PreviousPosition)
+                    TemplateLocal.BlockStorage.emplace(Block.first, Block.second);
+            PositionShifter Shifter(SpliceLocal.Delta);
+            for(size_t Iterator = SpliceLocal.Next; Iterator < SpliceLocal.Nodes.size(); Iterator += 1){
+                SpliceLocal.Nodes[Iterator]->Accept(Shifter);
+                TemplateLocal.Root.Nodes.emplace_back(SpliceLocal.Nodes[Iterator]);
+            }
             return true;
         }
 
-        void ParseInto(Template &TemplateLocal, std::string_view Path){
-            LexerInstance.Start(TemplateLocal.Content);
+        void FinishTemplate(Template &TemplateLocal){
+            if(!SpliceInstance)
+                TemplateLocal.ParsedNodeCount = Arena->Size();
+            TemplateLocal.InvariantData = ParserConfigurationInstance.InvariantData;
+            if(ParserConfigurationInstance.FoldConstants){
+                ConstantFolder Folder(TemplateLookup(TemplateStorageInstance, SharedTemplates), FunctionStorageInstance, TemplateLocal.InvariantData);
+                TemplateLocal.ProgramInstance = Compiler(&Folder).Compile(TemplateLocal);
+            }else
+                TemplateLocal.ProgramInstance = Compiler().Compile(TemplateLocal);
+            TemplateLocal.EstimateOutputSize();
+        }
+
+        void ParseInto(Template &TemplateLocal, std::string_view Path, size_t Offset = 0){
+            LexerInstance.Start(TemplateLocal.Content, Offset);
+            Arena = TemplateLocal.Arena.get();
             CurrentBlock = &TemplateLocal.Root;
             for(;;){
                 GetNextToken();
@@ -461,9 +705,17 @@ namespace Sydonia{
                             ThrowParserError("Unmatched If");
                         if(!ForStatementStack.empty())
                             ThrowParserError("Unmatched For");
+                        if(!BlockStatementStack.empty())
+                            ThrowParserError("Unmatched Block");
+                        FinishTemplate(TemplateLocal);
                     } return;
                     case Token::Kind::Text: {
-                        CurrentBlock->Nodes.emplace_back(std::make_shared<TextNode>(TokenInstance.Text.data() - TemplateLocal.Content.c_str(), TokenInstance.Text.size()));
+                        const size_t TextPosition = TokenInstance.Text.data() - TemplateLocal.Content.data();
+                        if(SpliceInstance && CurrentBlock == &TemplateLocal.Root && TakeSplice(TemplateLocal, TextPosition, TokenInstance.Text.size())){
+                                FinishTemplate(TemplateLocal);
+                                return;
+                            }
+                        CurrentBlock->Nodes.emplace_back(CreateNode<TextNode>(TextPosition, TokenInstance.Text.size()));
                     } break;
                     case Token::Kind::StatementOpen: {
                         GetNextToken();
@@ -481,9 +733,9 @@ namespace Sydonia{
                     } break;
                     case Token::Kind::ExpressionOpen: {
                         GetNextToken();
-                        auto ExpressionListNodeInstance = std::make_shared<ExpressionListNode>(TokenInstance.Text.data() - TemplateLocal.Content.c_str());
+                        auto ExpressionListNodeInstance = CreateNode<ExpressionListNode>(TokenInstance.Text.data() - TemplateLocal.Content.data());
                         CurrentBlock->Nodes.emplace_back(ExpressionListNodeInstance);
-                        CurrentExpressionList = ExpressionListNodeInstance.get();
+                        CurrentExpressionList = ExpressionListNodeInstance;
                         if(!ParseExpression(TemplateLocal, Token::Kind::ExpressionClose))
                             ThrowParserError("Expected expression, got '" + TokenInstance.Describe() + "'");
                         if(TokenInstance.KindInstance != Token::Kind::ExpressionClose)
@@ -502,9 +754,12 @@ namespace Sydonia{
         }
         
         public:
+            // ! Includes are looked up in SharedTemplatesLocal too, the new ones are
+            // ! added to TemplateStorageLocal
             explicit Parser(const ParserConfiguration &ParserConfigurationLocal, const LexerConfiguration &LexerConfigurationLocal,
-                            TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
-                : ParserConfigurationInstance(ParserConfigurationLocal), LexerInstance(LexerConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal){}
+                            TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal, const TemplateSnapshot* SharedTemplatesLocal = nullptr)
+                : ParserConfigurationInstance(ParserConfigurationLocal), LexerInstance(LexerConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal),
+                  SharedTemplates(SharedTemplatesLocal), FunctionStorageInstance(FunctionStorageLocal){}
             
             Template Parse(std::string_view Input, std::string_view Path){
                 auto Result = Template(static_cast<std::string>(Input));
@@ -516,21 +771,84 @@ namespace Sydonia{
                 return Parse(Input, "./");
             }
 
+            // ! Parses a piece of a template that starts at Offset of Input, the
+            // ! content is moved into the template instead of being copied
+            Template Parse(std::string Input, size_t Offset, std::string_view Path){
+                Template Result(std::move(Input));
+                ParseInto(Result, Path, Offset);
+                return Result;
+            }
+
+            // ! Parses the content of Previous with Edit applied, only the root nodes
+            // ! around the edit are parsed again, the nodes before it are shared and
+            // ! the ones after it are moved over, so Previous must not be used once
+            // ! this returns, it is left as it was when parsing fails
+            Template Reparse(Template &Previous, const TemplateEdit &Edit, std::string_view Path){
+                if(Edit.Offset > Previous.Content.size() || Edit.Length > Previous.Content.size() - Edit.Offset)
+                    SYDONIA_THROW(ParserError("Edit exceeds the template content", GetSourceLocation(Previous.Content, Previous.Content.size())));
+                std::string Content;
+                Content.reserve(Previous.Content.size() - Edit.Length + Edit.Text.size());
+                Content.append(Previous.Content.substr(0, Edit.Offset)).append(Edit.Text).append(Previous.Content.substr(Edit.Offset + Edit.Length));
+                // ! Copies of the template share its nodes, and the replaced nodes of
+                // ! earlier reparses pile up in the arena
+                if(Previous.Arena.use_count() != 1 || Previous.Arena->Size() > 2 * Previous.ParsedNodeCount + 1024)
+                    return Parse(Content, Path);
+
+                // ! Restart at the last root text node before the edit, the lexer and
+                // ! the parser are in their initial state there
+                const auto &Nodes = Previous.Root.Nodes;
+                size_t Restart = 0, RestartPosition = 0;
+                for(size_t Iterator = 0; Iterator < Nodes.size() && Nodes[Iterator]->Position < Edit.Offset; Iterator += 1)
+                    if(dynamic_cast<const TextNode*>(Nodes[Iterator])){
+                        Restart = Iterator;
+                        RestartPosition = Nodes[Iterator]->Position;
+                    }
+
+                Template Result(std::move(Content));
+                Result.Arena = Previous.Arena;
+                Result.ParsedNodeCount = Previous.ParsedNodeCount;
+                Result.Root.Nodes.assign(Nodes.begin(), Nodes.begin() + Restart);
+                Splice SpliceLocal;
+                SpliceLocal.Nodes.assign(Nodes.begin() + Restart, Nodes.end());
+                SpliceLocal.EditEnd = Edit.Offset + Edit.Text.size();
+                SpliceLocal.Delta = static_cast<std::ptrdiff_t>(Edit.Text.size()) - static_cast<std::ptrdiff_t>(Edit.Length);
+                for(const auto &Block : Previous.BlockStorage)
+                    if(Block.second->Position < RestartPosition)
+                        Result.BlockStorage.emplace(Block);
+                    else
+                        SpliceLocal.Blocks.emplace_back(Block);
+
+                SpliceInstance = &SpliceLocal;
+                ParseInto(Result, Path, RestartPosition);
+                SpliceInstance = nullptr;
+                return Result;
+            }
+
+            Template Reparse(Template &Previous, const TemplateEdit &Edit){
+                return Reparse(Previous, Edit, "./");
+            }
+
             void ParseIntoTemplate(Template &TemplateLocal, std::string_view Filename){
                 std::string_view Path = Filename.substr(0, Filename.find_last_of("/\\") + 1);
                 auto SubParser = Parser(ParserConfigurationInstance, LexerInstance.GetConfiguration(), 
-                                        TemplateStorageInstance, FunctionStorageInstance);
+                                        TemplateStorageInstance, FunctionStorageInstance, SharedTemplates);
                 SubParser.ParseInto(TemplateLocal, Path);
             }
 
             std::string LoadFile(const std::string &Filename){
-                std::ifstream File;
-                File.open(Filename);
-                if(File.fail())
+                std::string Text;
+                if(!ReadFile(Filename, Text))
                     SYDONIA_THROW(FileError("Failed accessing file at '" + Filename + "'"));
-                std::string Text((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
                 return Text;
             }
+
+            // ! Opens a template file the way the configuration asks for, mapped or copied
+            std::shared_ptr<const TemplateSource> LoadSource(const std::string &Filename){
+                auto Source = OpenFile(Filename);
+                if(!Source)
+                    SYDONIA_THROW(FileError("Failed accessing file at '" + Filename + "'"));
+                return Source;
+            }
     };
 }; // ! Sydonia namespace
 
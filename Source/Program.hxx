@@ -0,0 +1,79 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_PROGRAM_HXX
+#define SYDONIA_PROGRAM_HXX
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Node.hxx"
+
+namespace Sydonia{
+    // ! A single step of a compiled template
+    struct Instruction{
+        enum class Opcode{
+            Text,           // Write Length bytes of the template content starting at Operand
+            Literal,        // Push the value of a LiteralNode
+            Constant,       // Push the folded value at Operand of the constant pool
+            ConstantText,   // Write Length bytes of the folded text starting at Operand
+            Invariant,      // Push the render invariant value at Operand of the invariant pool
+            Data,           // Push the value of a DataNode
+            Operation,      // Apply a FunctionNode to the values on top of the stack
+            AtId,           // Replace the top value with the member named by the second argument
+            JumpIfDefined,  // Jump to Operand if the top value was found, otherwise drop it
+            JumpIfDecided,  // Pop the first argument of And/Or, push the result and jump to Operand if it decides it
+            Truthy,         // Replace the top value with whether it is truthy
+            Print,          // Pop the result of an expression list and write it
+            Jump,           // Jump to Operand
+            JumpIfFalse,    // Pop the result of a condition and jump to Operand if it is falsy
+            ForArray,       // Pop an array and begin a loop, jump to Operand when it is empty
+            ForObject,      // Pop an object and begin a loop, jump to Operand when it is empty
+            Next,           // Advance the innermost loop, jump to Operand while items remain
+            Include,
+            Extends,
+            Block,
+            Set,
+            Return,
+        };
+
+        Opcode OpcodeInstance;
+        size_t Operand;
+        size_t Length;
+        const AstNode* Node;
+
+        explicit Instruction(Opcode OpcodeLocal, const AstNode* NodeLocal = nullptr, size_t OperandLocal = 0, size_t LengthLocal = 0)
+            : OpcodeInstance(OpcodeLocal), Operand(OperandLocal), Length(LengthLocal), Node(NodeLocal){}
+    };
+
+    // ! A template lowered into a flat instruction stream, the main body starts
+    // ! at zero and every block body is placed after it, ending with a Return
+    struct Program{
+        std::vector<Instruction> Instructions;
+        std::map<std::string, size_t> Blocks;
+        // ! Values and printed text the Compiler worked out while lowering
+        std::vector<JSON> Constants;
+        std::string Text;
+        // ! Pointers into the invariant data the template keeps alive
+        std::vector<const JSON*> Invariants;
+        // ! Heads of the variables read from the invariant data, a render where a
+        // ! loop or a Set outside of the template binds one walks the AST instead
+        std::vector<std::string> InvariantHeads;
+
+        bool IsCompiled() const{
+            return !Instructions.empty();
+        }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_PROGRAM_HXX
\ No newline at end of file
@@ -14,14 +14,18 @@
 #define SYDONIA_RENDERER_HXX
 
 #include <algorithm>
+#include <deque>
 #include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "Arithmetic.hxx"
 #include "Configuration.hxx"
 #include "Exceptions.hxx"
 #include "Node.hxx"
+#include "OutputSink.hxx"
+#include "Program.hxx"
 #include "Template.hxx"
 #include "Utilities.hxx"
 
@@ -29,9 +33,41 @@ namespace Sydonia{
     // ! Class for rendering a template with data
     class Renderer : public NodeVisitor{
         using Operation = FunctionStorage::Operation;
+        using Opcode = Instruction::Opcode;
+
+        // ! A name visible to the template that refers to a value owned by someone
+        // ! else (the input, a loop container), it only owns a copy once the
+        // ! template computes or modifies it
+        struct Binding{
+            std::string_view Name;
+            const JSON* Value;
+            std::shared_ptr<JSON> Owned;
+        };
+
+        // ! State of a running loop, it borrows its container until a Set statement
+        // ! is about to change it and then iterates its own copy, Loop.* is answered
+        // ! from here and only built as JSON when dumped, the temporaries its
+        // ! container was computed in are pinned until it ends
+        struct LoopFrame{
+            size_t Pinned;
+            const JSON* Container;
+            // ! Whether a Set may change the container in place and the name it has
+            // ! to be made on, any name if it is empty
+            bool Assignable;
+            std::string_view AssignedHead;
+            std::shared_ptr<const JSON> Owned;
+            JSON::const_iterator Iterator;
+            JSON::const_iterator End;
+            size_t Index;
+            size_t Size;
+            size_t BindingBase;
+            bool IsObject;
+            JSON IndexValue;
+            JSON Index1Value;
+        };
 
         const RenderConfiguration RenderConfigurationInstance;
-        const TemplateStorage &TemplateStorageInstance;
+        const TemplateLookup TemplateStorageInstance;
         const FunctionStorage &FunctionStorageInstance;
         
         const Template* CurrentTemplate;
@@ -40,82 +76,124 @@ namespace Sydonia{
         std::vector<const BlockStatementNode*> BlockStatementStack;
         
         const JSON* DataInput;
-        std::ostream* OutputStream;
+        OutputSink* Output;
 
         JSON AdditionalData;
-        JSON* CurrentLoopData = &AdditionalData["Loop"];
 
-        std::vector<std::shared_ptr<JSON>> DataTempStack;
-        std::stack<const JSON*> DataEvalStack;
-        std::stack<const DataNode*> NotFoundStack;
+        std::vector<const JSON*> DataEvalStack;
+        std::vector<const DataNode*> NotFoundStack;
+        std::vector<LoopFrame> LoopStack;
+        std::vector<Binding> Bindings;
+        // ! Where the value last looked up by name lives, a loop over it takes it
+        struct DataOrigin{
+            const JSON* Value;
+            bool Assignable;
+            std::string_view Head;
+        };
+        DataOrigin LastData {nullptr, false, {}};
+        // ! Arena of the values computed while evaluating an expression, a slot is
+        // ! reused once the statement that consumed its value is done, scalars are
+        // ! held inline and strings or containers keep their storage between uses
+        std::deque<JSON> Temporaries;
+        size_t TemporariesUsed {0};
+        // ! Arguments of the callback being called
+        Arguments CallArguments;
+        // ! Arguments of the lazy callbacks being called, null until evaluated
+        std::vector<const JSON*> LazyValues;
 
-        bool BreakRendering {false};
+        // ! What a lazy callback sees of its arguments, they are evaluated in the
+        // ! renderer that called it
+        class LazyCall : public LazyArguments{
+            Renderer &RendererInstance;
+            const AstNode &Node;
+            const std::vector<ExpressionNode*> &Items;
+            const size_t Base;
 
-        static bool Truthy(const JSON* Data){
-            if(Data->is_boolean())
-                return Data->get<bool>();
-            else if(Data->is_number())
-                return (*Data != 0);
-            else if(Data->is_null())
-                return false;
-            return !Data->empty();
-        }
+            public:
+                LazyCall(Renderer &RendererLocal, const AstNode &NodeLocal, const std::vector<ExpressionNode*> &ItemsLocal, size_t BaseLocal)
+                    : RendererInstance(RendererLocal), Node(NodeLocal), Items(ItemsLocal), Base(BaseLocal){}
+
+                size_t Size() const{
+                    return Items.size();
+                }
+
+                const JSON &operator[](size_t Index){
+                    return *RendererInstance.EvaluateLazy(Node, Items, Base, Index);
+                }
+        };
 
-        void PrintData(const std::shared_ptr<JSON> Value){
+        bool BreakRendering {false};
+
+        void PrintData(const JSON* Value){
             if(Value->is_string())
-                *OutputStream << Value->get_ref<const JSON::string_t&>();
+                Output->Write(Value->get_ref<const JSON::string_t&>());
+            else if(Value->is_number_unsigned())
+                Output->WriteUnsigned(Value->get<const JSON::number_unsigned_t>());
             else if(Value->is_number_integer())
-                *OutputStream << Value->get<const JSON::number_integer_t>();
+                Output->WriteInteger(Value->get<const JSON::number_integer_t>());
+            else if(Value->is_boolean())
+                Output->Write(Value->get<bool>() ? "true" : "false");
             else if(Value->is_null()){}
             else
-                *OutputStream << Value->dump();
+                Output->Write(Value->dump());
         }
 
-        const std::shared_ptr<JSON> EvalExpressionList(const ExpressionListNode &ExpressionList){
+        const JSON* EvalExpressionList(const ExpressionListNode &ExpressionList){
             if(!ExpressionList.Root)
                 ThrowRendererError("Empty expression", ExpressionList);
             ExpressionList.Root->Accept(*this);
+            return PopExpressionResult(ExpressionList);
+        }
+
+        // ! Takes the value left by an evaluated expression list off the stack, the
+        // ! result is borrowed from the data, the template or the temporaries
+        const JSON* PopExpressionResult(const ExpressionListNode &ExpressionList){
             if(DataEvalStack.empty())
                 ThrowRendererError("Empty expression", ExpressionList);
             else if(DataEvalStack.size() != 1)
                 ThrowRendererError("Malformed expression", ExpressionList);
-            const auto Result = DataEvalStack.top();
-            DataEvalStack.pop();
+            const auto Result = DataEvalStack.back();
+            DataEvalStack.pop_back();
             if(!Result){
                 if(NotFoundStack.empty())
                     ThrowRendererError("Expression could not be evaluated", ExpressionList);
-                auto Node = NotFoundStack.top();
-                NotFoundStack.pop();
+                auto Node = NotFoundStack.back();
+                NotFoundStack.pop_back();
                 ThrowRendererError("Variable '" + static_cast<std::string>(Node->Name) + "' not found", *Node);
             }
-            return std::make_shared<JSON>(*Result);
+            return Result;
         }
 
         void ThrowRendererError(const std::string &Message, const AstNode &Node){
-            SourceLocation Location = GetSourceLocation(CurrentTemplate->Content, Node.Position);
-            SYDONIA_THROW(RenderError(Message, Location));
+            SYDONIA_THROW(RenderError(Message, CurrentTemplate->Locate(Node.Position)));
+        }
+
+        // ! The temporary a result is written into, already on the stack
+        JSON &PushTemporary(){
+            JSON &Result = NextTemporary();
+            DataEvalStack.push_back(&Result);
+            return Result;
         }
 
-        void MakeResult(const JSON &&Result){
-            auto ResultPointer = std::make_shared<JSON>(Result);
-            DataTempStack.push_back(ResultPointer);
-            DataEvalStack.push(ResultPointer.get());
+        template <typename ValueType> void MakeResult(ValueType &&Value){
+            JSON &Result = NextTemporary();
+            Result = std::forward<ValueType>(Value);
+            DataEvalStack.push_back(&Result);
         }
 
-        template <size_t N, size_t NStart = 0, bool ThrowNotFound = true> std::array<const JSON*, N> GetArguments(const FunctionNode &Node){
-            if(Node.Arguments.size() < NStart + N)
-                ThrowRendererError("Function needs " + std::to_string(NStart + N) + " variables, but has only found " + std::to_string(Node.Arguments.size()), Node);
-            for(size_t Iterator = NStart; Iterator < NStart + N; Iterator += 1)
-                Node.Arguments[Iterator]->Accept(*this);
+        // ! Takes the N already evaluated arguments of a function off the stack
+        template <size_t N, bool ThrowNotFound = true> std::array<const JSON*, N> PopArguments(const FunctionNode &Node){
+            if(Node.Arguments.size() < N)
+                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(Node.Arguments.size()), Node);
             if(DataEvalStack.size() < N)
                 ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
             std::array<const JSON*, N> Result;
             for(size_t Iterator = 0; Iterator < N; Iterator += 1){
-                Result[N - Iterator - 1] = DataEvalStack.top();
-                DataEvalStack.pop();
+                Result[N - Iterator - 1] = DataEvalStack.back();
+                DataEvalStack.pop_back();
                 if(!Result[N - Iterator - 1]){
-                    const auto DataNode = NotFoundStack.top();
-                    NotFoundStack.pop();
+                    const auto DataNode = NotFoundStack.back();
+                    NotFoundStack.pop_back();
                     if(ThrowNotFound)
                         ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
                 }
@@ -123,24 +201,80 @@ namespace Sydonia{
             return Result;
         }
 
-        template <bool ThrowNotFound = true> Arguments GetArgumentVector(const FunctionNode &Node){
+        template <bool ThrowNotFound = true> Arguments PopArgumentVector(const FunctionNode &Node){
+            Arguments Result;
+            PopArgumentsInto<ThrowNotFound>(Node, Result);
+            return Result;
+        }
+
+        // ! Same as PopArgumentVector but reusing the storage of Result
+        template <bool ThrowNotFound = true> void PopArgumentsInto(const FunctionNode &Node, Arguments &Result){
             const size_t N = Node.Arguments.size();
-            for(auto Arg : Node.Arguments)
-                Arg->Accept(*this);
             if(DataEvalStack.size() < N)
                 ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
-            Arguments Result {N};
+            Result.resize(N);
             for(size_t Iterator = 0; Iterator < N; Iterator += 1){
-                Result[N - Iterator - 1] = DataEvalStack.top();
-                DataEvalStack.pop();
+                Result[N - Iterator - 1] = DataEvalStack.back();
+                DataEvalStack.pop_back();
                 if(!Result[N - Iterator - 1]){
-                    const auto DataNode = NotFoundStack.top();
-                    NotFoundStack.pop();
+                    const auto DataNode = NotFoundStack.back();
+                    NotFoundStack.pop_back();
                     if(ThrowNotFound)
                         ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
                 }
             }
-            return Result;
+        }
+
+        JSON &NextTemporary(){
+            if(TemporariesUsed == Temporaries.size())
+                Temporaries.emplace_back();
+            return Temporaries[TemporariesUsed++];
+        }
+
+        // ! Called once a statement has consumed the value of its expression, the
+        // ! arguments a lazy callback has evaluated are kept until it returns and
+        // ! the slots a running loop iterates are kept until it ends
+        void ReleaseTemporaries(){
+            LastData.Value = nullptr;
+            if(DataEvalStack.empty() && LazyValues.empty())
+                TemporariesUsed = LoopStack.empty() ? 0 : LoopStack.back().Pinned;
+        }
+
+        const JSON* EvaluateLazy(const AstNode &Node, const std::vector<ExpressionNode*> &Items, size_t Base, size_t Index){
+            if(Index >= Items.size())
+                ThrowRendererError("Callback asked for argument " + std::to_string(Index) + " of " + std::to_string(Items.size()), Node);
+            if(!LazyValues[Base + Index]){
+                Items[Index]->Accept(*this);
+                const auto Value = DataEvalStack.back();
+                DataEvalStack.pop_back();
+                if(!Value){
+                    const auto Missing = NotFoundStack.back();
+                    NotFoundStack.pop_back();
+                    ThrowRendererError("Variable '" + static_cast<std::string>(Missing->Name) + "' not found", *Missing);
+                }
+                LazyValues[Base + Index] = Value;
+            }
+            return LazyValues[Base + Index];
+        }
+
+        void CallLazy(const Callable &CallbackLocal, const AstNode &Node, const std::vector<ExpressionNode*> &Items){
+            const size_t Base = LazyValues.size();
+            LazyValues.resize(Base + Items.size(), nullptr);
+            LazyCall Call(*this, Node, Items, Base);
+            JSON &Result = NextTemporary();
+            CallbackLocal.LazyFunction(Call, Result);
+            LazyValues.resize(Base);
+            DataEvalStack.push_back(&Result);
+        }
+
+        // ! Result callbacks write straight into a temporary, the others return one
+        void Call(const Callable &CallbackLocal, Arguments &Values){
+            if(CallbackLocal.ResultFunction){
+                JSON &Result = NextTemporary();
+                CallbackLocal.ResultFunction(ArgumentSpan(Values.data(), Values.size()), Result);
+                DataEvalStack.push_back(&Result);
+            }else
+                MakeResult(CallbackLocal.Function(Values));
         }
 
         void Visit(const BlockNode &Node){
@@ -152,202 +286,325 @@ namespace Sydonia{
         }
 
         void Visit(const TextNode &Node){
-            OutputStream->write(CurrentTemplate->Content.c_str() + Node.Position, Node.Length);
+            Output->Write(CurrentTemplate->Content.data() + Node.Position, Node.Length);
         }
 
         void Visit(const ExpressionNode &){}
 
         void Visit(const LiteralNode &Node){
-            DataEvalStack.push(&Node.Value);
+            DataEvalStack.push_back(&Node.Value);
         }
 
         void Visit(const DataNode &Node){
-            if(AdditionalData.contains(Node.Pointer))
-                DataEvalStack.push(&(AdditionalData[Node.Pointer]));
-            else if(DataInput->contains(Node.Pointer))
-                DataEvalStack.push(&(*DataInput)[Node.Pointer]);
-            else{
-                // ! Try to evaluate as a no argument callback
-                const auto FunctionData = FunctionStorageInstance.FindFunction(Node.Name, 0);
-                if(FunctionData.OperationInstance == FunctionStorage::Operation::Callback){
-                    Arguments EmptyArgs {};
-                    const auto Value = std::make_shared<JSON>(FunctionData.Callback(EmptyArgs));
-                    DataTempStack.push_back(Value);
-                    DataEvalStack.push(Value.get());
-                }else{
-                    DataEvalStack.push(nullptr);
-                    NotFoundStack.emplace(&Node);
+            PushData(Node);
+        }
+
+        const JSON* FindBinding(const DataNode &Node){
+            for(auto Iterator = Bindings.rbegin(); Iterator != Bindings.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head())
+                    continue;
+                const auto Result = Node.Find(*Iterator->Value, 1);
+                if(Iterator->Value == Iterator->Owned.get())
+                    LastData = DataOrigin {Result, true, Iterator->Name};
+                else
+                    LastData = BorrowedOrigin(Result, static_cast<size_t>(Bindings.rend() - Iterator) - 1);
+                return Result;
+            }
+            return nullptr;
+        }
+
+        // ! A binding that does not own its value borrows it from the container of
+        // ! the loop that made it
+        DataOrigin BorrowedOrigin(const JSON* Value, size_t Position) const{
+            for(auto Iterator = LoopStack.rbegin(); Iterator != LoopStack.rend(); ++Iterator)
+                if(Iterator->BindingBase <= Position)
+                    return DataOrigin {Value, Iterator->Assignable && !Iterator->Owned, Iterator->AssignedHead};
+            return DataOrigin {Value, true, {}};
+        }
+
+        // ! Resolves Loop.* against the running loops
+        const JSON* FindLoopData(const DataNode &Node){
+            using Member = DataNode::LoopAccess::Member;
+            static const JSON True(true), False(false);
+            const auto &Access = Node.LoopAccessInstance;
+            if(Access.Depth >= LoopStack.size())
+                return nullptr;
+            auto &Frame = LoopStack[LoopStack.size() - 1 - Access.Depth];
+            switch(Access.MemberInstance){
+                case Member::Index:
+                    Frame.IndexValue = Frame.Index;
+                    return &Frame.IndexValue;
+                case Member::Index1:
+                    Frame.Index1Value = Frame.Index + 1;
+                    return &Frame.Index1Value;
+                case Member::IsFirst:
+                    return (Frame.Index == 0) ? &True : &False;
+                case Member::IsLast:
+                    return (Frame.Index + 1 == Frame.Size) ? &True : &False;
+                default: {
+                    JSON &Value = NextTemporary();
+                    Value = MaterializeLoop(LoopStack.size() - 1);
+                    const auto Result = Node.Find(Value, 1);
+                    if(!Result)
+                        TemporariesUsed -= 1;
+                    return Result;
                 }
             }
         }
 
+        JSON MaterializeLoop(size_t Position) const{
+            const auto &Frame = LoopStack[Position];
+            JSON Result;
+            Result["Index"] = Frame.Index;
+            Result["Index1"] = Frame.Index + 1;
+            Result["IsFirst"] = (Frame.Index == 0);
+            Result["IsLast"] = (Frame.Index + 1 == Frame.Size);
+            if(Position > 0)
+                Result["Parent"] = MaterializeLoop(Position - 1);
+            return Result;
+        }
+
+        void PushData(const DataNode &Node){
+            const JSON* Bound = !Bindings.empty() ? FindBinding(Node) : nullptr;
+            if(!Bound){
+                // ! Only the values made by Set can change while they are looped over
+                bool Assigned = false;
+                if(Node.LoopAccessInstance.MemberInstance != DataNode::LoopAccess::Member::None){
+                    // ! A value Set on Loop.* is kept over the one of the running loop
+                    Bound = Node.Find(AdditionalData);
+                    Assigned = Bound;
+                    if(!Bound)
+                        Bound = FindLoopData(Node);
+                }
+                if(!Bound)
+                    Assigned = (Bound = Node.Find(AdditionalData));
+                // ! Render invariant values stand in for the render data
+                if(!Bound && CurrentTemplate->InvariantData)
+                    Bound = Node.Find(*CurrentTemplate->InvariantData);
+                if(!Bound)
+                    Bound = Node.Find(*DataInput);
+                LastData = DataOrigin {Bound, Assigned, Node.Head()};
+            }
+            if(Bound)
+                DataEvalStack.push_back(Bound);
+            // ! Evaluate as the no argument callback bound while parsing
+            else if(Node.Callback && Node.Callback->LazyFunction){
+                static const std::vector<ExpressionNode*> NoArguments;
+                CallLazy(*Node.Callback, Node, NoArguments);
+            }else if(Node.Callback){
+                CallArguments.clear();
+                Call(*Node.Callback, CallArguments);
+            }else{
+                DataEvalStack.push_back(nullptr);
+                NotFoundStack.emplace_back(&Node);
+            }
+        }
+
         void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    Node.Arguments[0]->Accept(*this);
+                    ApplyAtId(Node);
+                } break;
+                case Operation::Default: {
+                    Node.Arguments[0]->Accept(*this);
+                    if(!PushIfDefined(Node)){
+                        Node.Arguments[1]->Accept(*this);
+                        DataEvalStack.push_back(PopArguments<1>(Node)[0]);
+                    }
+                } break;
+                case Operation::And:
+                case Operation::Or: {
+                    Node.Arguments[0]->Accept(*this);
+                    if(!PushIfDecided(Node)){
+                        Node.Arguments[1]->Accept(*this);
+                        PushTruthy(Node);
+                    }
+                } break;
+                default: {
+                    // ! A lazy callback evaluates its arguments itself
+                    if(Node.OperationInstance != Operation::Callback || !Node.Callback->LazyFunction)
+                        for(auto &Argument : Node.Arguments)
+                            Argument->Accept(*this);
+                    ApplyOperation(Node);
+                }
+            }
+        }
+
+        void ApplyAtId(const FunctionNode &Node){
+            const auto Container = PopArguments<1, false>(Node)[0];
+            Node.Arguments[1]->Accept(*this);
+            if(NotFoundStack.empty())
+                ThrowRendererError("COuld not find element with given name", Node);
+            const auto NodeID = NotFoundStack.back();
+            NotFoundStack.pop_back();
+            DataEvalStack.pop_back();
+            DataEvalStack.push_back(&Container->at(NodeID->Name));
+        }
+
+        // ! Keeps the evaluated first argument of Default() if it was found
+        bool PushIfDefined(const FunctionNode &Node){
+            const auto TestArguments = PopArguments<1, false>(Node)[0];
+            if(TestArguments)
+                DataEvalStack.push_back(TestArguments);
+            return TestArguments;
+        }
+
+        // ! Takes the evaluated first argument of And/Or and keeps the result when
+        // ! the argument decides it, the second one is left unevaluated then
+        bool PushIfDecided(const FunctionNode &Node){
+            const bool First = Truthy(PopArguments<1>(Node)[0]);
+            if(First != (Node.OperationInstance == Operation::Or))
+                return false;
+            MakeResult(First);
+            return true;
+        }
+
+        void PushTruthy(const FunctionNode &Node){
+            MakeResult(Truthy(PopArguments<1>(Node)[0]));
+        }
+
+        // ! Applies a function to its arguments, which must already be on the stack
+        void ApplyOperation(const FunctionNode &Node){
             switch(Node.OperationInstance){
                 case Operation::Not: {
-                    const auto Arguments = GetArguments<1>(Node);
+                    const auto Arguments = PopArguments<1>(Node);
                     MakeResult(!Truthy(Arguments[0]));
                 } break;
                 case Operation::And: {
-                    MakeResult(Truthy(GetArguments<1, 0>(Node)[0]) && Truthy(GetArguments<1, 1>(Node)[0]));
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Truthy(Arguments[0]) && Truthy(Arguments[1]));
                 } break;
                 case Operation::Or: {
-                    MakeResult(Truthy(GetArguments<1, 0>(Node)[0]) || Truthy(GetArguments<1, 1>(Node)[0]));
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Truthy(Arguments[0]) || Truthy(Arguments[1]));
                 } break;
                 case Operation::In: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     MakeResult(std::find(Arguments[1]->begin(), Arguments[1]->end(), *Arguments[0]) != Arguments[1]->end());
                 } break;
                 case Operation::Equal: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] == *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Equal(*Arguments[0], *Arguments[1]));
                 } break;
                 case Operation::NotEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] != *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Equal(*Arguments[0], *Arguments[1]));
                 } break;
                 case Operation::Greater: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] > *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Less(*Arguments[1], *Arguments[0]));
                 } break;
                 case Operation::GreaterEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] >= *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Less(*Arguments[0], *Arguments[1]));
                 } break;
                 case Operation::Less: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] < *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Less(*Arguments[0], *Arguments[1]));
                 } break;
                 case Operation::LessEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] <= *Arguments[1]);
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Less(*Arguments[1], *Arguments[0]));
                 } break;
                 case Operation::Add: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_string() && Arguments[1]->is_string())
-                        MakeResult(Arguments[0]->get_ref<const std::string&>() + Arguments[1]->get_ref<const std::string&>());
-                    else if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() + Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() + Arguments[1]->get<double>());
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Add(*Arguments[0], *Arguments[1], PushTemporary());
                 } break;
                 case Operation::Subtract: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() - Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() - Arguments[1]->get<double>());
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Subtract(*Arguments[0], *Arguments[1], PushTemporary());
                 } break;
                 case Operation::Multiplication: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() * Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() * Arguments[1]->get<double>());
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Multiply(*Arguments[0], *Arguments[1], PushTemporary());
                 } break;
                 case Operation::Division: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[1]->get<double>() == 0)
+                    const auto Arguments = PopArguments<2>(Node);
+                    const auto Divisor = Arithmetic::AsFloat(*Arguments[1]);
+                    if(Divisor == 0)
                         ThrowRendererError("Division by zero", Node);
-                    MakeResult(Arguments[0]->get<double>() / Arguments[1]->get<double>());
+                    MakeResult(Arithmetic::AsFloat(*Arguments[0]) / Divisor);
                 } break;
                 case Operation::Power: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->get<int>() >= 0){
-                        int Result = static_cast<int>(std::pow(Arguments[0]->get<int>(), Arguments[1]->get<int>()));
-                        MakeResult(Result);
-                    }else{
-                        double Result = std::pow(Arguments[0]->get<double>(), Arguments[1]->get<int>());
-                        MakeResult(Result);
-                    }
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Power(*Arguments[0], *Arguments[1], PushTemporary());
                 } break;
                 case Operation::Modulo: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(Arguments[0]->get<int>() % Arguments[1]->get<int>());
-                } break;
-                case Operation::AtId: {
-                    const auto Container = GetArguments<1, 0, false>(Node)[0];
-                    Node.Arguments[1]->Accept(*this);
-                    if(NotFoundStack.empty())
-                        ThrowRendererError("COuld not find element with given name", Node);
-                    const auto NodeID = NotFoundStack.top();
-                    NotFoundStack.pop();
-                    DataEvalStack.pop();
-                    DataEvalStack.push(&Container->at(NodeID->Name));
+                    const auto Arguments = PopArguments<2>(Node);
+                    if(!Arithmetic::Modulo(*Arguments[0], *Arguments[1], PushTemporary()))
+                        ThrowRendererError("Modulo by zero", Node);
                 } break;
                 case Operation::At: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     if(Arguments[0]->is_object())
-                        DataEvalStack.push(&Arguments[0]->at(Arguments[1]->get<std::string>()));
+                        DataEvalStack.push_back(&Arguments[0]->at(Arguments[1]->get<std::string>()));
                     else
-                        DataEvalStack.push(&Arguments[0]->at(Arguments[1]->get<int>()));
-                } break;
-                case Operation::Default: {
-                    const auto TestArguments = GetArguments<1, 0, false>(Node)[0];
-                    DataEvalStack.push(TestArguments ? TestArguments : GetArguments<1, 1>(Node)[0]);
+                        DataEvalStack.push_back(&Arguments[0]->at(Arguments[1]->get<int>()));
                 } break;
                 case Operation::DivisibleBy: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     const int Divisor = Arguments[1]->get<int>();
                     MakeResult((Divisor != 0) && (Arguments[0]->get<int>() % Divisor == 0));
                 } break;
                 case Operation::Even: {
-                    MakeResult(GetArguments<1>(Node)[0]->get<int>() % 2 == 0);
+                    MakeResult(PopArguments<1>(Node)[0]->get<int>() % 2 == 0);
                 } break;
                 case Operation::Exists: {
-                    auto &&Name = GetArguments<1>(Node)[0]->get_ref<const std::string&>();
+                    auto &&Name = PopArguments<1>(Node)[0]->get_ref<const std::string&>();
                     MakeResult(DataInput->contains(JSON::json_pointer(DataNode::ConvertDotToPointer(Name))));
                 } break;
                 case Operation::ExistsInObject: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     auto &&Name = Arguments[1]->get_ref<const std::string&>();
                     MakeResult(Arguments[0]->find(Name) != Arguments[0]->end());
                 } break;
                 case Operation::First: {
-                    const auto Result = &GetArguments<1>(Node)[0]->front();
-                    DataEvalStack.push(Result);
+                    const auto Result = &PopArguments<1>(Node)[0]->front();
+                    DataEvalStack.push_back(Result);
                 } break;
                 case Operation::Float: {
-                    MakeResult(std::stod(GetArguments<1>(Node)[0]->get_ref<const std::string&>()));
+                    MakeResult(std::stod(PopArguments<1>(Node)[0]->get_ref<const std::string&>()));
                 } break;
                 case Operation::Int: {
-                    MakeResult(std::stoi(GetArguments<1>(Node)[0]->get_ref<const std::string&>()));
+                    MakeResult(std::stoi(PopArguments<1>(Node)[0]->get_ref<const std::string&>()));
                 } break;
                 case Operation::Last: {
-                    const auto Result = &GetArguments<1>(Node)[0]->back();
-                    DataEvalStack.push(Result);
+                    const auto Result = &PopArguments<1>(Node)[0]->back();
+                    DataEvalStack.push_back(Result);
                 } break;
                 case Operation::Length: {
-                    const auto Value = GetArguments<1>(Node)[0];
+                    const auto Value = PopArguments<1>(Node)[0];
                     if(Value->is_string())
                         MakeResult(Value->get_ref<const std::string&>().length());
                     else
                         MakeResult(Value->size());
                 } break;
                 case Operation::Lower: {
-                    std::string Result = GetArguments<1>(Node)[0]->get<std::string>();
+                    std::string Result = PopArguments<1>(Node)[0]->get<std::string>();
                     std::transform(Result.begin(), Result.end(), Result.begin(), ::tolower);
                     MakeResult(std::move(Result));
                 } break;
                 case Operation::Max: {
-                    const auto Arguments = GetArguments<1>(Node);
+                    const auto Arguments = PopArguments<1>(Node);
                     const auto Result = std::max_element(Arguments[0]->begin(), Arguments[0]->end());
-                    DataEvalStack.push(&(*Result));
+                    DataEvalStack.push_back(&(*Result));
                 } break;
                 case Operation::Min: {
-                    const auto Arguments = GetArguments<1>(Node);
+                    const auto Arguments = PopArguments<1>(Node);
                     const auto Result = std::min_element(Arguments[0]->begin(), Arguments[0]->end());
-                    DataEvalStack.push(&(*Result));
+                    DataEvalStack.push_back(&(*Result));
                 } break;
                 case Operation::Odd: {
-                    MakeResult(GetArguments<1>(Node)[0]->get<int>() % 2 != 0);
+                    MakeResult(PopArguments<1>(Node)[0]->get<int>() % 2 != 0);
                 } break;
                 case Operation::Range: {
-                    std::vector<int> Result(GetArguments<1>(Node)[0]->get<int>());
+                    std::vector<int> Result(PopArguments<1>(Node)[0]->get<int>());
                     std::iota(Result.begin(), Result.end(), 0);
                     MakeResult(std::move(Result));
                 } break;
                 case Operation::Round: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     const int Precision = Arguments[1]->get<int>();
                     const double Result = std::round(Arguments[0]->get<double>() * std::pow(10.0, Precision)) / std::pow(10.0, Precision);
                     if(Precision == 0)
@@ -356,43 +613,48 @@ namespace Sydonia{
                         MakeResult(Result);
                 } break;
                 case Operation::Sort: {
-                    auto ResultPointer = std::make_shared<JSON>(GetArguments<1>(Node)[0]->get<std::vector<JSON>>());
-                    std::sort(ResultPointer->begin(), ResultPointer->end());
-                    DataTempStack.push_back(ResultPointer);
-                    DataEvalStack.push(ResultPointer.get());
+                    const auto Arguments = PopArguments<1>(Node);
+                    JSON &Result = NextTemporary();
+                    Result = Arguments[0]->get<std::vector<JSON>>();
+                    std::sort(Result.begin(), Result.end());
+                    DataEvalStack.push_back(&Result);
                 } break;
                 case Operation::Upper: {
-                    std::string Result = GetArguments<1>(Node)[0]->get<std::string>();
+                    std::string Result = PopArguments<1>(Node)[0]->get<std::string>();
                     std::transform(Result.begin(), Result.end(), Result.begin(), ::toupper);
                     MakeResult(std::move(Result));
                 } break;
                 case Operation::IsBoolean: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_boolean());
+                    MakeResult(PopArguments<1>(Node)[0]->is_boolean());
                 } break;
                 case Operation::IsNumber: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number());
+                    MakeResult(PopArguments<1>(Node)[0]->is_number());
                 } break;
                 case Operation::IsInteger: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number_integer());
+                    MakeResult(PopArguments<1>(Node)[0]->is_number_integer());
                 } break;
                 case Operation::IsFloat: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number_float());
+                    MakeResult(PopArguments<1>(Node)[0]->is_number_float());
                 } break;
                 case Operation::IsObject: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_object());
+                    MakeResult(PopArguments<1>(Node)[0]->is_object());
                 } break;
                 case Operation::IsArray: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_array());
+                    MakeResult(PopArguments<1>(Node)[0]->is_array());
                 } break;
                 case Operation::IsString: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_string());
+                    MakeResult(PopArguments<1>(Node)[0]->is_string());
                 } break;
                 case Operation::Callback: {
-                    auto Arguments = GetArgumentVector(Node);
-                    MakeResult(Node.Callback(Arguments));
+                    if(Node.Callback->LazyFunction){
+                        CallLazy(*Node.Callback, Node, Node.Arguments);
+                        break;
+                    }
+                    PopArgumentsInto(Node, CallArguments);
+                    Call(*Node.Callback, CallArguments);
                 } break;
                 case Operation::Super: {
-                    const auto Arguments = GetArgumentVector(Node);
+                    const auto Arguments = PopArgumentVector(Node);
                     const size_t OldLevel = CurrentLevel;
                     const size_t LevelDiff = (Arguments.size() != 1) ? Arguments[0]->get<int>() : 1;
                     const size_t Level = CurrentLevel + LevelDiff;
@@ -410,7 +672,7 @@ namespace Sydonia{
                     if(BlockIterator != NewTemplate->BlockStorage.end()){
                         CurrentTemplate = NewTemplate;
                         CurrentLevel = Level;
-                        BlockIterator->second->Block.Accept(*this);
+                        RenderBlock(*BlockIterator->second);
                         CurrentLevel = OldLevel;
                         CurrentTemplate = OldTemplate;
                     }else
@@ -418,7 +680,7 @@ namespace Sydonia{
                     MakeResult(nullptr);
                 } break;
                 case Operation::Join: {
-                    const auto Arguments = GetArguments<2>(Node);
+                    const auto Arguments = PopArguments<2>(Node);
                     const auto Separator = Arguments[1]->get<std::string>();
                     std::ostringstream Stream;
                     std::string Sep;
@@ -432,6 +694,8 @@ namespace Sydonia{
                     }
                     MakeResult(Stream.str());
                 } break;
+                case Operation::AtId:
+                case Operation::Default:
                 case Operation::ParenLeft:
                 case Operation::ParenRight:
                 case Operation::None:
@@ -441,6 +705,7 @@ namespace Sydonia{
 
         void Visit(const ExpressionListNode &Node){
             PrintData(EvalExpressionList(Node));
+            ReleaseTemporaries();
         }
 
         void Visit(const StatementNode &){}
@@ -451,65 +716,123 @@ namespace Sydonia{
             const auto Result = EvalExpressionList(Node.Condition);
             if(!Result->is_array())
                 ThrowRendererError("Object must be an array", Node);
-            if(!CurrentLoopData->empty()){
-                auto Temp = *CurrentLoopData;
-                (*CurrentLoopData)["Parent"] = std::move(Temp);
-            }
-            size_t Index = 0;
-            (*CurrentLoopData)["IsFirst"] = true;
-            (*CurrentLoopData)["IsLast"] = (Result->size() <= 1);
-            for(auto Iterator = Result->begin(); Iterator != Result->end(); ++Iterator){
-                AdditionalData[static_cast<std::string>(Node.Value)] = *Iterator;
-                (*CurrentLoopData)["Index"] = Index;
-                (*CurrentLoopData)["Index1"] = Index + 1;
-                if(Index == 1)
-                    (*CurrentLoopData)["IsFirst"] = false;
-                if(Index == Result->size() - 1)
-                    (*CurrentLoopData)["IsLast"] = true;
-                Node.Body.Accept(*this);
-                ++Index;
+            const bool HasItems = BeginLoop(Node, Result);
+            ReleaseTemporaries();
+            if(HasItems){
+                do
+                    Node.Body.Accept(*this);
+                while(AdvanceLoop());
             }
-
-            AdditionalData[static_cast<std::string>(Node.Value)].clear();
-            if(!(*CurrentLoopData)["Parent"].empty()){
-                const auto Temp = (*CurrentLoopData)["Parent"];
-                *CurrentLoopData = std::move(Temp);
-            }else
-                CurrentLoopData = &AdditionalData["Loop"];
         }
 
         void Visit(const ForObjectStatementNode &Node){
             const auto Result = EvalExpressionList(Node.Condition);
             if(!Result->is_object())
                 ThrowRendererError("Object must be an object", Node);
-            if(!CurrentLoopData->empty())
-                (*CurrentLoopData)["Parent"] = std::move(*CurrentLoopData);
-            size_t Index = 0;
-            (*CurrentLoopData)["IsFirst"] = true;
-            (*CurrentLoopData)["IsLast"] = (Result->size() <= 1);
-            for(auto Iterator = Result->begin(); Iterator != Result->end(); ++Iterator){
-                AdditionalData[static_cast<std::string>(Node.Key)] = Iterator.key();
-                AdditionalData[static_cast<std::string>(Node.Value)] = Iterator.value();
-                (*CurrentLoopData)["Index"] = Index;
-                (*CurrentLoopData)["Index1"] = Index + 1;
-                if(Index == 1)
-                    (*CurrentLoopData)["IsFirst"] = false;
-                if(Index == Result->size() - 1)
-                    (*CurrentLoopData)["IsLast"] = true;
-                Node.Body.Accept(*this);
-                ++Index;
+            const bool HasItems = BeginLoop(Node, Result);
+            ReleaseTemporaries();
+            if(HasItems){
+                do
+                    Node.Body.Accept(*this);
+                while(AdvanceLoop());
+            }
+        }
+
+        bool BeginLoop(const ForArrayStatementNode &Node, const JSON* Container){
+            if(Container->empty())
+                return false;
+            const auto Origin = OriginOf(Container);
+            LoopStack.push_back(LoopFrame {TemporariesUsed, Container, Origin.Assignable, Origin.Head, nullptr, Container->cbegin(), Container->cend(), 0, Container->size(), Bindings.size(), false, nullptr, nullptr});
+            Bindings.push_back(Binding {Node.Value, &*LoopStack.back().Iterator, nullptr});
+            return true;
+        }
+
+        bool BeginLoop(const ForObjectStatementNode &Node, const JSON* Container){
+            if(Container->empty())
+                return false;
+            const auto Origin = OriginOf(Container);
+            LoopStack.push_back(LoopFrame {TemporariesUsed, Container, Origin.Assignable, Origin.Head, nullptr, Container->cbegin(), Container->cend(), 0, Container->size(), Bindings.size(), true, nullptr, nullptr});
+            const auto Key = std::make_shared<JSON>(LoopStack.back().Iterator.key());
+            Bindings.push_back(Binding {Node.Key, Key.get(), Key});
+            Bindings.push_back(Binding {Node.Value, &LoopStack.back().Iterator.value(), nullptr});
+            return true;
+        }
+
+        // ! Where a loop container lives, a value reached from a lookup but not
+        // ! looked up itself may lie inside anything a Set can change
+        DataOrigin OriginOf(const JSON* Container) const{
+            if(Container == LastData.Value)
+                return LastData;
+            for(size_t Position = 0; Position < TemporariesUsed; ++Position)
+                if(&Temporaries[Position] == Container)
+                    return DataOrigin {Container, false, {}};
+            return DataOrigin {Container, true, {}};
+        }
+
+        // ! Moves the innermost loop to its next item, returns false once it is done
+        bool AdvanceLoop(){
+            auto &Frame = LoopStack.back();
+            ++Frame.Iterator;
+            ++Frame.Index;
+            if(Frame.Iterator == Frame.End){
+                Bindings.erase(Bindings.begin() + Frame.BindingBase, Bindings.end());
+                LoopStack.pop_back();
+                return false;
+            }
+            if(Frame.IsObject){
+                auto &Key = Bindings[Frame.BindingBase];
+                if(Key.Value != Key.Owned.get())
+                    Key.Owned = std::make_shared<JSON>();
+                *Key.Owned = Frame.Iterator.key();
+                Key.Value = Key.Owned.get();
+                Bindings[Frame.BindingBase + 1] = Binding {Bindings[Frame.BindingBase + 1].Name, &Frame.Iterator.value(), nullptr};
+            }else
+                Bindings[Frame.BindingBase] = Binding {Bindings[Frame.BindingBase].Name, &*Frame.Iterator, nullptr};
+            return true;
+        }
+
+        // ! Drops the loops started at or above Depth, used when rendering stops early
+        void UnwindLoops(size_t Depth){
+            while(LoopStack.size() > Depth){
+                Bindings.erase(Bindings.begin() + LoopStack.back().BindingBase, Bindings.end());
+                LoopStack.pop_back();
             }
-            AdditionalData[static_cast<std::string>(Node.Key)].clear();
-            AdditionalData[static_cast<std::string>(Node.Value)].clear();
-            if(!(*CurrentLoopData)["Parent"].empty())
-                *CurrentLoopData = std::move((*CurrentLoopData)["Parent"]);
-            else
-                CurrentLoopData = &AdditionalData["Loop"];
+        }
+
+        // ! Gives the running loops whose container lies inside Root their own copy
+        // ! of it, called before Root is changed in place by a Set on Head
+        void DetachLoops(const JSON &Root, std::string_view Head){
+            for(auto &Frame : LoopStack){
+                if(Frame.Owned || !Frame.Assignable)
+                    continue;
+                if(!Frame.AssignedHead.empty() && Frame.AssignedHead != Head)
+                    continue;
+                if(!Contains(Root, Frame.Container))
+                    continue;
+                Frame.Owned = std::make_shared<const JSON>(*Frame.Container);
+                Frame.Container = Frame.Owned.get();
+                Frame.Iterator = std::next(Frame.Container->cbegin(), Frame.Index);
+                Frame.End = Frame.Container->cend();
+                auto &Item = Bindings[Frame.BindingBase + (Frame.IsObject ? 1 : 0)];
+                if(Item.Value != Item.Owned.get())
+                    Item.Value = Frame.IsObject ? &Frame.Iterator.value() : &*Frame.Iterator;
+            }
+        }
+
+        static bool Contains(const JSON &Root, const JSON* Value){
+            if(&Root == Value)
+                return true;
+            if(Root.is_structured())
+                for(const auto &Item : Root)
+                    if(Contains(Item, Value))
+                        return true;
+            return false;
         }
 
         void Visit(const IfStatementNode &Node){
-            const auto Result = EvalExpressionList(Node.Condition);
-            if(Truthy(Result.get()))
+            const bool Condition = Truthy(EvalExpressionList(Node.Condition));
+            ReleaseTemporaries();
+            if(Condition)
                 Node.TrueStatement.Accept(*this);
             else if(Node.HasFalseStatement)
                 Node.FalseStatement.Accept(*this);
@@ -517,18 +840,21 @@ namespace Sydonia{
 
         void Visit(const IncludeStatementNode &Node){
             auto SubRenderer = Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-            const auto IncludedTemplateIterator = TemplateStorageInstance.find(Node.File);
-            if(IncludedTemplateIterator != TemplateStorageInstance.end())
-                SubRenderer.RenderTo(*OutputStream, IncludedTemplateIterator->second, *DataInput, &AdditionalData);
+            const auto IncludedTemplate = TemplateStorageInstance.Find(Node.File);
+            SubRenderer.LoopStack = LoopStack;
+            // ! The pinned slots belong to this renderer's arena
+            for(auto &Frame : SubRenderer.LoopStack)
+                Frame.Pinned = 0;
+            SubRenderer.Bindings = Bindings;
+            if(IncludedTemplate)
+                SubRenderer.RenderTo(*Output, *IncludedTemplate, *DataInput, &AdditionalData);
             else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
                 ThrowRendererError("Include '" + Node.File + "' not found", Node);
         }
         
         void Visit(const ExtendsStatementNode &Node){
-            const auto IncludedTemplateIterator = TemplateStorageInstance.find(Node.File);
-            if(IncludedTemplateIterator != TemplateStorageInstance.end()){
-                const Template* ParentTemplate = &IncludedTemplateIterator->second;
-                RenderTo(*OutputStream, *ParentTemplate, *DataInput, &AdditionalData);
+            if(const Template* ParentTemplate = TemplateStorageInstance.Find(Node.File)){
+                RenderTo(*Output, *ParentTemplate, *DataInput, &AdditionalData);
                 BreakRendering = true;
             }else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
                 ThrowRendererError("Extends '" + Node.File + "' not found", Node);
@@ -541,7 +867,7 @@ namespace Sydonia{
             const auto BlockIterator = CurrentTemplate->BlockStorage.find(Node.Name);
             if(BlockIterator != CurrentTemplate->BlockStorage.end()){
                 BlockStatementStack.emplace_back(&Node);
-                BlockIterator->second->Block.Accept(*this);
+                RenderBlock(*BlockIterator->second);
                 BlockStatementStack.pop_back();
             }
             CurrentLevel = OldLevel;
@@ -549,27 +875,236 @@ namespace Sydonia{
         }
 
         void Visit(const SetStatementNode &Node){
-            std::string Pointer = Node.Key;
-            ReplaceSubString(Pointer, ".", "/");
-            Pointer = "/" + Pointer;
-            AdditionalData[JSON::json_pointer(Pointer)] = *EvalExpressionList(Node.Expression);
+            AssignData(Node, EvalExpressionList(Node.Expression));
+            ReleaseTemporaries();
+        }
+
+        void AssignData(const SetStatementNode &Node, const JSON* Value){
+            // ! Setting a loop variable copies it, the loop container is left untouched
+            for(auto Iterator = Bindings.rbegin(); Iterator != Bindings.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head)
+                    continue;
+                JSON Result = *Value;
+                // ! The value is also shared with the renderer of an include
+                if(Iterator->Value != Iterator->Owned.get() || Iterator->Owned.use_count() > 1)
+                    Iterator->Owned = std::make_shared<JSON>(*Iterator->Value);
+                else
+                    DetachLoops(*Iterator->Owned, Node.Head);
+                if(Node.Tail.empty())
+                    *Iterator->Owned = std::move(Result);
+                else
+                    (*Iterator->Owned)[Node.Tail] = std::move(Result);
+                Iterator->Value = Iterator->Owned.get();
+                return;
+            }
+            JSON Result = *Value;
+            if(!LoopStack.empty() && AdditionalData.is_object()){
+                const auto Root = AdditionalData.find(Node.Head);
+                if(Root != AdditionalData.end())
+                    DetachLoops(*Root, Node.Head);
+            }
+            AdditionalData[Node.Pointer] = std::move(Result);
+        }
+
+        bool UsesProgram(const Template &TemplateLocal) const{
+            return RenderConfigurationInstance.UseCompiledProgram && TemplateLocal.ProgramInstance.IsCompiled() && !ShadowsInvariants(TemplateLocal);
+        }
+
+        // ! Whether a loop variable or a Set made outside of the template binds a
+        // ! name its program read from the invariant data
+        bool ShadowsInvariants(const Template &TemplateLocal) const{
+            for(const auto &Head : TemplateLocal.ProgramInstance.InvariantHeads){
+                for(const auto &BindingLocal : Bindings)
+                    if(BindingLocal.Name == Head)
+                        return true;
+                if(AdditionalData.is_object() && AdditionalData.find(Head) != AdditionalData.end())
+                    return true;
+            }
+            return false;
+        }
+
+        // ! Renders the body of a block that belongs to the current template
+        void RenderBlock(const BlockStatementNode &Node){
+            if(UsesProgram(*CurrentTemplate))
+                Execute(CurrentTemplate->ProgramInstance.Blocks.at(Node.Name));
+            else
+                Node.Block.Accept(*this);
+        }
+
+        // ! Runs the program of the current template from Entry until it returns
+        void Execute(size_t Entry){
+            const Template &ProgramTemplate = *CurrentTemplate;
+            const auto &Instructions = ProgramTemplate.ProgramInstance.Instructions;
+            const size_t LoopBase = LoopStack.size();
+            size_t Counter = Entry;
+            for(;;){
+                const Instruction &Step = Instructions[Counter];
+                switch(Step.OpcodeInstance){
+                    case Opcode::Text: {
+                        Output->Write(ProgramTemplate.Content.data() + Step.Operand, Step.Length);
+                    } break;
+                    case Opcode::Literal: {
+                        DataEvalStack.push_back(&static_cast<const LiteralNode*>(Step.Node)->Value);
+                    } break;
+                    case Opcode::Constant: {
+                        DataEvalStack.push_back(&ProgramTemplate.ProgramInstance.Constants[Step.Operand]);
+                    } break;
+                    case Opcode::ConstantText: {
+                        Output->Write(ProgramTemplate.ProgramInstance.Text.data() + Step.Operand, Step.Length);
+                    } break;
+                    case Opcode::Invariant: {
+                        DataEvalStack.push_back(ProgramTemplate.ProgramInstance.Invariants[Step.Operand]);
+                    } break;
+                    case Opcode::Data: {
+                        PushData(*static_cast<const DataNode*>(Step.Node));
+                    } break;
+                    case Opcode::Operation: {
+                        ApplyOperation(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::AtId: {
+                        ApplyAtId(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::JumpIfDefined: {
+                        if(PushIfDefined(*static_cast<const FunctionNode*>(Step.Node))){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::JumpIfDecided: {
+                        if(PushIfDecided(*static_cast<const FunctionNode*>(Step.Node))){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Truthy: {
+                        PushTruthy(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::Print: {
+                        PrintData(PopExpressionResult(*static_cast<const ExpressionListNode*>(Step.Node)));
+                        ReleaseTemporaries();
+                    } break;
+                    case Opcode::Jump: {
+                        Counter = Step.Operand;
+                    } continue;
+                    case Opcode::JumpIfFalse: {
+                        const bool Condition = Truthy(PopExpressionResult(*static_cast<const ExpressionListNode*>(Step.Node)));
+                        ReleaseTemporaries();
+                        if(!Condition){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::ForArray: {
+                        const auto &Node = *static_cast<const ForArrayStatementNode*>(Step.Node);
+                        const auto Result = PopExpressionResult(Node.Condition);
+                        if(!Result->is_array())
+                            ThrowRendererError("Object must be an array", Node);
+                        const bool HasItems = BeginLoop(Node, Result);
+                        ReleaseTemporaries();
+                        if(!HasItems){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::ForObject: {
+                        const auto &Node = *static_cast<const ForObjectStatementNode*>(Step.Node);
+                        const auto Result = PopExpressionResult(Node.Condition);
+                        if(!Result->is_object())
+                            ThrowRendererError("Object must be an object", Node);
+                        const bool HasItems = BeginLoop(Node, Result);
+                        ReleaseTemporaries();
+                        if(!HasItems){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Next: {
+                        if(AdvanceLoop()){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Include: {
+                        Visit(*static_cast<const IncludeStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Extends: {
+                        Visit(*static_cast<const ExtendsStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Block: {
+                        Visit(*static_cast<const BlockStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Set: {
+                        const auto &Node = *static_cast<const SetStatementNode*>(Step.Node);
+                        AssignData(Node, PopExpressionResult(Node.Expression));
+                        ReleaseTemporaries();
+                    } break;
+                    case Opcode::Return:
+                        return;
+                }
+                if(BreakRendering){
+                    UnwindLoops(LoopBase);
+                    return;
+                }
+                ++Counter;
+            }
         }
 
         public:
-            Renderer(const RenderConfiguration &RenderConfigurationLocal, const TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
+            Renderer(const RenderConfiguration &RenderConfigurationLocal, const TemplateLookup &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
                 : RenderConfigurationInstance(RenderConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal){}
+
+            static bool Truthy(const JSON* Data){
+                if(Data->is_boolean())
+                    return Data->get<bool>();
+                else if(Data->is_number())
+                    return (*Data != 0);
+                else if(Data->is_null())
+                    return false;
+                return !Data->empty();
+            }
+
+            // ! Applies a builtin to values that are already known, used to fold
+            // ! constants, the caller has to make sure the call can not fail
+            JSON Apply(const FunctionNode &Node, const Arguments &Values){
+                for(const auto Value : Values)
+                    DataEvalStack.push_back(Value);
+                ApplyOperation(Node);
+                JSON Result = *DataEvalStack.back();
+                DataEvalStack.pop_back();
+                ReleaseTemporaries();
+                return Result;
+            }
+
+            // ! Writes a value the way an expression prints it
+            void PrintTo(OutputSink &Sink, const JSON &Value){
+                Output = &Sink;
+                PrintData(&Value);
+            }
             
             void RenderTo(std::ostream &Stream, const Template &TemplateLocal, const JSON &Data, JSON* LoopData = nullptr){
-                OutputStream = &Stream;
+                OutputSink Sink(Stream);
+                RenderTo(Sink, TemplateLocal, Data, LoopData);
+            }
+
+            void RenderTo(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data, JSON* LoopData = nullptr){
+                Output = &Sink;
                 CurrentTemplate = &TemplateLocal;
                 DataInput = &Data;
-                if(LoopData){
+                if(LoopData && LoopData != &AdditionalData)
                     AdditionalData = *LoopData;
-                    CurrentLoopData = &AdditionalData["Loop"];
-                }
                 TemplateStack.emplace_back(CurrentTemplate);
-                CurrentTemplate->Root.Accept(*this);
-                DataTempStack.clear();
+                if(UsesProgram(*CurrentTemplate))
+                    Execute(0);
+                else
+                    CurrentTemplate->Root.Accept(*this);
+                ReleaseTemporaries();
+            }
+
+            // ! Renders the next piece of a streamed template, the values set by the
+            // ! previous pieces are kept
+            void RenderPiece(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data){
+                TemplateStack.clear();
+                RenderTo(Sink, TemplateLocal, Data);
             }
     };
 }; // ! Sydonia namespace
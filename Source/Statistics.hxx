@@ -13,6 +13,9 @@
 #ifndef SYDONIA_STATISTICS_HXX
 #define SYDONIA_STATISTICS_HXX
 
+#include <string_view>
+#include <vector>
+
 #include "Node.hxx"
 
 namespace Sydonia{
@@ -23,7 +26,10 @@ namespace Sydonia{
                 SubNode->Accept(*this);
         }
         
-        void Visit(const TextNode&){}
+        void Visit(const TextNode &Node){
+            TextLength += Node.Length;
+        }
+
         void Visit(const ExpressionNode&){}
         void Visit(const LiteralNode&){}
 
@@ -37,7 +43,9 @@ namespace Sydonia{
         }
 
         void Visit(const ExpressionListNode &Node){
-            Node.Root->Accept(*this);
+            ExpressionCounter += 1;
+            if(Node.Root)
+                Node.Root->Accept(*this);
         }
 
         void Visit(const StatementNode&){}
@@ -67,11 +75,20 @@ namespace Sydonia{
             Node.Block.Accept(*this);
         }
 
-        void Visit(const SetStatementNode&){}
+        void Visit(const SetStatementNode &Node){
+            AssignedNames.emplace_back(Node.Head);
+            // ! Assigned values are not printed, only their variables are counted
+            if(Node.Expression.Root)
+                Node.Expression.Root->Accept(*this);
+        }
 
         public:
             unsigned VariableCounter;
-            explicit StatisticsVisitor(): VariableCounter(0){}
+            unsigned ExpressionCounter;
+            size_t TextLength;
+            // ! Heads of the variables the template Sets
+            std::vector<std::string_view> AssignedNames;
+            explicit StatisticsVisitor(): VariableCounter(0), ExpressionCounter(0), TextLength(0){}
     };
 }; // ! Sydonia namespace
 
@@ -13,33 +13,192 @@
 #ifndef SYDONIA_TEMPLATE_HXX
 #define SYDONIA_TEMPLATE_HXX
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Node.hxx"
+#include "NodeArena.hxx"
+#include "Program.hxx"
 #include "Statistics.hxx"
+#include "TemplateSource.hxx"
+#include "Utilities.hxx"
 
 namespace Sydonia{
+    // ! Expected output size of a template, seeded from its static text and
+    // ! refined with an exponential moving average of the rendered sizes
+    class OutputSizeEstimate{
+        // ! Rough number of bytes printed by each expression
+        static constexpr size_t BytesPerExpression {16};
+
+        std::atomic<size_t> Average {0};
+
+        public:
+            OutputSizeEstimate() = default;
+            OutputSizeEstimate(const OutputSizeEstimate &Other): Average(Other.Get()){}
+
+            OutputSizeEstimate &operator=(const OutputSizeEstimate &Other){
+                Average.store(Other.Get(), std::memory_order_relaxed);
+                return *this;
+            }
+
+            void Seed(size_t TextLength, size_t ExpressionCount){
+                Average.store(TextLength + ExpressionCount * BytesPerExpression, std::memory_order_relaxed);
+            }
+
+            size_t Get() const{
+                return Average.load(std::memory_order_relaxed);
+            }
+
+            // ! Moves the average an eighth of the way towards the observed size,
+            // ! concurrent renders may overwrite each other which only drops a sample
+            void Update(size_t Observed){
+                const size_t Current = Get();
+                Average.store(Current - Current / 8 + Observed / 8, std::memory_order_relaxed);
+            }
+    };
+
+    // ! Line index of a template content, built the first time a location is
+    // ! asked for, concurrent renders may both build it and keep either one
+    class LazyLineIndex{
+        std::shared_ptr<const LineIndex> Index;
+
+        public:
+            LazyLineIndex() = default;
+            LazyLineIndex(const LazyLineIndex &Other): Index(Other.Get()){}
+
+            LazyLineIndex &operator=(const LazyLineIndex &Other){
+                std::atomic_store(&Index, Other.Get());
+                return *this;
+            }
+
+            std::shared_ptr<const LineIndex> Get() const{
+                return std::atomic_load(&Index);
+            }
+
+            std::shared_ptr<const LineIndex> Get(std::string_view Content){
+                auto Current = Get();
+                if(!Current){
+                    Current = std::make_shared<const LineIndex>(Content);
+                    std::atomic_store(&Index, Current);
+                }
+                return Current;
+            }
+    };
+
+    // ! Replacement of Length bytes at Offset of the content of a template by Text
+    struct TemplateEdit{
+        size_t Offset {0};
+        size_t Length {0};
+        std::string Text;
+    };
+
     // ! The main Sydonia Template
     struct Template{
+        // ! Holds every node below Root, copies of a template share it
+        std::shared_ptr<NodeArena> Arena {std::make_shared<NodeArena>()};
         BlockNode Root;
-        std::string Content;
-        std::map<std::string, std::shared_ptr<BlockStatementNode>> BlockStorage;
+        // ! Keeps the bytes Content and the text nodes point into alive
+        std::shared_ptr<const TemplateSource> Source;
+        std::string_view Content;
+        std::map<std::string, BlockStatementNode*> BlockStorage;
+        // ! Values of the render invariant keys the template was compiled with
+        std::shared_ptr<const JSON> InvariantData;
+        // ! Flat form of Root produced by the Compiler once parsing is done
+        Program ProgramInstance;
+        mutable OutputSizeEstimate OutputSize;
+        // ! Nodes in the arena after the last full parse, the nodes replaced by
+        // ! a reparse stay in the arena until it is dropped
+        size_t ParsedNodeCount {0};
+        mutable LazyLineIndex Lines;
         
         explicit Template(){}
-        explicit Template(const std::string &ContentLocal): Content(ContentLocal){}
+        explicit Template(std::string ContentLocal): Template(std::make_shared<const TemplateSource>(std::move(ContentLocal))){}
+
+        explicit Template(std::shared_ptr<const TemplateSource> SourceLocal): Source(std::move(SourceLocal)), Content(Source->View()){}
 
-        // ! Return number of variables (total number, not distinct ones) in the template
+        // ! Line and column of a byte of the content
+        SourceLocation Locate(size_t Position) const{
+            return Lines.Get(Content)->Locate(Position);
+        }
+
+        // ! Line index of the content, for tools that map many positions at once
+        std::shared_ptr<const LineIndex> GetLineIndex() const{
+            return Lines.Get(Content);
+        }
+
+                // ! Return number of variables (total number, not distinct ones) in the template
         int CountVariables(){
             auto StatisticVisitor = StatisticsVisitor();
             Root.Accept(StatisticVisitor);
             return StatisticVisitor.VariableCounter;
         }
+
+        // ! Seed the output size estimate from the static text and the number of expressions
+        void EstimateOutputSize(){
+            auto StatisticVisitor = StatisticsVisitor();
+            Root.Accept(StatisticVisitor);
+            OutputSize.Seed(StatisticVisitor.TextLength, StatisticVisitor.ExpressionCounter);
+        }
     };
 
-    using TemplateStorage = std::map<std::string, Template>;
+    // ! Templates are shared between snapshots of the storage and are never
+    // ! modified once they have been added to one
+    using TemplateStorage = std::map<std::string, std::shared_ptr<const Template>>;
+
+    // ! Immutable set of included templates kept as a stack of layers, adding
+    // ! templates puts a new layer on top and merges the layers below it that
+    // ! are not larger, so each template is copied a logarithmic number of times
+    class TemplateSnapshot{
+        TemplateStorage Templates;
+        std::shared_ptr<const TemplateSnapshot> Below;
+
+        public:
+            const Template* Find(const std::string &Name) const{
+                for(auto Layer = this; Layer; Layer = Layer->Below.get()){
+                    const auto Iterator = Layer->Templates.find(Name);
+                    if(Iterator != Layer->Templates.end())
+                        return Iterator->second.get();
+                }
+                return nullptr;
+            }
+
+            // ! Returns Current with Added on top, Added replaces the templates of Current
+            static std::shared_ptr<const TemplateSnapshot> Add(std::shared_ptr<const TemplateSnapshot> Current, TemplateStorage Added){
+                while(Current && Current->Templates.size() <= Added.size()){
+                    Added.insert(Current->Templates.begin(), Current->Templates.end());
+                    Current = Current->Below;
+                }
+                auto Result = std::make_shared<TemplateSnapshot>();
+                Result->Templates = std::move(Added);
+                Result->Below = std::move(Current);
+                return Result;
+            }
+    };
+
+    // ! The included templates a renderer or an analysis can see, those found by
+    // ! the parse in progress first and then a published snapshot
+    class TemplateLookup{
+        const TemplateStorage* Discovered {nullptr};
+        const TemplateSnapshot* Shared {nullptr};
+
+        public:
+            TemplateLookup(const TemplateStorage &DiscoveredLocal, const TemplateSnapshot* SharedLocal = nullptr): Discovered(&DiscoveredLocal), Shared(SharedLocal){}
+
+            TemplateLookup(const TemplateSnapshot &SharedLocal): Shared(&SharedLocal){}
+
+            const Template* Find(const std::string &Name) const{
+                if(Discovered){
+                    const auto Iterator = Discovered->find(Name);
+                    if(Iterator != Discovered->end())
+                        return Iterator->second.get();
+                }
+                return Shared ? Shared->Find(Name) : nullptr;
+            }
+    };
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_TEMPLATE_HXX
\ No newline at end of file
@@ -0,0 +1,151 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TEMPLATE_CACHE_HXX
+#define SYDONIA_TEMPLATE_CACHE_HXX
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Template.hxx"
+
+namespace Sydonia{
+    // ! Counters of a template cache
+    struct TemplateCacheStatistics{
+        size_t Hits {0};
+        size_t Misses {0};
+        size_t Evictions {0};
+        size_t Size {0};
+        size_t Capacity {0};
+    };
+
+    // ! Parsed templates keyed by file path, an entry is only returned while the
+    // ! file keeps the modification time and size it had when it was parsed, the
+    // ! least recently used entry is dropped once the capacity is reached
+    class TemplateCache{
+        struct Entry{
+            std::shared_ptr<const Template> TemplateInstance;
+            std::filesystem::file_time_type ModifiedTime;
+            std::uintmax_t FileSize;
+            std::list<std::string>::iterator Recency;
+        };
+
+        mutable std::mutex Mutex;
+        std::unordered_map<std::string, Entry> Entries;
+        // ! Most recently used path at the front
+        std::list<std::string> RecencyList;
+        TemplateCacheStatistics StatisticsInstance;
+
+        void Evict(size_t Capacity){
+            while(Entries.size() > Capacity){
+                Entries.erase(RecencyList.back());
+                RecencyList.pop_back();
+                StatisticsInstance.Evictions += 1;
+            }
+        }
+
+        public:
+            explicit TemplateCache(size_t Capacity = 64){
+                StatisticsInstance.Capacity = Capacity;
+            }
+
+            // ! A copy starts empty with the same capacity
+            TemplateCache(const TemplateCache &Other): TemplateCache(Other.Statistics().Capacity){}
+
+            TemplateCache &operator=(const TemplateCache &Other){
+                if(this != &Other){
+                    const size_t Capacity = Other.Statistics().Capacity;
+                    std::lock_guard<std::mutex> Lock(Mutex);
+                    Entries.clear();
+                    RecencyList.clear();
+                    StatisticsInstance = TemplateCacheStatistics();
+                    StatisticsInstance.Capacity = Capacity;
+                }
+                return *this;
+            }
+
+            // ! Returns the template parsed from Path, calling Parse on a miss or when
+            // ! the file changed since it was cached, Parse runs outside of the lock
+            template<typename ParseFunction>
+            std::shared_ptr<const Template> Get(const std::string &Path, ParseFunction &&Parse){
+                std::error_code Error;
+                const auto ModifiedTime = std::filesystem::last_write_time(Path, Error);
+                const auto FileSize = Error ? 0 : std::filesystem::file_size(Path, Error);
+                if(Error){
+                    // ! Let the parser report the missing file
+                    {
+                        std::lock_guard<std::mutex> Lock(Mutex);
+                        StatisticsInstance.Misses += 1;
+                    }
+                    return std::make_shared<const Template>(Parse());
+                }
+                {
+                    std::lock_guard<std::mutex> Lock(Mutex);
+                    const auto Iterator = Entries.find(Path);
+                    if(Iterator != Entries.end()){
+                        if(Iterator->second.ModifiedTime == ModifiedTime && Iterator->second.FileSize == FileSize){
+                            RecencyList.splice(RecencyList.begin(), RecencyList, Iterator->second.Recency);
+                            StatisticsInstance.Hits += 1;
+                            return Iterator->second.TemplateInstance;
+                        }
+                        RecencyList.erase(Iterator->second.Recency);
+                        Entries.erase(Iterator);
+                    }
+                    StatisticsInstance.Misses += 1;
+                }
+                auto Result = std::make_shared<const Template>(Parse());
+                std::lock_guard<std::mutex> Lock(Mutex);
+                if(StatisticsInstance.Capacity == 0)
+                    return Result;
+                const auto Iterator = Entries.find(Path);
+                if(Iterator != Entries.end()){
+                    // ! Another thread parsed the same file meanwhile, keep the newest one
+                    Iterator->second.TemplateInstance = Result;
+                    Iterator->second.ModifiedTime = ModifiedTime;
+                    Iterator->second.FileSize = FileSize;
+                    RecencyList.splice(RecencyList.begin(), RecencyList, Iterator->second.Recency);
+                    return Result;
+                }
+                RecencyList.push_front(Path);
+                Entries.emplace(Path, Entry {Result, ModifiedTime, FileSize, RecencyList.begin()});
+                Evict(StatisticsInstance.Capacity);
+                return Result;
+            }
+
+            // ! Sets the maximum number of cached templates, zero disables caching
+            void SetCapacity(size_t Capacity){
+                std::lock_guard<std::mutex> Lock(Mutex);
+                StatisticsInstance.Capacity = Capacity;
+                Evict(Capacity);
+            }
+
+            void Clear(){
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Entries.clear();
+                RecencyList.clear();
+            }
+
+            TemplateCacheStatistics Statistics() const{
+                std::lock_guard<std::mutex> Lock(Mutex);
+                auto Result = StatisticsInstance;
+                Result.Size = Entries.size();
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_CACHE_HXX
\ No newline at end of file
@@ -0,0 +1,127 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TEMPLATE_SOURCE_HXX
+#define SYDONIA_TEMPLATE_SOURCE_HXX
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SYDONIA_MAP_FILES 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SYDONIA_MAP_FILES 0
+#endif
+
+namespace Sydonia{
+    // ! Reads a whole file into Text, in one go when its size is known and streamed
+    // ! otherwise (pipes and other files that can not seek), returns false when
+    // ! it can not be opened, text mode is kept so line endings are translated
+    // ! as they always were
+    inline bool ReadFile(const std::string &Filename, std::string &Text){
+        std::ifstream File(Filename);
+        if(File.fail())
+            return false;
+        File.seekg(0, std::ios::end);
+        const std::streamoff Size = File.tellg();
+        if(Size < 0){
+            File.clear();
+            Text.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+            return true;
+        }
+        File.seekg(0, std::ios::beg);
+        Text.resize(static_cast<size_t>(Size));
+        File.read(&Text[0], Size);
+        Text.resize(static_cast<size_t>(File.gcount()));
+        return true;
+    }
+
+    // ! Read-only bytes a template is parsed from, a string it owns or a private
+    // ! mapping of a file, a template and its copies share it and the text nodes
+    // ! slice into it, so a mapped file must be replaced rather than rewritten
+    // ! in place while a template parsed from it is alive
+    class TemplateSource{
+        // ! Below this size setting up a mapping costs more than copying the file
+        static constexpr size_t MinimumMappedSize {65536};
+
+        std::string Text;
+        const char* Mapping {nullptr};
+        size_t MappingSize {0};
+
+        TemplateSource() = default;
+
+        public:
+            explicit TemplateSource(std::string TextLocal): Text(std::move(TextLocal)){}
+
+            TemplateSource(const TemplateSource&) = delete;
+            TemplateSource &operator=(const TemplateSource&) = delete;
+
+            ~TemplateSource(){
+#if SYDONIA_MAP_FILES
+                if(Mapping)
+                    munmap(const_cast<char*>(Mapping), MappingSize);
+#endif
+            }
+
+            std::string_view View() const{
+                return Mapping ? std::string_view(Mapping, MappingSize) : std::string_view(Text);
+            }
+
+            // ! Copies the file into memory, nullptr when it can not be opened
+            static std::shared_ptr<const TemplateSource> Read(const std::string &Filename){
+                std::string TextLocal;
+                if(!ReadFile(Filename, TextLocal))
+                    return nullptr;
+                return std::make_shared<const TemplateSource>(std::move(TextLocal));
+            }
+
+            // ! Maps the file, the pages are shared with every other process that
+            // ! maps it, small files are copied, nullptr when it can not be opened
+            static std::shared_ptr<const TemplateSource> Map(const std::string &Filename){
+#if SYDONIA_MAP_FILES
+                const int Descriptor = open(Filename.c_str(), O_RDONLY | O_CLOEXEC);
+                if(Descriptor < 0)
+                    return nullptr;
+                struct stat Status;
+                if(fstat(Descriptor, &Status) != 0 || !S_ISREG(Status.st_mode) || static_cast<size_t>(Status.st_size) < MinimumMappedSize){
+                    close(Descriptor);
+                    return Read(Filename);
+                }
+                const size_t Size = static_cast<size_t>(Status.st_size);
+                int Flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+                // ! The whole file is lexed right away, fault it in with one call
+                Flags |= MAP_POPULATE;
+#endif
+                void* Address = mmap(nullptr, Size, PROT_READ, Flags, Descriptor, 0);
+                close(Descriptor);
+                if(Address == MAP_FAILED)
+                    return Read(Filename);
+                std::shared_ptr<TemplateSource> Result(new TemplateSource());
+                Result->Mapping = static_cast<const char*>(Address);
+                Result->MappingSize = Size;
+                return Result;
+#else
+                return Read(Filename);
+#endif
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_SOURCE_HXX
\ No newline at end of file
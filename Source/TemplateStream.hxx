@@ -0,0 +1,164 @@
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TEMPLATE_STREAM_HXX
+#define SYDONIA_TEMPLATE_STREAM_HXX
+
+#include <algorithm>
+#include <istream>
+#include <string>
+
+#include "Configuration.hxx"
+#include "Lexer.hxx"
+#include "Token.hxx"
+
+namespace Sydonia{
+    // ! Splits a template read from a stream into pieces that parse on their own,
+    // ! a piece always ends in static text outside of any statement, so only the
+    // ! statement being read and a little trailing text are held in memory
+    class TemplateStream{
+        static constexpr size_t ChunkSize {65536};
+
+        std::istream &Input;
+        Lexer LexerInstance;
+        // ! Bytes at the end of the window that could still become an opener
+        const size_t OpenLookahead;
+        // ! Unread part of the template, after the first piece it starts with one
+        // ! byte standing for the one before it ('\n' or ' ') so the lexer knows
+        // ! whether it is at the start of a line
+        std::string Window;
+        size_t Start {0};
+        size_t ReadSize {ChunkSize};
+        bool Ended {false};
+
+        static size_t LongestOpener(const LexerConfiguration &Configuration){
+            return std::max({Configuration.StatementOpen.size(), Configuration.StatementOpenNoLstrip.size(), Configuration.StatementOpenForceLstrip.size(),
+                            Configuration.ExpressionOpen.size(), Configuration.ExpressionOpenForceLstrip.size(), Configuration.CommentOpen.size(),
+                            Configuration.CommentOpenForceLstrip.size(), Configuration.LineStatement.size()});
+        }
+
+        void Fill(){
+            const size_t Size = Window.size();
+            Window.resize(Size + ReadSize);
+            Input.read(&Window[Size], ReadSize);
+            Window.resize(Size + static_cast<size_t>(Input.gcount()));
+            if(Window.size() == Size)
+                Ended = true;
+        }
+
+        // ! Last offset of the window where it can be split, zero when there is
+        // ! none, the text before it has to be final whatever is read next
+        size_t FindCut(){
+            LexerInstance.Start(Window, Start);
+            const size_t Settled = (Window.size() > OpenLookahead) ? Window.size() - OpenLookahead : 0;
+            size_t Depth = 0, Cut = 0, PreviousEnd = Start;
+            for(;;){
+                const Token TokenInstance = LexerInstance.Scan();
+                if(TokenInstance.KindInstance == Token::Kind::Eof)
+                    break;
+                const size_t Begin = TokenInstance.Text.data() - Window.data();
+                size_t End = Begin + TokenInstance.Text.size();
+                switch(TokenInstance.KindInstance){
+                    case Token::Kind::Text: {
+                        if(Depth != 0 || Begin >= Settled)
+                            break;
+                        if(End <= Settled && End < Window.size()){
+                            // ! Followed by a whole opener, trimming already happened
+                            Cut = End;
+                            break;
+                        }
+                        // ! Runs into the unread part, keep the end of the last line when it
+                        // ! is blank so a trimming opener after it still sees all of it
+                        size_t Candidate = Settled;
+                        while(Candidate > Begin && Window[Candidate - 1] != '\n' && Window[Candidate - 1] != '\r' &&
+                            (Window[Candidate] == ' ' || Window[Candidate] == '\t'))
+                            Candidate -= 1;
+                        if(Candidate > Begin)
+                            Cut = Candidate;
+                    } break;
+                    case Token::Kind::StatementOpen:
+                    case Token::Kind::LineStatementOpen: {
+                        if(Depth == 0 && Begin == PreviousEnd && Begin > Start && Begin <= Settled)
+                            Cut = Begin;
+                        const Token Name = LexerInstance.Scan();
+                        if(Name.KindInstance == Token::Kind::Eof)
+                            return Cut;
+                        switch(Name.KeywordInstance){
+                            case Token::Keyword::If:
+                            case Token::Keyword::For:
+                            case Token::Keyword::Block:
+                                Depth += 1;
+                                break;
+                            case Token::Keyword::EndIf:
+                            case Token::Keyword::EndFor:
+                            case Token::Keyword::EndBlock:
+                                Depth -= (Depth > 0) ? 1 : 0;
+                                break;
+                            default:
+                                break;
+                        }
+                        End = (Name.Text.data() - Window.data()) + Name.Text.size();
+                    } break;
+                    case Token::Kind::ExpressionOpen:
+                    case Token::Kind::CommentOpen: {
+                        if(Depth == 0 && Begin == PreviousEnd && Begin > Start && Begin <= Settled)
+                            Cut = Begin;
+                    } break;
+                    default:
+                        break;
+                }
+                PreviousEnd = End;
+            }
+            return Cut;
+        }
+
+        public:
+            explicit TemplateStream(std::istream &InputLocal, const LexerConfiguration &LexerConfigurationLocal)
+                : Input(InputLocal), LexerInstance(LexerConfigurationLocal), OpenLookahead(LongestOpener(LexerConfigurationLocal)){}
+
+            // ! Moves the next piece into Piece, the template starts at Offset within
+            // ! it, returns false once the stream is exhausted
+            bool Next(std::string &Piece, size_t &Offset){
+                for(;;){
+                    if(Ended){
+                        if(Window.size() <= Start)
+                            return false;
+                        Piece = std::move(Window);
+                        Offset = Start;
+                        Window.clear();
+                        Start = 0;
+                        return true;
+                    }
+                    Fill();
+                    if(Ended)
+                        continue;
+                    const size_t Cut = FindCut();
+                    if(Cut > Start){
+                        std::string Rest(1, (Window[Cut - 1] == '\n') ? '\n' : ' ');
+                        Rest.append(Window, Cut, std::string::npos);
+                        Window.resize(Cut);
+                        Piece = std::move(Window);
+                        Offset = Start;
+                        Window = std::move(Rest);
+                        Start = 1;
+                        ReadSize = ChunkSize;
+                        return true;
+                    }
+                    // ! Inside a long statement, read more at once so the window is not
+                    // ! scanned over and over
+                    ReadSize *= 2;
+                }
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_STREAM_HXX
\ No newline at end of file
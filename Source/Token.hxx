@@ -13,6 +13,8 @@
 #ifndef SYDONIA_TOKEN_HXX
 #define SYDONIA_TOKEN_HXX
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -57,12 +59,42 @@ namespace Sydonia{
             Eof,
         };
 
+        // ! Identifiers that are reserved words, they keep the Id kind so they can
+        // ! still be used where any name is accepted
+        enum class Keyword : std::uint8_t{
+            None,
+            If,
+            Else,
+            EndIf,
+            Block,
+            EndBlock,
+            For,
+            EndFor,
+            In,
+            Include,
+            Extends,
+            Set,
+            And,
+            Or,
+            Not,
+            True,
+            False,
+            Null,
+        };
+
         Kind KindInstance {Kind::Unknown};
+        Keyword KeywordInstance {Keyword::None};
         std::string_view Text;
 
         explicit constexpr Token() = default;
         explicit constexpr Token(Kind KindLocalInstance, std::string_view TextLocal)
             : KindInstance(KindLocalInstance), Text(TextLocal){}
+        explicit constexpr Token(Kind KindLocalInstance, Keyword KeywordLocal, std::string_view TextLocal)
+            : KindInstance(KindLocalInstance), KeywordInstance(KeywordLocal), Text(TextLocal){}
+
+        bool Is(Keyword KeywordLocal) const{
+            return KindInstance == Kind::Id && KeywordInstance == KeywordLocal;
+        }
 
         std::string Describe() const{
             switch(KindInstance){
@@ -77,6 +109,56 @@ namespace Sydonia{
             }
         } 
     };
+
+    namespace Keywords{
+        struct Entry{
+            std::string_view Text;
+            Token::Keyword KeywordInstance {Token::Keyword::None};
+        };
+
+        constexpr std::array<Entry, 17> List {{
+            {"If", Token::Keyword::If}, {"Else", Token::Keyword::Else}, {"EndIf", Token::Keyword::EndIf},
+            {"Block", Token::Keyword::Block}, {"EndBlock", Token::Keyword::EndBlock}, {"For", Token::Keyword::For},
+            {"EndFor", Token::Keyword::EndFor}, {"In", Token::Keyword::In}, {"Include", Token::Keyword::Include},
+            {"Extends", Token::Keyword::Extends}, {"Set", Token::Keyword::Set}, {"And", Token::Keyword::And},
+            {"Or", Token::Keyword::Or}, {"Not", Token::Keyword::Not}, {"True", Token::Keyword::True},
+            {"False", Token::Keyword::False}, {"NULL", Token::Keyword::Null},
+        }};
+
+        constexpr size_t TableSize {32};
+
+        // ! Perfect hash over the keyword list, length plus first and last
+        // ! character tell every keyword apart
+        constexpr size_t Hash(std::string_view Text){
+            return (Text.size() * 4 + static_cast<unsigned char>(Text.front()) * 20 + static_cast<unsigned char>(Text.back())) % TableSize;
+        }
+
+        constexpr std::array<Entry, TableSize> BuildTable(){
+            std::array<Entry, TableSize> Result {};
+            for(const auto &EntryInstance : List)
+                Result[Hash(EntryInstance.Text)] = EntryInstance;
+            return Result;
+        }
+
+        constexpr std::array<Entry, TableSize> Table = BuildTable();
+
+        constexpr bool IsPerfect(){
+            for(const auto &EntryInstance : List)
+                if(Table[Hash(EntryInstance.Text)].KeywordInstance != EntryInstance.KeywordInstance)
+                    return false;
+            return true;
+        }
+
+        static_assert(IsPerfect(), "Two keywords share a slot of the keyword table");
+
+        // ! Keyword spelled by Text, None for any other identifier
+        inline Token::Keyword Classify(std::string_view Text){
+            if(Text.size() < 2 || Text.size() > 8)
+                return Token::Keyword::None;
+            const Entry &EntryInstance = Table[Hash(Text)];
+            return EntryInstance.Text == Text ? EntryInstance.KeywordInstance : Token::Keyword::None;
+        }
+    }; // ! Keywords namespace
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_TOKEN_HXX
\ No newline at end of file
@@ -14,10 +14,12 @@
 #define SYDONIA_UTILITIES_HXX
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "Exceptions.hxx"
 
@@ -44,21 +46,47 @@ namespace Sydonia{
     inline SourceLocation GetSourceLocation(std::string_view Content, size_t Position){
         // ! Get line and offset position (starts at 1:1)
         auto Sliced = StringView::Slice(Content, 0, Position);
-        std::size_t LastNewLine = Sliced.rfind("\n");
+        const size_t LastNewLine = Sliced.rfind('\n');
         if(LastNewLine == std::string_view::npos)
             return {1, Sliced.length() + 1};
-        // ! Count newlines
-        size_t CountLines = 0;
-        size_t SearchStart = 0;
-        while(SearchStart <= Sliced.size()){
-            SearchStart = Sliced.find("\n", SearchStart) + 1;
-            if(SearchStart == 0)
-                break;
-            CountLines += 1;
-        }
+        const size_t CountLines = static_cast<size_t>(std::count(Sliced.begin(), Sliced.begin() + LastNewLine + 1, '\n'));
         return {CountLines + 1, Sliced.length() - LastNewLine};
     }
 
+    // ! Offsets where the lines of a text start, a location is found with a
+    // ! binary search instead of counting the newlines before it
+    class LineIndex{
+        std::vector<size_t> LineStarts {0};
+        size_t Size;
+
+        public:
+            explicit LineIndex(std::string_view Content): Size(Content.size()){
+                for(const char* Current = Content.data(), *End = Content.data() + Content.size();;){
+                    const void* NewLine = std::memchr(Current, '\n', End - Current);
+                    if(!NewLine)
+                        break;
+                    Current = static_cast<const char*>(NewLine) + 1;
+                    LineStarts.emplace_back(Current - Content.data());
+                }
+            }
+
+            size_t LineCount() const{
+                return LineStarts.size();
+            }
+
+            // ! Offset of the first character of Line (starts at 1)
+            size_t LineStart(size_t Line) const{
+                return LineStarts.at(Line - 1);
+            }
+
+            // ! Same result as GetSourceLocation over the indexed text
+            SourceLocation Locate(size_t Position) const{
+                Position = std::min(Position, Size);
+                const size_t Line = std::upper_bound(LineStarts.begin(), LineStarts.end(), Position) - LineStarts.begin();
+                return {Line, Position - LineStarts[Line - 1] + 1};
+            }
+    };
+
     inline void ReplaceSubString(std::string &S, const std::string &F, const std::string &T){
         if(F.empty())
             return;
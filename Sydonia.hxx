@@ -50,9 +50,12 @@ namespace Sydonia{
 #ifndef SYDONIA_ENVIRONMENT_HXX
 #define SYDONIA_ENVIRONMENT_HXX
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -73,8 +76,119 @@ namespace Sydonia{
 #define SYDONIA_CONFIGURATION_HXX
 
 #include <functional>
+#include <memory>
 #include <string>
 
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_OPENER_MATCHER_HXX
+#define SYDONIA_OPENER_MATCHER_HXX
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Sydonia{
+    // ! Opening sequences the lexer looks for in static text
+    enum class Opener : std::uint8_t{
+        Expression,
+        ExpressionForceLstrip,
+        Statement,
+        StatementNoLstrip,
+        StatementForceLstrip,
+        Comment,
+        CommentForceLstrip,
+        LineStatement,
+    };
+
+    // ! Trie over the opening sequences of a lexer configuration, one walk from
+    // ! a candidate position reports every opener that starts there, so custom
+    // ! delimiters cost the same as the default ones
+    class OpenerMatcher{
+        struct Node{
+            // ! Few children per node, a linear search beats a table here
+            std::vector<std::pair<char, std::uint16_t>> Children;
+            std::uint8_t Terminals {0};
+        };
+
+        // ! First character of the sequences, zero when no sequence starts with it
+        std::array<std::uint16_t, 256> RootChildren {};
+        std::vector<Node> Nodes {Node()};
+
+        public:
+            using Set = std::uint8_t;
+
+            static constexpr Set Bit(Opener OpenerLocal){
+                return static_cast<Set>(1u << static_cast<unsigned>(OpenerLocal));
+            }
+
+            void Clear(){
+                RootChildren.fill(0);
+                Nodes.assign(1, Node());
+            }
+
+            void Add(std::string_view Sequence, Opener OpenerLocal){
+                if(Sequence.empty())
+                    return;
+                std::uint16_t Current = RootChildren[static_cast<unsigned char>(Sequence[0])];
+                if(Current == 0){
+                    Current = static_cast<std::uint16_t>(Nodes.size());
+                    Nodes.emplace_back();
+                    RootChildren[static_cast<unsigned char>(Sequence[0])] = Current;
+                }
+                for(size_t Iterator = 1; Iterator < Sequence.size(); Iterator += 1){
+                    std::uint16_t Next = 0;
+                    for(const auto &Child : Nodes[Current].Children)
+                        if(Child.first == Sequence[Iterator]){
+                            Next = Child.second;
+                            break;
+                        }
+                    if(Next == 0){
+                        Next = static_cast<std::uint16_t>(Nodes.size());
+                        Nodes.emplace_back();
+                        Nodes[Current].Children.emplace_back(Sequence[Iterator], Next);
+                    }
+                    Current = Next;
+                }
+                Nodes[Current].Terminals |= Bit(OpenerLocal);
+            }
+
+            // ! Set of the openers that are a prefix of Input
+            Set Match(std::string_view Input) const{
+                if(Input.empty())
+                    return 0;
+                std::uint16_t Current = RootChildren[static_cast<unsigned char>(Input[0])];
+                Set Result = 0;
+                for(size_t Iterator = 1; Current != 0; Iterator += 1){
+                    Result |= Nodes[Current].Terminals;
+                    if(Iterator >= Input.size())
+                        break;
+                    std::uint16_t Next = 0;
+                    for(const auto &Child : Nodes[Current].Children)
+                        if(Child.first == Input[Iterator]){
+                            Next = Child.second;
+                            break;
+                        }
+                    Current = Next;
+                }
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_OPENER_MATCHER_HXX
 /***
  * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
  * Licensed under the MIT license. See LICENSE file in the project root 
@@ -90,9 +204,11 @@ namespace Sydonia{
 #ifndef SYDONIA_TEMPLATE_HXX
 #define SYDONIA_TEMPLATE_HXX
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /***
@@ -110,9 +226,11 @@ namespace Sydonia{
 #ifndef SYDONIA_NODE_HXX
 #define SYDONIA_NODE_HXX
 
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 /***
  * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
@@ -129,13 +247,64 @@ namespace Sydonia{
 #ifndef SYDONIA_FUNCTION_STORAGE_HXX
 #define SYDONIA_FUNCTION_STORAGE_HXX
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
 namespace Sydonia{
     using Arguments = std::vector<const JSON*>;
+
+    // ! The arguments of a call as they sit in the renderer, nothing is copied
+    class ArgumentSpan{
+        const JSON* const* Data;
+        size_t Count;
+
+        public:
+            ArgumentSpan(const JSON* const* DataLocal, size_t CountLocal): Data(DataLocal), Count(CountLocal){}
+
+            size_t Size() const{
+                return Count;
+            }
+
+            const JSON &operator[](size_t Index) const{
+                return *Data[Index];
+            }
+
+            const JSON* const* begin() const{
+                return Data;
+            }
+
+            const JSON* const* end() const{
+                return Data + Count;
+            }
+    };
+
+    // ! The arguments of a lazy callback, each one is evaluated the first time
+    // ! it is asked for and kept for the rest of the call
+    class LazyArguments{
+        public:
+            virtual ~LazyArguments() = default;
+
+            virtual size_t Size() const = 0;
+            virtual const JSON &operator[](size_t Index) = 0;
+    };
+
     using CallbackFunction = std::function<JSON(Arguments &LocalArguments)>;
     using VoidCallbackFunction = std::function<void(Arguments &LocalArguments)>;
+    // ! Writes its result into a slot owned by the renderer, the slot may still
+    // ! hold the value of an earlier call so its storage can be reused
+    using ResultCallbackFunction = std::function<void(ArgumentSpan LocalArguments, JSON &Result)>;
+    using LazyCallbackFunction = std::function<void(LazyArguments &LocalArguments, JSON &Result)>;
+
+    // ! A user callback in any of its forms, shared by the storage and the nodes bound to it
+    struct Callable{
+        CallbackFunction Function;
+        ResultCallbackFunction ResultFunction;
+        LazyCallbackFunction LazyFunction;
+    };
 
     // ! Class for builtin functions and user-defined callbacks
     class FunctionStorage{
@@ -193,68 +362,141 @@ namespace Sydonia{
             };
 
             struct FunctionData{
-                explicit FunctionData(const Operation &OperationLocal, const CallbackFunction &CallbackLocal = CallbackFunction{})
-                    : OperationInstance(OperationLocal), Callback(CallbackLocal){}
+                explicit FunctionData(const Operation &OperationLocal, std::shared_ptr<const Callable> CallbackLocal = nullptr)
+                    : OperationInstance(OperationLocal), Callback(std::move(CallbackLocal)){}
                 const Operation OperationInstance;
-                const CallbackFunction Callback;
+                const std::shared_ptr<const Callable> Callback;
             };
         private:
-            const int Variadic {-1};
-
-            std::map<std::pair<std::string, int>, FunctionData> FunctionStorage = {
-                {std::make_pair("At", 2), FunctionData {Operation::At}},
-                {std::make_pair("Default", 2), FunctionData {Operation::Default}},
-                {std::make_pair("DivisibleBy", 2), FunctionData {Operation::DivisibleBy}},
-                {std::make_pair("Even", 1), FunctionData {Operation::Even}},
-                {std::make_pair("Exists", 1), FunctionData {Operation::Exists}},
-                {std::make_pair("ExistsIn", 2), FunctionData {Operation::ExistsInObject}},
-                {std::make_pair("First", 1), FunctionData {Operation::First}},
-                {std::make_pair("Float", 1), FunctionData {Operation::Float}},
-                {std::make_pair("Int", 1), FunctionData {Operation::Int}},
-                {std::make_pair("IsArray", 1), FunctionData {Operation::IsArray}},
-                {std::make_pair("IsBoolean", 1), FunctionData {Operation::IsBoolean}},
-                {std::make_pair("IsFloat", 1), FunctionData {Operation::IsFloat}},
-                {std::make_pair("IsInteger", 1), FunctionData {Operation::IsInteger}},
-                {std::make_pair("IsNumber", 1), FunctionData {Operation::IsNumber}},
-                {std::make_pair("IsObject", 1), FunctionData {Operation::IsObject}},
-                {std::make_pair("IsString", 1), FunctionData {Operation::IsString}},
-                {std::make_pair("Last", 1), FunctionData {Operation::Last}},
-                {std::make_pair("Length", 1), FunctionData {Operation::Length}},
-                {std::make_pair("Lower", 1), FunctionData {Operation::Lower}},
-                {std::make_pair("Max", 1), FunctionData {Operation::Max}},
-                {std::make_pair("Min", 1), FunctionData {Operation::Min}},
-                {std::make_pair("Odd", 1), FunctionData {Operation::Odd}},
-                {std::make_pair("Range", 1), FunctionData {Operation::Range}},
-                {std::make_pair("Round", 2), FunctionData {Operation::Round}},
-                {std::make_pair("Sort", 1), FunctionData {Operation::Sort}},
-                {std::make_pair("Upper", 1), FunctionData {Operation::Upper}},
-                {std::make_pair("Super", 0), FunctionData {Operation::Super}},
-                {std::make_pair("Super", 1), FunctionData {Operation::Super}},
-                {std::make_pair("Join", 2), FunctionData {Operation::Join}},  
+            static constexpr int Variadic {-1};
+
+            struct Entry{
+                std::string Name;
+                int NumArgs;
+                size_t Hash;
+                FunctionData Data;
             };
 
+            struct Builtin{
+                std::string_view Name;
+                int NumArgs;
+                Operation OperationInstance;
+            };
+
+            // ! Functions in the order they were added, the first one added under a
+            // ! name and number of arguments is the one that is found
+            std::vector<Entry> Entries;
+            // ! Open addressing table of indexes into Entries plus one, zero is an
+            // ! empty slot, its size is a power of two kept at least twice Entries
+            std::vector<uint32_t> Slots;
+
+            static size_t HashOf(std::string_view Name, int NumArgs){
+                // ! FNV-1a over the name, then the number of arguments mixed in
+                uint64_t Hash = 14695981039346656037ull;
+                for(const char Character : Name){
+                    Hash ^= static_cast<unsigned char>(Character);
+                    Hash *= 1099511628211ull;
+                }
+                Hash ^= static_cast<uint64_t>(static_cast<uint32_t>(NumArgs));
+                Hash *= 1099511628211ull;
+                return static_cast<size_t>(Hash ^ (Hash >> 32));
+            }
+
+            const Entry* Find(std::string_view Name, int NumArgs) const{
+                if(Slots.empty())
+                    return nullptr;
+                const size_t Hash = HashOf(Name, NumArgs);
+                const size_t Mask = Slots.size() - 1;
+                for(size_t Slot = Hash & Mask; Slots[Slot] != 0; Slot = (Slot + 1) & Mask){
+                    const Entry &Candidate = Entries[Slots[Slot] - 1];
+                    if(Candidate.Hash == Hash && Candidate.NumArgs == NumArgs && Candidate.Name == Name)
+                        return &Candidate;
+                }
+                return nullptr;
+            }
+
+            void Insert(size_t Index){
+                const size_t Mask = Slots.size() - 1;
+                size_t Slot = Entries[Index].Hash & Mask;
+                while(Slots[Slot] != 0)
+                    Slot = (Slot + 1) & Mask;
+                Slots[Slot] = static_cast<uint32_t>(Index + 1);
+            }
+
+            void Add(std::string_view Name, int NumArgs, FunctionData &&Data){
+                if(Find(Name, NumArgs))
+                    return;
+                Entries.push_back(Entry {static_cast<std::string>(Name), NumArgs, HashOf(Name, NumArgs), std::move(Data)});
+                if(Entries.size() * 2 > Slots.size()){
+                    Slots.assign(std::max<size_t>(64, Slots.size() * 2), 0);
+                    for(size_t Index = 0; Index < Entries.size(); Index += 1)
+                        Insert(Index);
+                }else
+                    Insert(Entries.size() - 1);
+            }
+
         public:
+            FunctionStorage(){
+                static constexpr Builtin Builtins[] = {
+                    {"At", 2, Operation::At},
+                    {"Default", 2, Operation::Default},
+                    {"DivisibleBy", 2, Operation::DivisibleBy},
+                    {"Even", 1, Operation::Even},
+                    {"Exists", 1, Operation::Exists},
+                    {"ExistsIn", 2, Operation::ExistsInObject},
+                    {"First", 1, Operation::First},
+                    {"Float", 1, Operation::Float},
+                    {"Int", 1, Operation::Int},
+                    {"IsArray", 1, Operation::IsArray},
+                    {"IsBoolean", 1, Operation::IsBoolean},
+                    {"IsFloat", 1, Operation::IsFloat},
+                    {"IsInteger", 1, Operation::IsInteger},
+                    {"IsNumber", 1, Operation::IsNumber},
+                    {"IsObject", 1, Operation::IsObject},
+                    {"IsString", 1, Operation::IsString},
+                    {"Last", 1, Operation::Last},
+                    {"Length", 1, Operation::Length},
+                    {"Lower", 1, Operation::Lower},
+                    {"Max", 1, Operation::Max},
+                    {"Min", 1, Operation::Min},
+                    {"Odd", 1, Operation::Odd},
+                    {"Range", 1, Operation::Range},
+                    {"Round", 2, Operation::Round},
+                    {"Sort", 1, Operation::Sort},
+                    {"Upper", 1, Operation::Upper},
+                    {"Super", 0, Operation::Super},
+                    {"Super", 1, Operation::Super},
+                    {"Join", 2, Operation::Join},
+                };
+                for(const auto &BuiltinLocal : Builtins)
+                    AddBuiltin(BuiltinLocal.Name, BuiltinLocal.NumArgs, BuiltinLocal.OperationInstance);
+            }
+
             void AddBuiltin(std::string_view Name, int NumArgs, Operation OperationLocal){
-                FunctionStorage.emplace(std::make_pair(static_cast<std::string>(Name), NumArgs), FunctionData {OperationLocal});
+                Add(Name, NumArgs, FunctionData {OperationLocal});
             }
 
             void AddCallback(std::string_view Name, int NumArgs, const CallbackFunction &CallbackLocal){
-                FunctionStorage.emplace(std::make_pair(static_cast<std::string>(Name), NumArgs), FunctionData {Operation::Callback, CallbackLocal});
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {CallbackLocal, nullptr, nullptr})});
             }
 
-            FunctionData FindFunction(std::string_view Name, int NumArgs) const{
-                auto Iterator = FunctionStorage.find(std::make_pair(static_cast<std::string>(Name), NumArgs));
-                if(Iterator != FunctionStorage.end())
-                    return Iterator->second;
-                // ! Find variadic function
-                else if(NumArgs > 0){
-                    Iterator = FunctionStorage.find(std::make_pair(static_cast<std::string>(Name), Variadic));
-                    if(Iterator != FunctionStorage.end())
-                        return Iterator->second;
-                }
+            void AddResultCallback(std::string_view Name, int NumArgs, const ResultCallbackFunction &CallbackLocal){
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {nullptr, CallbackLocal, nullptr})});
+            }
 
-                return FunctionData {Operation::None};
-            };
+            void AddLazyCallback(std::string_view Name, int NumArgs, const LazyCallbackFunction &CallbackLocal){
+                Add(Name, NumArgs, FunctionData {Operation::Callback, std::make_shared<const Callable>(Callable {nullptr, nullptr, CallbackLocal})});
+            }
+
+            // ! The reference is valid until the next function is added
+            const FunctionData &FindFunction(std::string_view Name, int NumArgs) const{
+                static const FunctionData NotFound {Operation::None};
+                const Entry* Found = Find(Name, NumArgs);
+                // ! Find variadic function
+                if(!Found && NumArgs > 0)
+                    Found = Find(Name, Variadic);
+                return Found ? Found->Data : NotFound;
+            }
     };
 }; // ! Sydonia namespace
 
@@ -275,10 +517,12 @@ namespace Sydonia{
 #define SYDONIA_UTILITIES_HXX
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 /***
  * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
@@ -333,6 +577,10 @@ namespace Sydonia{
     struct DataError : public SydoniaError{
         explicit DataError(const std::string &Message, SourceLocation Location): SydoniaError("DataError", Message, Location){}
     };
+
+    struct EnvironmentError : public SydoniaError{
+        explicit EnvironmentError(const std::string &Message): SydoniaError("EnvironmentError", Message){}
+    };
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_EXCEPTIONS_HXX
@@ -360,21 +608,47 @@ namespace Sydonia{
     inline SourceLocation GetSourceLocation(std::string_view Content, size_t Position){
         // ! Get line and offset position (starts at 1:1)
         auto Sliced = StringView::Slice(Content, 0, Position);
-        std::size_t LastNewLine = Sliced.rfind("\n");
+        const size_t LastNewLine = Sliced.rfind('\n');
         if(LastNewLine == std::string_view::npos)
             return {1, Sliced.length() + 1};
-        // ! Count newlines
-        size_t CountLines = 0;
-        size_t SearchStart = 0;
-        while(SearchStart <= Sliced.size()){
-            SearchStart = Sliced.find("\n", SearchStart) + 1;
-            if(SearchStart == 0)
-                break;
-            CountLines += 1;
-        }
+        const size_t CountLines = static_cast<size_t>(std::count(Sliced.begin(), Sliced.begin() + LastNewLine + 1, '\n'));
         return {CountLines + 1, Sliced.length() - LastNewLine};
     }
 
+    // ! Offsets where the lines of a text start, a location is found with a
+    // ! binary search instead of counting the newlines before it
+    class LineIndex{
+        std::vector<size_t> LineStarts {0};
+        size_t Size;
+
+        public:
+            explicit LineIndex(std::string_view Content): Size(Content.size()){
+                for(const char* Current = Content.data(), *End = Content.data() + Content.size();;){
+                    const void* NewLine = std::memchr(Current, '\n', End - Current);
+                    if(!NewLine)
+                        break;
+                    Current = static_cast<const char*>(NewLine) + 1;
+                    LineStarts.emplace_back(Current - Content.data());
+                }
+            }
+
+            size_t LineCount() const{
+                return LineStarts.size();
+            }
+
+            // ! Offset of the first character of Line (starts at 1)
+            size_t LineStart(size_t Line) const{
+                return LineStarts.at(Line - 1);
+            }
+
+            // ! Same result as GetSourceLocation over the indexed text
+            SourceLocation Locate(size_t Position) const{
+                Position = std::min(Position, Size);
+                const size_t Line = std::upper_bound(LineStarts.begin(), LineStarts.end(), Position) - LineStarts.begin();
+                return {Line, Position - LineStarts[Line - 1] + 1};
+            }
+    };
+
     inline void ReplaceSubString(std::string &S, const std::string &F, const std::string &T){
         if(F.empty())
             return;
@@ -439,7 +713,8 @@ namespace Sydonia{
 
     class BlockNode : public AstNode{
         public:
-            std::vector<std::shared_ptr<AstNode>> Nodes;
+            // ! Owned by the NodeArena of the template
+            std::vector<AstNode*> Nodes;
             explicit BlockNode(): AstNode(0){}
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
@@ -466,7 +741,7 @@ namespace Sydonia{
     class LiteralNode : public ExpressionNode{
         public:
             const JSON Value;
-            explicit LiteralNode(std::string_view DataText, size_t Position): ExpressionNode(Position), Value(JSON::parse(DataText)){}
+            explicit LiteralNode(JSON ValueLocal, size_t Position): ExpressionNode(Position), Value(std::move(ValueLocal)){}
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
             }
@@ -474,8 +749,64 @@ namespace Sydonia{
 
     class DataNode : public ExpressionNode{
         public:
+            // ! A segment of a dotted name, Index holds the segment as an array
+            // ! index when it is a number so arrays are walked without parsing
+            struct PathSegment{
+                std::string Key;
+                size_t Index;
+            };
+
             const std::string Name;
-            const JSON::json_pointer Pointer;
+            const std::vector<PathSegment> Path;
+
+            // ! Member of the Loop variable a name refers to, Depth counts the
+            // ! Parent segments in between, anything else materializes the frame
+            struct LoopAccess{
+                enum class Member{
+                    None,
+                    Frame,
+                    Index,
+                    Index1,
+                    IsFirst,
+                    IsLast
+                };
+
+                Member MemberInstance;
+                size_t Depth;
+            };
+
+            const LoopAccess LoopAccessInstance;
+            // ! Callback taking no arguments the name was bound to while parsing,
+            // ! called when the render data does not hold the name
+            std::shared_ptr<const Callable> Callback;
+
+            static LoopAccess ParseLoopAccess(std::string_view PointerName){
+                using Member = LoopAccess::Member;
+                std::string_view Part;
+                std::tie(Part, PointerName) = StringView::Split(PointerName, '.');
+                if(Part != "Loop")
+                    return LoopAccess {Member::None, 0};
+                size_t Depth = 0;
+                while(!PointerName.empty()){
+                    std::tie(Part, PointerName) = StringView::Split(PointerName, '.');
+                    if(Part == "Parent"){
+                        Depth += 1;
+                        continue;
+                    }
+                    if(!PointerName.empty())
+                        break;
+                    if(Part == "Index")
+                        return LoopAccess {Member::Index, Depth};
+                    if(Part == "Index1")
+                        return LoopAccess {Member::Index1, Depth};
+                    if(Part == "IsFirst")
+                        return LoopAccess {Member::IsFirst, Depth};
+                    if(Part == "IsLast")
+                        return LoopAccess {Member::IsLast, Depth};
+                    break;
+                }
+                return LoopAccess {Member::Frame, 0};
+            }
 
             static std::string ConvertDotToPointer(std::string_view PointerName){
                 std::string Result;
@@ -488,7 +819,62 @@ namespace Sydonia{
                 return Result;
             }
 
-            explicit DataNode(std::string_view PointerNameLocal, size_t Position):  ExpressionNode(Position), Name(PointerNameLocal), Pointer(JSON::json_pointer(ConvertDotToPointer(PointerNameLocal))){}
+            static std::vector<PathSegment> SplitPath(std::string_view PointerName){
+                std::vector<PathSegment> Result;
+                do{
+                    // ! Slashes separate segments too, as they do in the JSON pointer
+                    const size_t Separator = PointerName.find_first_of("./");
+                    const std::string_view Part = PointerName.substr(0, Separator);
+                    PointerName = (Separator == std::string_view::npos) ? std::string_view() : PointerName.substr(Separator + 1);
+                    size_t Index = std::string_view::npos;
+                    if(!Part.empty() && (Part.size() == 1 || Part[0] != '0')){
+                        size_t Value;
+                        const auto Parsed = std::from_chars(Part.data(), Part.data() + Part.size(), Value);
+                        if(Parsed.ec == std::errc() && Parsed.ptr == Part.data() + Part.size())
+                            Index = Value;
+                    }
+                    Result.push_back(PathSegment {std::string(Part), Index});
+                }while(!PointerName.empty());
+                return Result;
+            }
+
+            // ! Walks Root along the path starting at segment From, a single
+            // ! lookup per segment instead of contains() followed by operator[]
+            const JSON* Find(const JSON &Root, size_t From = 0) const{
+                const JSON* Current = &Root;
+                for(size_t Iterator = From; Iterator < Path.size(); Iterator += 1){
+                    const auto &Segment = Path[Iterator];
+                    if(Current->is_object()){
+                        const auto &Object = Current->get_ref<const JSON::object_t&>();
+                        const auto Found = Object.find(Segment.Key);
+                        if(Found == Object.end())
+                            return nullptr;
+                        Current = &Found->second;
+                    }else if(Current->is_array() && Segment.Index < Current->size())
+                        Current = &(*Current)[Segment.Index];
+                    else
+                        return nullptr;
+                }
+                return Current;
+            }
+
+            const std::string &Head() const{
+                return Path.front().Key;
+            }
+
+            static std::string_view HeadOf(std::string_view PointerName){
+                return PointerName.substr(0, PointerName.find_first_of("./"));
+            }
+
+            static std::string TailOf(std::string_view PointerName){
+                const size_t Separator = PointerName.find_first_of("./");
+                if(Separator == std::string_view::npos || Separator + 1 >= PointerName.size())
+                    return "";
+                return ConvertDotToPointer(PointerName.substr(Separator + 1));
+            }
+
+            explicit DataNode(std::string_view PointerNameLocal, size_t Position):  ExpressionNode(Position), Name(PointerNameLocal),
+                Path(SplitPath(PointerNameLocal)), LoopAccessInstance(ParseLoopAccess(PointerNameLocal)){}
 
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
@@ -512,8 +898,8 @@ namespace Sydonia{
             std::string Name;
             // ! Should also be negative -> -1 for unknown number
             int NumberArgs;
-            std::vector<std::shared_ptr<ExpressionNode>> Arguments;
-            CallbackFunction Callback;
+            std::vector<ExpressionNode*> Arguments;
+            std::shared_ptr<const Callable> Callback;
 
             explicit FunctionNode(std::string_view NameLocal, size_t Position)
                 : ExpressionNode(Position), Precedence(8), AssociativityInstance(Associativity::Left), OperationInstance(Operation::Callback), Name(NameLocal), NumberArgs(1){} 
@@ -619,7 +1005,7 @@ namespace Sydonia{
 
     class ExpressionListNode : public AstNode{
         public:
-            std::shared_ptr<ExpressionNode> Root;
+            ExpressionNode* Root {nullptr};
             explicit ExpressionListNode(): AstNode(0){}
             explicit ExpressionListNode(size_t Position): AstNode(Position){}
 
@@ -725,9 +1111,13 @@ namespace Sydonia{
     class SetStatementNode : public StatementNode{
         public:
             const std::string Key;
+            const JSON::json_pointer Pointer;
+            const std::string Head;
+            const JSON::json_pointer Tail;
             ExpressionListNode Expression;
 
-            explicit SetStatementNode(const std::string &KeyLocal, size_t Position): StatementNode(Position), Key(KeyLocal){}
+            explicit SetStatementNode(const std::string &KeyLocal, size_t Position): StatementNode(Position), Key(KeyLocal), Pointer(JSON::json_pointer(DataNode::ConvertDotToPointer(KeyLocal))),
+                Head(DataNode::HeadOf(KeyLocal)), Tail(JSON::json_pointer(DataNode::TailOf(KeyLocal))){}
 
             void Accept(NodeVisitor &Visitor) const{
                 Visitor.Visit(*this);
@@ -748,9 +1138,173 @@ namespace Sydonia{
  * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
  ****/
 
+#ifndef SYDONIA_NODE_ARENA_HXX
+#define SYDONIA_NODE_ARENA_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Sydonia{
+    // ! Bump allocator owning the nodes of a template, nodes are laid out one
+    // ! after another in a few large chunks, never move and are all destroyed
+    // ! together with the arena
+    class NodeArena{
+        static constexpr size_t InitialChunkSize {4096};
+        static constexpr size_t MaximumChunkSize {65536};
+
+        std::vector<std::unique_ptr<std::byte[]>> Chunks;
+        std::byte* Current {nullptr};
+        size_t Remaining {0};
+        size_t NextChunkSize {InitialChunkSize};
+        // ! Nodes in creation order so they can be destroyed in reverse
+        std::vector<AstNode*> Nodes;
+
+        void* Allocate(size_t Size, size_t Alignment){
+            size_t Padding = (Alignment - reinterpret_cast<std::uintptr_t>(Current) % Alignment) % Alignment;
+            if(!Current || Padding + Size > Remaining){
+                const size_t ChunkSize = std::max(NextChunkSize, Size + Alignment);
+                Chunks.emplace_back(new std::byte[ChunkSize]);
+                Current = Chunks.back().get();
+                Remaining = ChunkSize;
+                NextChunkSize = std::min(NextChunkSize * 2, MaximumChunkSize);
+                Padding = (Alignment - reinterpret_cast<std::uintptr_t>(Current) % Alignment) % Alignment;
+            }
+            void* Result = Current + Padding;
+            Current += Padding + Size;
+            Remaining -= Padding + Size;
+            return Result;
+        }
+
+        public:
+            NodeArena() = default;
+            NodeArena(const NodeArena&) = delete;
+            NodeArena &operator=(const NodeArena&) = delete;
+
+            ~NodeArena(){
+                for(auto Iterator = Nodes.rbegin(); Iterator != Nodes.rend(); ++Iterator)
+                    (*Iterator)->~AstNode();
+            }
+
+            template<typename NodeType, typename... Parameters>
+            NodeType* Create(Parameters&&... ParametersLocal){
+                static_assert(std::is_base_of<AstNode, NodeType>::value, "NodeArena only holds AST nodes");
+                // ! Grow the list first so recording the node can not throw
+                if(Nodes.size() == Nodes.capacity())
+                    Nodes.reserve(std::max<size_t>(64, Nodes.capacity() * 2));
+                auto Result = new (Allocate(sizeof(NodeType), alignof(NodeType))) NodeType(std::forward<Parameters>(ParametersLocal)...);
+                Nodes.emplace_back(Result);
+                return Result;
+            }
+
+            // ! Number of nodes held by the arena
+            size_t Size() const{
+                return Nodes.size();
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_NODE_ARENA_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_PROGRAM_HXX
+#define SYDONIA_PROGRAM_HXX
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Sydonia{
+    // ! A single step of a compiled template
+    struct Instruction{
+        enum class Opcode{
+            Text,           // Write Length bytes of the template content starting at Operand
+            Literal,        // Push the value of a LiteralNode
+            Constant,       // Push the folded value at Operand of the constant pool
+            ConstantText,   // Write Length bytes of the folded text starting at Operand
+            Invariant,      // Push the render invariant value at Operand of the invariant pool
+            Data,           // Push the value of a DataNode
+            Operation,      // Apply a FunctionNode to the values on top of the stack
+            AtId,           // Replace the top value with the member named by the second argument
+            JumpIfDefined,  // Jump to Operand if the top value was found, otherwise drop it
+            JumpIfDecided,  // Pop the first argument of And/Or, push the result and jump to Operand if it decides it
+            Truthy,         // Replace the top value with whether it is truthy
+            Print,          // Pop the result of an expression list and write it
+            Jump,           // Jump to Operand
+            JumpIfFalse,    // Pop the result of a condition and jump to Operand if it is falsy
+            ForArray,       // Pop an array and begin a loop, jump to Operand when it is empty
+            ForObject,      // Pop an object and begin a loop, jump to Operand when it is empty
+            Next,           // Advance the innermost loop, jump to Operand while items remain
+            Include,
+            Extends,
+            Block,
+            Set,
+            Return,
+        };
+
+        Opcode OpcodeInstance;
+        size_t Operand;
+        size_t Length;
+        const AstNode* Node;
+
+        explicit Instruction(Opcode OpcodeLocal, const AstNode* NodeLocal = nullptr, size_t OperandLocal = 0, size_t LengthLocal = 0)
+            : OpcodeInstance(OpcodeLocal), Operand(OperandLocal), Length(LengthLocal), Node(NodeLocal){}
+    };
+
+    // ! A template lowered into a flat instruction stream, the main body starts
+    // ! at zero and every block body is placed after it, ending with a Return
+    struct Program{
+        std::vector<Instruction> Instructions;
+        std::map<std::string, size_t> Blocks;
+        // ! Values and printed text the Compiler worked out while lowering
+        std::vector<JSON> Constants;
+        std::string Text;
+        // ! Pointers into the invariant data the template keeps alive
+        std::vector<const JSON*> Invariants;
+        // ! Heads of the variables read from the invariant data, a render where a
+        // ! loop or a Set outside of the template binds one walks the AST instead
+        std::vector<std::string> InvariantHeads;
+
+        bool IsCompiled() const{
+            return !Instructions.empty();
+        }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_PROGRAM_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
 #ifndef SYDONIA_STATISTICS_HXX
 #define SYDONIA_STATISTICS_HXX
 
+#include <string_view>
+#include <vector>
+
 namespace Sydonia{
     // ! A class for counting statistics on a template
     class StatisticsVisitor : public NodeVisitor{
@@ -759,7 +1313,10 @@ namespace Sydonia{
                 SubNode->Accept(*this);
         }
         
-        void Visit(const TextNode&){}
+        void Visit(const TextNode &Node){
+            TextLength += Node.Length;
+        }
+
         void Visit(const ExpressionNode&){}
         void Visit(const LiteralNode&){}
 
@@ -773,7 +1330,9 @@ namespace Sydonia{
         }
 
         void Visit(const ExpressionListNode &Node){
-            Node.Root->Accept(*this);
+            ExpressionCounter += 1;
+            if(Node.Root)
+                Node.Root->Accept(*this);
         }
 
         void Visit(const StatementNode&){}
@@ -803,61 +1362,356 @@ namespace Sydonia{
             Node.Block.Accept(*this);
         }
 
-        void Visit(const SetStatementNode&){}
+        void Visit(const SetStatementNode &Node){
+            AssignedNames.emplace_back(Node.Head);
+            // ! Assigned values are not printed, only their variables are counted
+            if(Node.Expression.Root)
+                Node.Expression.Root->Accept(*this);
+        }
 
         public:
             unsigned VariableCounter;
-            explicit StatisticsVisitor(): VariableCounter(0){}
+            unsigned ExpressionCounter;
+            size_t TextLength;
+            // ! Heads of the variables the template Sets
+            std::vector<std::string_view> AssignedNames;
+            explicit StatisticsVisitor(): VariableCounter(0), ExpressionCounter(0), TextLength(0){}
     };
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_STATISTICS_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
 
-namespace Sydonia{
-    // ! The main Sydonia Template
-    struct Template{
-        BlockNode Root;
-        std::string Content;
-        std::map<std::string, std::shared_ptr<BlockStatementNode>> BlockStorage;
-        
-        explicit Template(){}
-        explicit Template(const std::string &ContentLocal): Content(ContentLocal){}
-
-        // ! Return number of variables (total number, not distinct ones) in the template
-        int CountVariables(){
-            auto StatisticVisitor = StatisticsVisitor();
-            Root.Accept(StatisticVisitor);
-            return StatisticVisitor.VariableCounter;
-        }
-    };
+#ifndef SYDONIA_TEMPLATE_SOURCE_HXX
+#define SYDONIA_TEMPLATE_SOURCE_HXX
 
-    using TemplateStorage = std::map<std::string, Template>;
-}; // ! Sydonia namespace
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
 
-#endif // ! SYDONIA_TEMPLATE_HXX
+#if defined(__unix__) || defined(__APPLE__)
+#define SYDONIA_MAP_FILES 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SYDONIA_MAP_FILES 0
+#endif
 
 namespace Sydonia{
-    // ! Struct for lexer configuration
-    struct LexerConfiguration{
-        std::string StatementOpen {"{%"};
-        std::string StatementOpenNoLstrip {"{%+"};
-        std::string StatementOpenForceLstrip {"{%-"};
-        std::string StatementClose {"%}"};
-        std::string StatementCloseForceRstrip {"-%}"};
-        std::string LineStatement {"##"};
-        std::string ExpressionOpen {"{{"};
-        std::string ExpressionOpenForceLstrip {"{{-"};
-        std::string ExpressionClose {"}}"};
-        std::string ExpressionCloseForceRstrip {"-}}"};
-        std::string CommentOpen {"{#"};
-        std::string CommentOpenForceLstrip {"{#-"};
-        std::string CommentClose {"#}"};
-        std::string CommentCloseForceRstrip {"-#}"};
-        std::string OpenCharacters {"#{"};
+    // ! Reads a whole file into Text, in one go when its size is known and streamed
+    // ! otherwise (pipes and other files that can not seek), returns false when
+    // ! it can not be opened, text mode is kept so line endings are translated
+    // ! as they always were
+    inline bool ReadFile(const std::string &Filename, std::string &Text){
+        std::ifstream File(Filename);
+        if(File.fail())
+            return false;
+        File.seekg(0, std::ios::end);
+        const std::streamoff Size = File.tellg();
+        if(Size < 0){
+            File.clear();
+            Text.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+            return true;
+        }
+        File.seekg(0, std::ios::beg);
+        Text.resize(static_cast<size_t>(Size));
+        File.read(&Text[0], Size);
+        Text.resize(static_cast<size_t>(File.gcount()));
+        return true;
+    }
+
+    // ! Read-only bytes a template is parsed from, a string it owns or a private
+    // ! mapping of a file, a template and its copies share it and the text nodes
+    // ! slice into it, so a mapped file must be replaced rather than rewritten
+    // ! in place while a template parsed from it is alive
+    class TemplateSource{
+        // ! Below this size setting up a mapping costs more than copying the file
+        static constexpr size_t MinimumMappedSize {65536};
+
+        std::string Text;
+        const char* Mapping {nullptr};
+        size_t MappingSize {0};
+
+        TemplateSource() = default;
+
+        public:
+            explicit TemplateSource(std::string TextLocal): Text(std::move(TextLocal)){}
+
+            TemplateSource(const TemplateSource&) = delete;
+            TemplateSource &operator=(const TemplateSource&) = delete;
+
+            ~TemplateSource(){
+#if SYDONIA_MAP_FILES
+                if(Mapping)
+                    munmap(const_cast<char*>(Mapping), MappingSize);
+#endif
+            }
+
+            std::string_view View() const{
+                return Mapping ? std::string_view(Mapping, MappingSize) : std::string_view(Text);
+            }
+
+            // ! Copies the file into memory, nullptr when it can not be opened
+            static std::shared_ptr<const TemplateSource> Read(const std::string &Filename){
+                std::string TextLocal;
+                if(!ReadFile(Filename, TextLocal))
+                    return nullptr;
+                return std::make_shared<const TemplateSource>(std::move(TextLocal));
+            }
+
+            // ! Maps the file, the pages are shared with every other process that
+            // ! maps it, small files are copied, nullptr when it can not be opened
+            static std::shared_ptr<const TemplateSource> Map(const std::string &Filename){
+#if SYDONIA_MAP_FILES
+                const int Descriptor = open(Filename.c_str(), O_RDONLY | O_CLOEXEC);
+                if(Descriptor < 0)
+                    return nullptr;
+                struct stat Status;
+                if(fstat(Descriptor, &Status) != 0 || !S_ISREG(Status.st_mode) || static_cast<size_t>(Status.st_size) < MinimumMappedSize){
+                    close(Descriptor);
+                    return Read(Filename);
+                }
+                const size_t Size = static_cast<size_t>(Status.st_size);
+                int Flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+                // ! The whole file is lexed right away, fault it in with one call
+                Flags |= MAP_POPULATE;
+#endif
+                void* Address = mmap(nullptr, Size, PROT_READ, Flags, Descriptor, 0);
+                close(Descriptor);
+                if(Address == MAP_FAILED)
+                    return Read(Filename);
+                std::shared_ptr<TemplateSource> Result(new TemplateSource());
+                Result->Mapping = static_cast<const char*>(Address);
+                Result->MappingSize = Size;
+                return Result;
+#else
+                return Read(Filename);
+#endif
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_SOURCE_HXX
+
+namespace Sydonia{
+    // ! Expected output size of a template, seeded from its static text and
+    // ! refined with an exponential moving average of the rendered sizes
+    class OutputSizeEstimate{
+        // ! Rough number of bytes printed by each expression
+        static constexpr size_t BytesPerExpression {16};
+
+        std::atomic<size_t> Average {0};
+
+        public:
+            OutputSizeEstimate() = default;
+            OutputSizeEstimate(const OutputSizeEstimate &Other): Average(Other.Get()){}
+
+            OutputSizeEstimate &operator=(const OutputSizeEstimate &Other){
+                Average.store(Other.Get(), std::memory_order_relaxed);
+                return *this;
+            }
+
+            void Seed(size_t TextLength, size_t ExpressionCount){
+                Average.store(TextLength + ExpressionCount * BytesPerExpression, std::memory_order_relaxed);
+            }
+
+            size_t Get() const{
+                return Average.load(std::memory_order_relaxed);
+            }
+
+            // ! Moves the average an eighth of the way towards the observed size,
+            // ! concurrent renders may overwrite each other which only drops a sample
+            void Update(size_t Observed){
+                const size_t Current = Get();
+                Average.store(Current - Current / 8 + Observed / 8, std::memory_order_relaxed);
+            }
+    };
+
+    // ! Line index of a template content, built the first time a location is
+    // ! asked for, concurrent renders may both build it and keep either one
+    class LazyLineIndex{
+        std::shared_ptr<const LineIndex> Index;
+
+        public:
+            LazyLineIndex() = default;
+            LazyLineIndex(const LazyLineIndex &Other): Index(Other.Get()){}
+
+            LazyLineIndex &operator=(const LazyLineIndex &Other){
+                std::atomic_store(&Index, Other.Get());
+                return *this;
+            }
+
+            std::shared_ptr<const LineIndex> Get() const{
+                return std::atomic_load(&Index);
+            }
+
+            std::shared_ptr<const LineIndex> Get(std::string_view Content){
+                auto Current = Get();
+                if(!Current){
+                    Current = std::make_shared<const LineIndex>(Content);
+                    std::atomic_store(&Index, Current);
+                }
+                return Current;
+            }
+    };
+
+    // ! Replacement of Length bytes at Offset of the content of a template by Text
+    struct TemplateEdit{
+        size_t Offset {0};
+        size_t Length {0};
+        std::string Text;
+    };
+
+    // ! The main Sydonia Template
+    struct Template{
+        // ! Holds every node below Root, copies of a template share it
+        std::shared_ptr<NodeArena> Arena {std::make_shared<NodeArena>()};
+        BlockNode Root;
+        // ! Keeps the bytes Content and the text nodes point into alive
+        std::shared_ptr<const TemplateSource> Source;
+        std::string_view Content;
+        std::map<std::string, BlockStatementNode*> BlockStorage;
+        // ! Values of the render invariant keys the template was compiled with
+        std::shared_ptr<const JSON> InvariantData;
+        // ! Flat form of Root produced by the Compiler once parsing is done
+        Program ProgramInstance;
+        mutable OutputSizeEstimate OutputSize;
+        // ! Nodes in the arena after the last full parse, the nodes replaced by
+        // ! a reparse stay in the arena until it is dropped
+        size_t ParsedNodeCount {0};
+        mutable LazyLineIndex Lines;
+        
+        explicit Template(){}
+        explicit Template(std::string ContentLocal): Template(std::make_shared<const TemplateSource>(std::move(ContentLocal))){}
+
+        explicit Template(std::shared_ptr<const TemplateSource> SourceLocal): Source(std::move(SourceLocal)), Content(Source->View()){}
+
+        // ! Line and column of a byte of the content
+        SourceLocation Locate(size_t Position) const{
+            return Lines.Get(Content)->Locate(Position);
+        }
+
+        // ! Line index of the content, for tools that map many positions at once
+        std::shared_ptr<const LineIndex> GetLineIndex() const{
+            return Lines.Get(Content);
+        }
+
+                // ! Return number of variables (total number, not distinct ones) in the template
+        int CountVariables(){
+            auto StatisticVisitor = StatisticsVisitor();
+            Root.Accept(StatisticVisitor);
+            return StatisticVisitor.VariableCounter;
+        }
+
+        // ! Seed the output size estimate from the static text and the number of expressions
+        void EstimateOutputSize(){
+            auto StatisticVisitor = StatisticsVisitor();
+            Root.Accept(StatisticVisitor);
+            OutputSize.Seed(StatisticVisitor.TextLength, StatisticVisitor.ExpressionCounter);
+        }
+    };
+
+    // ! Templates are shared between snapshots of the storage and are never
+    // ! modified once they have been added to one
+    using TemplateStorage = std::map<std::string, std::shared_ptr<const Template>>;
+
+    // ! Immutable set of included templates kept as a stack of layers, adding
+    // ! templates puts a new layer on top and merges the layers below it that
+    // ! are not larger, so each template is copied a logarithmic number of times
+    class TemplateSnapshot{
+        TemplateStorage Templates;
+        std::shared_ptr<const TemplateSnapshot> Below;
+
+        public:
+            const Template* Find(const std::string &Name) const{
+                for(auto Layer = this; Layer; Layer = Layer->Below.get()){
+                    const auto Iterator = Layer->Templates.find(Name);
+                    if(Iterator != Layer->Templates.end())
+                        return Iterator->second.get();
+                }
+                return nullptr;
+            }
+
+            // ! Returns Current with Added on top, Added replaces the templates of Current
+            static std::shared_ptr<const TemplateSnapshot> Add(std::shared_ptr<const TemplateSnapshot> Current, TemplateStorage Added){
+                while(Current && Current->Templates.size() <= Added.size()){
+                    Added.insert(Current->Templates.begin(), Current->Templates.end());
+                    Current = Current->Below;
+                }
+                auto Result = std::make_shared<TemplateSnapshot>();
+                Result->Templates = std::move(Added);
+                Result->Below = std::move(Current);
+                return Result;
+            }
+    };
+
+    // ! The included templates a renderer or an analysis can see, those found by
+    // ! the parse in progress first and then a published snapshot
+    class TemplateLookup{
+        const TemplateStorage* Discovered {nullptr};
+        const TemplateSnapshot* Shared {nullptr};
+
+        public:
+            TemplateLookup(const TemplateStorage &DiscoveredLocal, const TemplateSnapshot* SharedLocal = nullptr): Discovered(&DiscoveredLocal), Shared(SharedLocal){}
+
+            TemplateLookup(const TemplateSnapshot &SharedLocal): Shared(&SharedLocal){}
+
+            const Template* Find(const std::string &Name) const{
+                if(Discovered){
+                    const auto Iterator = Discovered->find(Name);
+                    if(Iterator != Discovered->end())
+                        return Iterator->second.get();
+                }
+                return Shared ? Shared->Find(Name) : nullptr;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_HXX
+
+namespace Sydonia{
+    // ! Struct for lexer configuration
+    struct LexerConfiguration{
+        std::string StatementOpen {"{%"};
+        std::string StatementOpenNoLstrip {"{%+"};
+        std::string StatementOpenForceLstrip {"{%-"};
+        std::string StatementClose {"%}"};
+        std::string StatementCloseForceRstrip {"-%}"};
+        std::string LineStatement {"##"};
+        std::string ExpressionOpen {"{{"};
+        std::string ExpressionOpenForceLstrip {"{{-"};
+        std::string ExpressionClose {"}}"};
+        std::string ExpressionCloseForceRstrip {"-}}"};
+        std::string CommentOpen {"{#"};
+        std::string CommentOpenForceLstrip {"{#-"};
+        std::string CommentClose {"#}"};
+        std::string CommentCloseForceRstrip {"-#}"};
+        std::string OpenCharacters {"#{"};
+        OpenerMatcher OpenerMatcherInstance;
 
         bool TrimBlocks {false};
         bool LstripBlocks {false};
 
+        LexerConfiguration(){
+            UpdateOpenCharacters();
+        }
+
+        // ! Rebuilds the first characters and the matcher of the opening sequences
         void UpdateOpenCharacters(){
             OpenCharacters = "";
             if(OpenCharacters.find(LineStatement[0]) == std::string::npos)
@@ -876,22 +1730,367 @@ namespace Sydonia{
                 OpenCharacters += CommentOpen[0];
             if(OpenCharacters.find(CommentOpenForceLstrip[0]) == std::string::npos)
                 OpenCharacters += CommentOpenForceLstrip[0];
+
+            OpenerMatcherInstance.Clear();
+            OpenerMatcherInstance.Add(ExpressionOpen, Opener::Expression);
+            OpenerMatcherInstance.Add(ExpressionOpenForceLstrip, Opener::ExpressionForceLstrip);
+            OpenerMatcherInstance.Add(StatementOpen, Opener::Statement);
+            OpenerMatcherInstance.Add(StatementOpenNoLstrip, Opener::StatementNoLstrip);
+            OpenerMatcherInstance.Add(StatementOpenForceLstrip, Opener::StatementForceLstrip);
+            OpenerMatcherInstance.Add(CommentOpen, Opener::Comment);
+            OpenerMatcherInstance.Add(CommentOpenForceLstrip, Opener::CommentForceLstrip);
+            OpenerMatcherInstance.Add(LineStatement, Opener::LineStatement);
         }
     };
 
     // ! Struct for parser configuration
     struct ParserConfiguration{
         bool SearchIncludedTemplatesInFiles {true};
+        // ! Map template files instead of copying them into memory, a mapped file
+        // ! must not be truncated or rewritten in place while it is loaded
+        bool MapTemplateFiles {false};
+        // ! Evaluate what does not depend on the render data when compiling
+        bool FoldConstants {true};
+        // ! Values that are the same for every render, given by their top level key
+        std::shared_ptr<const JSON> InvariantData;
         std::function<Template(const std::string &, const std::string &)> IncludeCallback;
     };
 
     // ! Struct for render configuration
     struct RenderConfiguration{
         bool ThrowAtMissingIncludes {true};
+        // ! Run the compiled program of a template instead of walking its AST
+        bool UseCompiledProgram {true};
     };
 }; // ! Sydonia namespace
 
 #endif // ! SYDONIA_CONFIGURATION_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_DEPENDENCIES_HXX
+#define SYDONIA_DEPENDENCIES_HXX
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Sydonia{
+    // ! Collects the paths of the render data a template may read, following its
+    // ! includes, the templates it extends and the blocks they override. A path
+    // ! is dotted, '*' standing for every element of an array or object, and the
+    // ! whole value below it may be read. Loop variables and Set targets are
+    // ! resolved to what they were taken from, the result is a superset of what a
+    // ! render reads since every branch is assumed to be taken
+    class DependencyVisitor : public NodeVisitor{
+        using Operation = FunctionStorage::Operation;
+
+        // ! Set targets are resolved again until they stop changing, chains longer
+        // ! than this are cut short
+        static constexpr size_t MaximumPasses {8};
+
+        // ! A loop variable and the paths its values come from
+        struct Scope{
+            std::string_view Name;
+            std::vector<std::string> Sources;
+            bool Used;
+        };
+
+        const TemplateLookup TemplateStorageInstance;
+        std::vector<Scope> Scopes;
+        size_t LoopDepth {0};
+        // ! What each Set target may hold, gathered over the whole analysis
+        std::map<std::string, std::set<std::string>> Assignments;
+        bool AssignmentsChanged {false};
+        // ! Templates of the inheritance chain, the most derived one first
+        std::vector<const Template*> Chain;
+        // ! Templates and blocks being walked, so recursive ones are walked once
+        std::vector<const void*> Active;
+        const Template* CurrentTemplate {nullptr};
+        // ! Paths the value of the expression visited last comes from
+        std::vector<std::string> Sources;
+        std::set<std::string> Paths;
+
+        static std::string Join(const std::string &Path, std::string_view Tail){
+            if(Tail.empty())
+                return Path;
+            std::string Result = Path;
+            Result += '.';
+            Result.append(Tail.data(), Tail.size());
+            return Result;
+        }
+
+        // ! Whether Prefix is Path or one of its parents
+        static bool IsPrefix(std::string_view Prefix, std::string_view Path){
+            return Path.size() >= Prefix.size() && Path.compare(0, Prefix.size(), Prefix) == 0 &&
+                (Path.size() == Prefix.size() || Path[Prefix.size()] == '.');
+        }
+
+        bool IsActive(const void* Item) const{
+            return std::find(Active.begin(), Active.end(), Item) != Active.end();
+        }
+
+        // ! The value of the last expression is read as a whole
+        void Use(){
+            Paths.insert(Sources.begin(), Sources.end());
+            Sources.clear();
+        }
+
+        void Evaluate(const ExpressionListNode &Node){
+            Sources.clear();
+            if(Node.Root)
+                Node.Root->Accept(*this);
+        }
+
+        void WalkTemplate(const Template &TemplateLocal){
+            if(IsActive(&TemplateLocal))
+                return;
+            const Template* Previous = CurrentTemplate;
+            CurrentTemplate = &TemplateLocal;
+            Active.emplace_back(&TemplateLocal);
+            TemplateLocal.Root.Accept(*this);
+            Active.pop_back();
+            CurrentTemplate = Previous;
+        }
+
+        const Template* FindTemplate(const std::string &File) const{
+            return TemplateStorageInstance.Find(File);
+        }
+
+        void Visit(const BlockNode &Node){
+            for(auto &SubNode : Node.Nodes)
+                SubNode->Accept(*this);
+        }
+
+        void Visit(const TextNode&){}
+        void Visit(const ExpressionNode&){}
+
+        void Visit(const LiteralNode&){
+            Sources.clear();
+        }
+
+        void Visit(const DataNode &Node){
+            Sources.clear();
+            // ! Loop.* is answered by the running loops
+            if(Node.LoopAccessInstance.MemberInstance != DataNode::LoopAccess::Member::None && Node.LoopAccessInstance.Depth < LoopDepth)
+                return;
+            std::string Tail;
+            for(size_t Iterator = 1; Iterator < Node.Path.size(); Iterator += 1){
+                if(Iterator > 1)
+                    Tail += '.';
+                Tail += Node.Path[Iterator].Key;
+            }
+            for(auto Iterator = Scopes.rbegin(); Iterator != Scopes.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head())
+                    continue;
+                Iterator->Used = true;
+                for(const auto &Source : Iterator->Sources)
+                    Sources.emplace_back(Join(Source, Tail));
+                return;
+            }
+            const std::string Path = Join(Node.Head(), Tail);
+            // ! Render invariant values stand in for the render data, not for a Set
+            if(!CurrentTemplate->InvariantData || !Node.Find(*CurrentTemplate->InvariantData))
+                Sources.emplace_back(Path);
+            for(const auto &Assignment : Assignments){
+                if(IsPrefix(Assignment.first, Path)){
+                    const std::string_view Rest = std::string_view(Path).substr(std::min(Path.size(), Assignment.first.size() + 1));
+                    for(const auto &Source : Assignment.second)
+                        Sources.emplace_back(Join(Source, Rest));
+                }else if(IsPrefix(Path, Assignment.first))
+                    Sources.insert(Sources.end(), Assignment.second.begin(), Assignment.second.end());
+            }
+        }
+
+        void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    Node.Arguments[0]->Accept(*this);
+                    const auto Member = dynamic_cast<const DataNode*>(Node.Arguments[1]);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, Member ? std::string_view(Member->Name) : "*");
+                } break;
+                case Operation::Default: {
+                    Node.Arguments[0]->Accept(*this);
+                    std::vector<std::string> First;
+                    First.swap(Sources);
+                    Node.Arguments[1]->Accept(*this);
+                    Sources.insert(Sources.end(), First.begin(), First.end());
+                } break;
+                case Operation::At: {
+                    Node.Arguments[1]->Accept(*this);
+                    Use();
+                    const auto Key = dynamic_cast<const LiteralNode*>(Node.Arguments[1]);
+                    std::string Member = "*";
+                    if(Key && Key->Value.is_string())
+                        Member = Key->Value.get<std::string>();
+                    else if(Key && Key->Value.is_number_unsigned())
+                        Member = std::to_string(Key->Value.get<size_t>());
+                    Node.Arguments[0]->Accept(*this);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, Member);
+                } break;
+                case Operation::First:
+                case Operation::Last: {
+                    Node.Arguments[0]->Accept(*this);
+                    for(auto &Source : Sources)
+                        Source = Join(Source, "*");
+                } break;
+                case Operation::Exists: {
+                    // ! The name is looked up in the render data when it is known
+                    const auto Name = dynamic_cast<const LiteralNode*>(Node.Arguments[0]);
+                    if(Name && Name->Value.is_string()){
+                        Paths.insert(Name->Value.get<std::string>());
+                        Sources.clear();
+                    }else{
+                        Node.Arguments[0]->Accept(*this);
+                        Use();
+                    }
+                } break;
+                default: {
+                    for(auto &Argument : Node.Arguments){
+                        Argument->Accept(*this);
+                        Use();
+                    }
+                }
+            }
+        }
+
+        void Visit(const ExpressionListNode &Node){
+            Evaluate(Node);
+            Use();
+        }
+
+        void Visit(const StatementNode&){}
+        void Visit(const ForStatementNode&){}
+
+        // ! Walks a loop body with its variables bound, the container is read as a
+        // ! whole when the body never looks into its values
+        void WalkLoop(const ExpressionListNode &Condition, const BlockNode &Body, std::string_view Key, std::string_view Value){
+            Evaluate(Condition);
+            std::vector<std::string> Container;
+            Container.swap(Sources);
+            std::vector<std::string> Items;
+            for(const auto &Source : Container)
+                Items.emplace_back(Join(Source, "*"));
+            const size_t Base = Scopes.size();
+            if(!Key.empty())
+                Scopes.push_back(Scope {Key, {}, false});
+            Scopes.push_back(Scope {Value, std::move(Items), false});
+            LoopDepth += 1;
+            Body.Accept(*this);
+            LoopDepth -= 1;
+            const bool Used = Scopes.back().Used;
+            Scopes.resize(Base);
+            if(!Used)
+                Paths.insert(Container.begin(), Container.end());
+        }
+
+        void Visit(const ForArrayStatementNode &Node){
+            WalkLoop(Node.Condition, Node.Body, std::string_view(), Node.Value);
+        }
+
+        void Visit(const ForObjectStatementNode &Node){
+            WalkLoop(Node.Condition, Node.Body, Node.Key, Node.Value);
+        }
+
+        void Visit(const IfStatementNode &Node){
+            Node.Condition.Accept(*this);
+            Node.TrueStatement.Accept(*this);
+            Node.FalseStatement.Accept(*this);
+        }
+
+        void Visit(const IncludeStatementNode &Node){
+            const auto Included = FindTemplate(Node.File);
+            if(!Included)
+                return;
+            // ! An included template renders its own blocks
+            auto Previous = std::move(Chain);
+            Chain = {Included};
+            WalkTemplate(*Included);
+            Chain = std::move(Previous);
+        }
+
+        void Visit(const ExtendsStatementNode &Node){
+            const auto Parent = FindTemplate(Node.File);
+            if(!Parent || IsActive(Parent))
+                return;
+            Chain.emplace_back(Parent);
+            WalkTemplate(*Parent);
+            Chain.pop_back();
+        }
+
+        void Visit(const BlockStatementNode &Node){
+            // ! Any template of the chain may provide the body, through Super() too
+            for(size_t Iterator = 0; Iterator < Chain.size(); Iterator += 1){
+                const auto Found = Chain[Iterator]->BlockStorage.find(Node.Name);
+                if(Found == Chain[Iterator]->BlockStorage.end() || IsActive(Found->second))
+                    continue;
+                const Template* Previous = CurrentTemplate;
+                CurrentTemplate = Chain[Iterator];
+                Active.emplace_back(Found->second);
+                Found->second->Block.Accept(*this);
+                Active.pop_back();
+                CurrentTemplate = Previous;
+            }
+        }
+
+        void Visit(const SetStatementNode &Node){
+            Evaluate(Node.Expression);
+            for(auto &Scope : Scopes){
+                if(Scope.Name != Node.Head)
+                    continue;
+                // ! Assigning into a loop variable, what is kept in it is read right away
+                Use();
+                return;
+            }
+            auto &Targets = Assignments[Node.Key];
+            for(const auto &Source : Sources)
+                AssignmentsChanged |= Targets.insert(Source).second;
+            Sources.clear();
+        }
+
+        public:
+            explicit DependencyVisitor(const TemplateLookup &TemplateStorageLocal): TemplateStorageInstance(TemplateStorageLocal){}
+
+            // ! Paths of the render data the template may read, a path is left out
+            // ! when one of its parents is in the result
+            std::set<std::string> Collect(const Template &TemplateLocal){
+                Assignments.clear();
+                for(size_t Pass = 0; Pass < MaximumPasses; Pass += 1){
+                    Paths.clear();
+                    AssignmentsChanged = false;
+                    Chain = {&TemplateLocal};
+                    WalkTemplate(TemplateLocal);
+                    if(!AssignmentsChanged)
+                        break;
+                }
+                std::set<std::string> Result;
+                for(const auto &Path : Paths){
+                    bool Covered = false;
+                    for(size_t Separator = Path.find('.'); !Covered && Separator != std::string::npos; Separator = Path.find('.', Separator + 1))
+                        Covered = Paths.count(Path.substr(0, Separator)) != 0;
+                    if(!Covered)
+                        Result.insert(Result.end(), Path);
+                }
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_DEPENDENCIES_HXX
 
 /***
  * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
@@ -926,11 +2125,14 @@ namespace Sydonia{
  * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
  ****/
 
-#ifndef SYDONIA_LEXER_HXX
-#define SYDONIA_LEXER_HXX
+#ifndef SYDONIA_COMPILER_HXX
+#define SYDONIA_COMPILER_HXX
 
-#include <cctype>
-#include <locale>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 /***
  * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
@@ -944,694 +2146,3447 @@ namespace Sydonia{
  * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
  ****/
 
-#ifndef SYDONIA_TOKEN_HXX
-#define SYDONIA_TOKEN_HXX
+#ifndef SYDONIA_CONSTANT_FOLDER_HXX
+#define SYDONIA_CONSTANT_FOLDER_HXX
 
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
-#include <string_view>
 
-namespace Sydonia{
-    // ! Helper struct for the Sydonia Lexer
-    struct Token{
-        enum class Kind{
-            Text,
-            ExpressionOpen,     // {{
-            ExpressionClose,    // }}
-            LineStatementOpen,  // ##
-            LineStatementClose, // \n
-            StatementOpen,      // {%
-            StatementClose,     // %}
-            CommentOpen,        // {#
-            CommentClose,       // #}
-            Id,                 // this, this.foo
-            Number,             // 1, 2, -1, 5.2, -5.3
-            String,             // "this"
-            Plus,               // +
-            Minus,              // -
-            Times,              // *
-            Slash,              // /
-            Percent,            // %
-            Power,              // ^
-            Comma,              // ,
-            Dot,                // .
-            Colon,              // :
-            LeftParen,          // (
-            RightParen,         // )
-            LeftBracket,        // [
-            RightBracket,       // ]
-            LeftBrace,          // {
-            RightBrace,         // }
-            Equal,              // ==
-            NotEqual,           // !=
-            GreaterThan,        // >
-            GreaterEqual,       // >=
-            LessThan,           // <
-            LessEqual,          // <=
-            Unknown,
-            Eof,
-        };
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
 
-        Kind KindInstance {Kind::Unknown};
-        std::string_view Text;
+#ifndef SYDONIA_OUTPUT_SINK_HXX
+#define SYDONIA_OUTPUT_SINK_HXX
 
-        explicit constexpr Token() = default;
-        explicit constexpr Token(Kind KindLocalInstance, std::string_view TextLocal)
-            : KindInstance(KindLocalInstance), Text(TextLocal){}
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
 
-        std::string Describe() const{
-            switch(KindInstance){
-                case Kind::Text:
-                    return "<Text>";
-                case Kind::LineStatementClose:
-                    return "<Eol>";
-                case Kind::Eof:
-                    return "<Eof>";
-                default:
-                    return static_cast<std::string>(Text);
+namespace Sydonia{
+    // ! Contiguous append buffer the renderer writes through, it either grows
+    // ! a caller supplied string or batches writes for an output stream
+    class OutputSink{
+        static constexpr size_t StreamChunkSize {16384};
+
+        std::string StreamBuffer;
+        std::string* Buffer;
+        std::ostream* Stream {nullptr};
+        size_t Written {0};
+
+        public:
+            explicit OutputSink(std::string &Target): Buffer(&Target){}
+
+            explicit OutputSink(std::ostream &StreamLocal): Buffer(&StreamBuffer), Stream(&StreamLocal){
+                StreamBuffer.reserve(StreamChunkSize);
+            }
+
+            OutputSink(const OutputSink&) = delete;
+            OutputSink &operator=(const OutputSink&) = delete;
+
+            ~OutputSink(){
+                Flush();
+            }
+
+            // ! Hint that about Size more bytes are going to be written
+            void Reserve(size_t Size){
+                if(!Stream)
+                    Buffer->reserve(Buffer->size() + Size);
+            }
+
+            void Write(const char* Data, size_t Length){
+                Written += Length;
+                if(Stream && Buffer->size() + Length > StreamChunkSize){
+                    Flush();
+                    if(Length > StreamChunkSize){
+                        Stream->write(Data, Length);
+                        return;
+                    }
+                }
+                Buffer->append(Data, Length);
+            }
+
+            void Write(std::string_view Text){
+                Write(Text.data(), Text.size());
+            }
+
+            // ! Integers are formatted without going through the stream locale
+            void WriteInteger(std::int64_t Value){
+                char Digits[24];
+                const auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+                Write(Digits, Result.ptr - Digits);
+            }
+
+            void WriteUnsigned(std::uint64_t Value){
+                char Digits[24];
+                const auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+                Write(Digits, Result.ptr - Digits);
+            }
+
+            // ! Number of bytes written through this sink
+            size_t Size() const{
+                return Written;
+            }
+
+            void Flush(){
+                if(Stream && !Buffer->empty()){
+                    Stream->write(Buffer->data(), Buffer->size());
+                    Buffer->clear();
+                }
             }
-        } 
     };
 }; // ! Sydonia namespace
 
-#endif // ! SYDONIA_TOKEN_HXX
+#endif // ! SYDONIA_OUTPUT_SINK_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_RENDERER_HXX
+#define SYDONIA_RENDERER_HXX
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_ARITHMETIC_HXX
+#define SYDONIA_ARITHMETIC_HXX
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
 
 namespace Sydonia{
-  // ! Class for lexing an Sydonia Template.
-  class Lexer{
-    enum class State{
-      Text,
-      ExpressionStart,
-      ExpressionStartForceLstrip,
-      ExpressionBody,
-      LineStart,
-      LineBody,
-      StatementStart,
-      StatementStartNoLstrip,
-      StatementStartForceLstrip,
-      StatementBody,
-      CommentStart,
-      CommentStartForceLstrip,
-      CommentBody,
-    };
+    // ! Kernels of the arithmetic and comparison operators picked by the types of
+    // ! their operands, integers are computed in 64 bits, signed first and then
+    // ! unsigned when neither is negative, and become floats when the result
+    // ! does not fit, integers of either sign are compared exactly
+    namespace Arithmetic{
+        using Integer = JSON::number_integer_t;
+        using Unsigned = JSON::number_unsigned_t;
+        using Float = JSON::number_float_t;
+
+        enum class Kind : std::uint8_t{
+            Integer,
+            Unsigned,
+            Float,
+            String,
+            Other
+        };
 
-    enum class MinusState{
-      Operator,
-      Number,
-    };
+        inline Kind KindOf(const JSON &Value){
+            switch(Value.type()){
+                case JSON::value_t::number_integer: return Kind::Integer;
+                case JSON::value_t::number_unsigned: return Kind::Unsigned;
+                case JSON::value_t::number_float: return Kind::Float;
+                case JSON::value_t::string: return Kind::String;
+                default: return Kind::Other;
+            }
+        }
 
-    const LexerConfiguration& LexerConfigurationInstance;
+        // ! An integer operand as a signed value, false when it does not fit
+        inline bool AsInteger(const JSON &Value, Integer &Result){
+            if(Value.is_number_integer() && !Value.is_number_unsigned()){
+                Result = *Value.get_ptr<const Integer*>();
+                return true;
+            }
+            if(Value.is_number_unsigned() && *Value.get_ptr<const Unsigned*>() <= static_cast<Unsigned>(std::numeric_limits<Integer>::max())){
+                Result = static_cast<Integer>(*Value.get_ptr<const Unsigned*>());
+                return true;
+            }
+            return false;
+        }
 
-    State StateInstance;
-    MinusState MinusStateInstance;
-    std::string_view M_IN;
-    size_t TokenStart;
-    size_t Position;
+        inline bool AsIntegers(const JSON &Left, const JSON &Right, Integer &First, Integer &Second){
+            return AsInteger(Left, First) && AsInteger(Right, Second);
+        }
 
-    Token ScanBody(std::string_view Close, Token::Kind CloseKind, std::string_view CloseTrim = std::string_view(), bool Trim = false){
-    Again:
-      // ! Skip whitespace (except for \n as it might be a close)
-      if(TokenStart >= M_IN.size())
-        return MakeToken(Token::Kind::Eof);
-      const char Character = M_IN[TokenStart];
-      if(Character == ' ' || Character == '\t' || Character == '\r') {
-        TokenStart += 1;
-        goto Again;
-      }
+        // ! An integer operand as an unsigned value, false when it is negative
+        inline bool AsUnsigned(const JSON &Value, Unsigned &Result){
+            if(Value.is_number_unsigned()){
+                Result = *Value.get_ptr<const Unsigned*>();
+                return true;
+            }
+            if(Value.is_number_integer() && *Value.get_ptr<const Integer*>() >= 0){
+                Result = static_cast<Unsigned>(*Value.get_ptr<const Integer*>());
+                return true;
+            }
+            return false;
+        }
 
-      // ! Check for close
-      if(!CloseTrim.empty() && StringView::StartsWith(M_IN.substr(TokenStart), CloseTrim)){
-        StateInstance = State::Text;
-        Position = TokenStart + CloseTrim.size();
-        const Token TokenInstance = MakeToken(CloseKind);
-        SkipWhiteSpacesAndNewLines();
-        return TokenInstance;
-      }
+        inline bool AsUnsigneds(const JSON &Left, const JSON &Right, Unsigned &First, Unsigned &Second){
+            return AsUnsigned(Left, First) && AsUnsigned(Right, Second);
+        }
 
-      if(StringView::StartsWith(M_IN.substr(TokenStart), Close)){
-        StateInstance = State::Text;
-        Position = TokenStart + Close.size();
-        const Token TokenInstance = MakeToken(CloseKind);
-        if(Trim)
-          SkipWhiteSpacesAndFirstNewLine();
-        return TokenInstance;
-      }
+        inline bool AddChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_add_overflow(First, Second, &Result);
+#else
+            if((Second > 0 && First > std::numeric_limits<Integer>::max() - Second) || (Second < 0 && First < std::numeric_limits<Integer>::min() - Second))
+                return false;
+            Result = First + Second;
+            return true;
+#endif
+        }
 
-      // ! Skip \n
-      if(Character == '\n'){
-        TokenStart += 1;
-        goto Again;
-      }
+        inline bool SubtractChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_sub_overflow(First, Second, &Result);
+#else
+            if((Second < 0 && First > std::numeric_limits<Integer>::max() + Second) || (Second > 0 && First < std::numeric_limits<Integer>::min() + Second))
+                return false;
+            Result = First - Second;
+            return true;
+#endif
+        }
 
-      Position = TokenStart + 1;
-      if(std::isalpha(Character)){
-        MinusStateInstance = MinusState::Operator;
-        return ScanID();
-      }
+        inline bool MultiplyChecked(Integer First, Integer Second, Integer &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(First, Second, &Result);
+#else
+            constexpr Integer Maximum = std::numeric_limits<Integer>::max(), Minimum = std::numeric_limits<Integer>::min();
+            if(First > 0 ? (Second > 0 ? First > Maximum / Second : Second < Minimum / First)
+                         : (Second > 0 ? First < Minimum / Second : (First != 0 && Second < Maximum / First)))
+                return false;
+            Result = First * Second;
+            return true;
+#endif
+        }
 
-      const MinusState CurrentMinusState = MinusStateInstance;
-      if(MinusStateInstance == MinusState::Operator)
-        MinusStateInstance = MinusState::Number;
+        inline bool AddChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_add_overflow(First, Second, &Result);
+#else
+            Result = First + Second;
+            return Result >= First;
+#endif
+        }
 
-      switch(Character){
-        case '+':
-          return MakeToken(Token::Kind::Plus);
-        case '-':
-          if(CurrentMinusState == MinusState::Operator)
-            return MakeToken(Token::Kind::Minus);
-          return ScanNumber();
-        case '*':
-          return MakeToken(Token::Kind::Times);
-        case '/':
-          return MakeToken(Token::Kind::Slash);
-        case '^':
-          return MakeToken(Token::Kind::Power);
-        case '%':
-          return MakeToken(Token::Kind::Percent);
-        case '.':
-          return MakeToken(Token::Kind::Dot);
-        case ',':
-          return MakeToken(Token::Kind::Comma);
-        case ':':
-          return MakeToken(Token::Kind::Colon);
-        case '(':
-          return MakeToken(Token::Kind::LeftParen);
-        case ')':
-          MinusStateInstance = MinusState::Operator;
-          return MakeToken(Token::Kind::RightParen);
-        case '[':
-          return MakeToken(Token::Kind::LeftBracket);
-        case ']':
-          MinusStateInstance = MinusState::Operator;
-          return MakeToken(Token::Kind::RightBracket);
-        case '{':
-          return MakeToken(Token::Kind::LeftBrace);
-        case '}':
-          MinusStateInstance = MinusState::Operator;
-          return MakeToken(Token::Kind::RightBrace);
-        case '>':
-          if(Position < M_IN.size() && M_IN[Position] == '='){
-            Position += 1;
-            return MakeToken(Token::Kind::GreaterEqual);
-          }
-          return MakeToken(Token::Kind::GreaterThan);
-        case '<':
-          if (Position < M_IN.size() && M_IN[Position] == '='){
-            Position += 1;
-            return MakeToken(Token::Kind::LessEqual);
-          }
-          return MakeToken(Token::Kind::LessThan);
-        case '=':
-          if(Position < M_IN.size() && M_IN[Position] == '='){
-            Position += 1;
-            return MakeToken(Token::Kind::Equal);
-          }
-          return MakeToken(Token::Kind::Unknown);
-        case '!':
-          if(Position < M_IN.size() && M_IN[Position] == '='){
-            Position += 1;
-            return MakeToken(Token::Kind::NotEqual);
-          }
-          return MakeToken(Token::Kind::Unknown);
-        case '\"':
-          return ScanString();
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-          MinusStateInstance = MinusState::Operator;
-          return ScanNumber();
-        case '_':
-        case '@':
-        case '$':
-          MinusStateInstance = MinusState::Operator;
-          return ScanID();
-        default:
-          return MakeToken(Token::Kind::Unknown);
-      }
-    }
+        inline bool SubtractChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_sub_overflow(First, Second, &Result);
+#else
+            if(First < Second)
+                return false;
+            Result = First - Second;
+            return true;
+#endif
+        }
 
-    Token ScanID(){
-      for(;;){
-        if(Position >= M_IN.size())
-          break;
-        const char Character = M_IN[Position];
-        if(!std::isalnum(Character) && Character != '.' && Character != '/' && Character != '_' && Character != '-')
-          break;
-        Position += 1;
-      }
-      return MakeToken(Token::Kind::Id);
-    }
+        inline bool MultiplyChecked(Unsigned First, Unsigned Second, Unsigned &Result){
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(First, Second, &Result);
+#else
+            if(First != 0 && Second > std::numeric_limits<Unsigned>::max() / First)
+                return false;
+            Result = First * Second;
+            return true;
+#endif
+        }
 
-    Token ScanNumber(){
-      for(;;){
-        if(Position >= M_IN.size())
-          break;
-        const char Character = M_IN[Position];
-        // ! Be very permissive in lexer (we'll catch errors when conversion happens)
-        if(!(std::isdigit(Character) || Character == '.' || Character == 'e' || Character == 'E' || (Character == '+' && (Position == 0 || M_IN[Position - 1] == 'e' || M_IN[Position - 1] == 'E')) || (Character == '-' && (Position == 0 || M_IN[Position - 1] == 'e' || M_IN[Position - 1] == 'E'))))
-          break;
-        Position += 1;
-      }
-      return MakeToken(Token::Kind::Number);
-    }
+        inline bool PowerChecked(Integer Base, Integer Exponent, Integer &Result){
+            Integer Value = 1;
+            while(Exponent > 0){
+                if((Exponent & 1) && !MultiplyChecked(Value, Base, Value))
+                    return false;
+                Exponent >>= 1;
+                if(Exponent > 0 && !MultiplyChecked(Base, Base, Base))
+                    return false;
+            }
+            Result = Value;
+            return true;
+        }
 
-    Token ScanString(){
-      bool Escape {false};
-      for(;;){
-        if(Position >= M_IN.size())
-          break;
-        const char Character = M_IN[Position++];
-        if(Character == '\\')
-          Escape = true;
-        else if(!Escape && Character == M_IN[TokenStart])
-          break;
-        else
-          Escape = false;
-      }
-      return MakeToken(Token::Kind::String);
-    }
+        // ! Any number as JSON converts it, booleans included
+        inline Float AsFloat(const JSON &Value){
+            switch(Value.type()){
+                case JSON::value_t::number_integer: return static_cast<Float>(*Value.get_ptr<const Integer*>());
+                case JSON::value_t::number_unsigned: return static_cast<Float>(*Value.get_ptr<const Unsigned*>());
+                case JSON::value_t::number_float: return *Value.get_ptr<const Float*>();
+                default: return Value.get<Float>();
+            }
+        }
 
-    Token MakeToken(Token::Kind KindLocal) const{
-      return Token(KindLocal, StringView::Slice(M_IN, TokenStart, Position));
-    }
+        inline void Add(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(Left.is_string() && Right.is_string()){
+                // ! The result keeps the storage of the string it replaces
+                if(!Result.is_string())
+                    Result = std::string();
+                auto &Text = Result.get_ref<std::string&>();
+                Text.assign(Left.get_ref<const std::string&>());
+                Text.append(Right.get_ref<const std::string&>());
+            }else if(AsIntegers(Left, Right, First, Second) && AddChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && AddChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else
+                Result = AsFloat(Left) + AsFloat(Right);
+        }
 
-    void SkipWhiteSpacesAndNewLines(){
-      if(Position < M_IN.size())
-        while(Position < M_IN.size() && (M_IN[Position] == ' ' || M_IN[Position] == '\t' || M_IN[Position] == '\n' || M_IN[Position] == '\r'))
-          Position += 1;
-    }
+        inline void Subtract(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(AsIntegers(Left, Right, First, Second) && SubtractChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && SubtractChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && UnsignedSecond - UnsignedFirst - 1 <= static_cast<Unsigned>(std::numeric_limits<Integer>::max()))
+                // ! A negative difference of two unsigned values down to the minimum
+                Result = -static_cast<Integer>(UnsignedSecond - UnsignedFirst - 1) - 1;
+            else
+                Result = AsFloat(Left) - AsFloat(Right);
+        }
 
-    void SkipWhiteSpacesAndFirstNewLine() {
-      if(Position < M_IN.size())
-        while(Position < M_IN.size() && (M_IN[Position] == ' ' || M_IN[Position] == '\t'))
-          Position += 1;
+        inline void Multiply(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second, Value;
+            Unsigned UnsignedFirst, UnsignedSecond, UnsignedValue;
+            if(AsIntegers(Left, Right, First, Second) && MultiplyChecked(First, Second, Value))
+                Result = Value;
+            else if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond) && MultiplyChecked(UnsignedFirst, UnsignedSecond, UnsignedValue))
+                Result = UnsignedValue;
+            else
+                Result = AsFloat(Left) * AsFloat(Right);
+        }
 
-      if(Position < M_IN.size()){
-        const char Character = M_IN[Position];
-        if(Character == '\n')
-          Position += 1;
-        else if(Character == '\r'){
-          Position += 1;
-          if(Position < M_IN.size() && M_IN[Position] == '\n')
-            Position += 1;
+        inline void Power(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer Base, Exponent, Value;
+            if(AsIntegers(Left, Right, Base, Exponent) && Exponent >= 0 && PowerChecked(Base, Exponent, Value))
+                Result = Value;
+            else
+                Result = std::pow(AsFloat(Left), AsFloat(Right));
         }
-      }
-    }
 
-    static std::string_view ClearFinalLineIfWhiteSpace(std::string_view Text){
-      std::string_view Result = Text;
-      while(!Result.empty()){
-        const char Character = Result.back();
-        if (Character == ' ' || Character == '\t')
-          Result.remove_suffix(1);
-        else if (Character == '\n' || Character == '\r')
-          break;
-        else
-          return Text;
-      }
-      return Result;
-    }
+        // ! False when the divisor is zero
+        inline bool Modulo(const JSON &Left, const JSON &Right, JSON &Result){
+            Integer First, Second;
+            if(AsIntegers(Left, Right, First, Second)){
+                if(Second == 0)
+                    return false;
+                // ! The minimum divided by -1 overflows, its remainder is zero anyway
+                Result = (Second == -1) ? Integer(0) : First % Second;
+                return true;
+            }
+            Unsigned UnsignedFirst, UnsignedSecond;
+            if(AsUnsigneds(Left, Right, UnsignedFirst, UnsignedSecond)){
+                if(UnsignedSecond == 0)
+                    return false;
+                Result = UnsignedFirst % UnsignedSecond;
+                return true;
+            }
+            const Float Divisor = AsFloat(Right);
+            if(Divisor == 0)
+                return false;
+            Result = std::fmod(AsFloat(Left), Divisor);
+            return true;
+        }
 
-  public:
-    explicit Lexer(const LexerConfiguration& LexerConfigurationLocal)
-      : LexerConfigurationInstance(LexerConfigurationLocal), StateInstance(State::Text), 
-        MinusStateInstance(MinusState::Number){}
+        // ! Orders two integers of any signedness exactly, a negative one is less
+        // ! than any unsigned one, negative when Left is less and zero when equal
+        inline int CompareIntegers(const JSON &Left, const JSON &Right){
+            const bool LeftNegative = !Left.is_number_unsigned() && *Left.get_ptr<const Integer*>() < 0;
+            const bool RightNegative = !Right.is_number_unsigned() && *Right.get_ptr<const Integer*>() < 0;
+            if(LeftNegative != RightNegative)
+                return LeftNegative ? -1 : 1;
+            if(LeftNegative){
+                const Integer First = *Left.get_ptr<const Integer*>(), Second = *Right.get_ptr<const Integer*>();
+                return (First < Second) ? -1 : (First > Second);
+            }
+            Unsigned First, Second;
+            AsUnsigneds(Left, Right, First, Second);
+            return (First < Second) ? -1 : (First > Second);
+        }
 
-    SourceLocation CurrentPosition() const{
-      return GetSourceLocation(M_IN, TokenStart);
-    }
+        inline bool Less(const JSON &Left, const JSON &Right){
+            const Kind First = KindOf(Left), Second = KindOf(Right);
+            if(First == Kind::Other || Second == Kind::Other || (First == Kind::String) != (Second == Kind::String))
+                return Left < Right;
+            if(First == Kind::String)
+                return Left.get_ref<const std::string&>() < Right.get_ref<const std::string&>();
+            if(First == Kind::Float || Second == Kind::Float)
+                return AsFloat(Left) < AsFloat(Right);
+            return CompareIntegers(Left, Right) < 0;
+        }
 
-    void Start(std::string_view Input){
-      M_IN = Input;
-      TokenStart = 0;
-      Position = 0;
-      StateInstance = State::Text;
-      MinusStateInstance = MinusState::Number;
+        inline bool Equal(const JSON &Left, const JSON &Right){
+            const Kind First = KindOf(Left), Second = KindOf(Right);
+            if(First == Kind::Other || Second == Kind::Other || (First == Kind::String) != (Second == Kind::String))
+                return Left == Right;
+            if(First == Kind::String)
+                return Left.get_ref<const std::string&>() == Right.get_ref<const std::string&>();
+            if(First == Kind::Float || Second == Kind::Float)
+                return AsFloat(Left) == AsFloat(Right);
+            return CompareIntegers(Left, Right) == 0;
+        }
+    }; // ! Arithmetic namespace
+}; // ! Sydonia namespace
 
-      // ! Consume byte order mark (BOM) for UTF-8
-      if(StringView::StartsWith(M_IN, "\xEF\xBB\xBF"))
-        M_IN = M_IN.substr(3);
-    }
+#endif // ! SYDONIA_ARITHMETIC_HXX
 
-    Token Scan(){
-      TokenStart = Position;
+namespace Sydonia{
+    // ! Class for rendering a template with data
+    class Renderer : public NodeVisitor{
+        using Operation = FunctionStorage::Operation;
+        using Opcode = Instruction::Opcode;
+
+        // ! A name visible to the template that refers to a value owned by someone
+        // ! else (the input, a loop container), it only owns a copy once the
+        // ! template computes or modifies it
+        struct Binding{
+            std::string_view Name;
+            const JSON* Value;
+            std::shared_ptr<JSON> Owned;
+        };
 
-    Again:
-      if(TokenStart >= M_IN.size())
-        return MakeToken(Token::Kind::Eof);
+        // ! State of a running loop, it borrows its container until a Set statement
+        // ! is about to change it and then iterates its own copy, Loop.* is answered
+        // ! from here and only built as JSON when dumped, the temporaries its
+        // ! container was computed in are pinned until it ends
+        struct LoopFrame{
+            size_t Pinned;
+            const JSON* Container;
+            // ! Whether a Set may change the container in place and the name it has
+            // ! to be made on, any name if it is empty
+            bool Assignable;
+            std::string_view AssignedHead;
+            std::shared_ptr<const JSON> Owned;
+            JSON::const_iterator Iterator;
+            JSON::const_iterator End;
+            size_t Index;
+            size_t Size;
+            size_t BindingBase;
+            bool IsObject;
+            JSON IndexValue;
+            JSON Index1Value;
+        };
 
-      switch(StateInstance){
-        default:
-        case State::Text: {
-          // ! Fast-scan to first open character
-          const size_t OpenStart = M_IN.substr(Position).find_first_of(LexerConfigurationInstance.OpenCharacters);
-          if(OpenStart == std::string_view::npos){
-            // ! Didn't find open, return remaining text as text token
-            Position = M_IN.size();
-            return MakeToken(Token::Kind::Text);
-          }
-          Position += OpenStart;
+        const RenderConfiguration RenderConfigurationInstance;
+        const TemplateLookup TemplateStorageInstance;
+        const FunctionStorage &FunctionStorageInstance;
+        
+        const Template* CurrentTemplate;
+        size_t CurrentLevel {0};
+        std::vector<const Template*> TemplateStack;
+        std::vector<const BlockStatementNode*> BlockStatementStack;
+        
+        const JSON* DataInput;
+        OutputSink* Output;
 
-          // ! Try to match one of the opening sequences, and get the close
-          std::string_view OpenString = M_IN.substr(Position);
-          bool MustLstrip = false;
-          if(StringView::StartsWith(OpenString, LexerConfigurationInstance.ExpressionOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.ExpressionOpenForceLstrip)){
-              StateInstance = State::ExpressionStartForceLstrip;
-              MustLstrip = true;
-            }else
-              StateInstance = State::ExpressionStart;
-          }else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpenNoLstrip))
-              StateInstance = State::StatementStartNoLstrip;
-            else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.StatementOpenForceLstrip)){
-              StateInstance = State::StatementStartForceLstrip;
-              MustLstrip = true;
-            }else{
-              StateInstance = State::StatementStart;
-              MustLstrip = LexerConfigurationInstance.LstripBlocks;
-            }
-          }else if(StringView::StartsWith(OpenString, LexerConfigurationInstance.CommentOpen)){
-            if(StringView::StartsWith(OpenString, LexerConfigurationInstance.CommentOpenForceLstrip)){
-              StateInstance = State::CommentStartForceLstrip;
-              MustLstrip = true;
-            }else{
-              StateInstance = State::CommentStart;
-              MustLstrip = LexerConfigurationInstance.LstripBlocks;
-            }
-          }else if((Position == 0 || M_IN[Position - 1] == '\n') && StringView::StartsWith(OpenString, LexerConfigurationInstance.LineStatement))
-            StateInstance = State::LineStart;
-          else{
-            // ! Wasn't actually an opening sequence
-            Position += 1;
-            goto Again;
-          }
+        JSON AdditionalData;
 
-          std::string_view Text = StringView::Slice(M_IN, TokenStart, Position);
-          if(MustLstrip)
-            Text = ClearFinalLineIfWhiteSpace(Text);
+        std::vector<const JSON*> DataEvalStack;
+        std::vector<const DataNode*> NotFoundStack;
+        std::vector<LoopFrame> LoopStack;
+        std::vector<Binding> Bindings;
+        // ! Where the value last looked up by name lives, a loop over it takes it
+        struct DataOrigin{
+            const JSON* Value;
+            bool Assignable;
+            std::string_view Head;
+        };
+        DataOrigin LastData {nullptr, false, {}};
+        // ! Arena of the values computed while evaluating an expression, a slot is
+        // ! reused once the statement that consumed its value is done, scalars are
+        // ! held inline and strings or containers keep their storage between uses
+        std::deque<JSON> Temporaries;
+        size_t TemporariesUsed {0};
+        // ! Arguments of the callback being called
+        Arguments CallArguments;
+        // ! Arguments of the lazy callbacks being called, null until evaluated
+        std::vector<const JSON*> LazyValues;
+
+        // ! What a lazy callback sees of its arguments, they are evaluated in the
+        // ! renderer that called it
+        class LazyCall : public LazyArguments{
+            Renderer &RendererInstance;
+            const AstNode &Node;
+            const std::vector<ExpressionNode*> &Items;
+            const size_t Base;
+
+            public:
+                LazyCall(Renderer &RendererLocal, const AstNode &NodeLocal, const std::vector<ExpressionNode*> &ItemsLocal, size_t BaseLocal)
+                    : RendererInstance(RendererLocal), Node(NodeLocal), Items(ItemsLocal), Base(BaseLocal){}
+
+                size_t Size() const{
+                    return Items.size();
+                }
 
-          if(Text.empty()){
-            // ! // don't generate empty token
-            goto Again; 
-          }
-          return Token(Token::Kind::Text, Text);
-        }
-        case State::ExpressionStart: {
-          StateInstance = State::ExpressionBody;
-          Position += LexerConfigurationInstance.ExpressionOpen.size();
-          return MakeToken(Token::Kind::ExpressionOpen);
-        }
-        case State::ExpressionStartForceLstrip: {
-          StateInstance = State::ExpressionBody;
-          Position += LexerConfigurationInstance.ExpressionOpenForceLstrip.size();
-          return MakeToken(Token::Kind::ExpressionOpen);
+                const JSON &operator[](size_t Index){
+                    return *RendererInstance.EvaluateLazy(Node, Items, Base, Index);
+                }
+        };
+
+        bool BreakRendering {false};
+
+        void PrintData(const JSON* Value){
+            if(Value->is_string())
+                Output->Write(Value->get_ref<const JSON::string_t&>());
+            else if(Value->is_number_unsigned())
+                Output->WriteUnsigned(Value->get<const JSON::number_unsigned_t>());
+            else if(Value->is_number_integer())
+                Output->WriteInteger(Value->get<const JSON::number_integer_t>());
+            else if(Value->is_boolean())
+                Output->Write(Value->get<bool>() ? "true" : "false");
+            else if(Value->is_null()){}
+            else
+                Output->Write(Value->dump());
         }
-        case State::LineStart: {
-          StateInstance = State::LineBody;
-          Position += LexerConfigurationInstance.LineStatement.size();
-          return MakeToken(Token::Kind::LineStatementOpen);
+
+        const JSON* EvalExpressionList(const ExpressionListNode &ExpressionList){
+            if(!ExpressionList.Root)
+                ThrowRendererError("Empty expression", ExpressionList);
+            ExpressionList.Root->Accept(*this);
+            return PopExpressionResult(ExpressionList);
         }
-        case State::StatementStart: {
-          StateInstance = State::StatementBody;
-          Position += LexerConfigurationInstance.StatementOpen.size();
-          return MakeToken(Token::Kind::StatementOpen);
+
+        // ! Takes the value left by an evaluated expression list off the stack, the
+        // ! result is borrowed from the data, the template or the temporaries
+        const JSON* PopExpressionResult(const ExpressionListNode &ExpressionList){
+            if(DataEvalStack.empty())
+                ThrowRendererError("Empty expression", ExpressionList);
+            else if(DataEvalStack.size() != 1)
+                ThrowRendererError("Malformed expression", ExpressionList);
+            const auto Result = DataEvalStack.back();
+            DataEvalStack.pop_back();
+            if(!Result){
+                if(NotFoundStack.empty())
+                    ThrowRendererError("Expression could not be evaluated", ExpressionList);
+                auto Node = NotFoundStack.back();
+                NotFoundStack.pop_back();
+                ThrowRendererError("Variable '" + static_cast<std::string>(Node->Name) + "' not found", *Node);
+            }
+            return Result;
         }
-        case State::StatementStartNoLstrip: {
-          StateInstance = State::StatementBody;
-          Position += LexerConfigurationInstance.StatementOpenNoLstrip.size();
-          return MakeToken(Token::Kind::StatementOpen);
+
+        void ThrowRendererError(const std::string &Message, const AstNode &Node){
+            SYDONIA_THROW(RenderError(Message, CurrentTemplate->Locate(Node.Position)));
         }
-        case State::StatementStartForceLstrip: {
-          StateInstance = State::StatementBody;
-          Position += LexerConfigurationInstance.StatementOpenForceLstrip.size();
-          return MakeToken(Token::Kind::StatementOpen);
+
+        // ! The temporary a result is written into, already on the stack
+        JSON &PushTemporary(){
+            JSON &Result = NextTemporary();
+            DataEvalStack.push_back(&Result);
+            return Result;
         }
-        case State::CommentStart: {
-          StateInstance = State::CommentBody;
-          Position += LexerConfigurationInstance.CommentOpen.size();
-          return MakeToken(Token::Kind::CommentOpen);
+
+        template <typename ValueType> void MakeResult(ValueType &&Value){
+            JSON &Result = NextTemporary();
+            Result = std::forward<ValueType>(Value);
+            DataEvalStack.push_back(&Result);
         }
-        case State::CommentStartForceLstrip: {
-          StateInstance = State::CommentBody;
-          Position += LexerConfigurationInstance.CommentOpenForceLstrip.size();
-          return MakeToken(Token::Kind::CommentOpen);
+
+        // ! Takes the N already evaluated arguments of a function off the stack
+        template <size_t N, bool ThrowNotFound = true> std::array<const JSON*, N> PopArguments(const FunctionNode &Node){
+            if(Node.Arguments.size() < N)
+                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(Node.Arguments.size()), Node);
+            if(DataEvalStack.size() < N)
+                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
+            std::array<const JSON*, N> Result;
+            for(size_t Iterator = 0; Iterator < N; Iterator += 1){
+                Result[N - Iterator - 1] = DataEvalStack.back();
+                DataEvalStack.pop_back();
+                if(!Result[N - Iterator - 1]){
+                    const auto DataNode = NotFoundStack.back();
+                    NotFoundStack.pop_back();
+                    if(ThrowNotFound)
+                        ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
+                }
+            }
+            return Result;
         }
-        case State::ExpressionBody:
-          return ScanBody(LexerConfigurationInstance.ExpressionClose, 
-                    Token::Kind::ExpressionClose, LexerConfigurationInstance.ExpressionCloseForceRstrip);
-        case State::LineBody:
-          return ScanBody("\n", Token::Kind::LineStatementClose);
-        case State::StatementBody:
-          return ScanBody(LexerConfigurationInstance.StatementClose, 
-                  Token::Kind::StatementClose, LexerConfigurationInstance.StatementCloseForceRstrip, LexerConfigurationInstance.TrimBlocks);
-        case State::CommentBody: {
-          // ! Fast-scan to comment close
-          const size_t End = M_IN.substr(Position).find(LexerConfigurationInstance.CommentClose);
-          if(End == std::string_view::npos){
-            Position = M_IN.size();
-            return MakeToken(Token::Kind::Eof);
-          }
 
-          // ! Check for trim pattern
-          const bool MustRstrip = StringView::StartsWith(M_IN.substr(Position + End - 1), LexerConfigurationInstance.CommentCloseForceRstrip);
+        template <bool ThrowNotFound = true> Arguments PopArgumentVector(const FunctionNode &Node){
+            Arguments Result;
+            PopArgumentsInto<ThrowNotFound>(Node, Result);
+            return Result;
+        }
 
-          // ! Return the entire comment in the close token
-          StateInstance = State::Text;
-          Position += End + LexerConfigurationInstance.CommentClose.size();
-          Token TokenInstance = MakeToken(Token::Kind::CommentClose);
-          if(MustRstrip || LexerConfigurationInstance.TrimBlocks) 
-            SkipWhiteSpacesAndFirstNewLine();
-          return TokenInstance;
+        // ! Same as PopArgumentVector but reusing the storage of Result
+        template <bool ThrowNotFound = true> void PopArgumentsInto(const FunctionNode &Node, Arguments &Result){
+            const size_t N = Node.Arguments.size();
+            if(DataEvalStack.size() < N)
+                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
+            Result.resize(N);
+            for(size_t Iterator = 0; Iterator < N; Iterator += 1){
+                Result[N - Iterator - 1] = DataEvalStack.back();
+                DataEvalStack.pop_back();
+                if(!Result[N - Iterator - 1]){
+                    const auto DataNode = NotFoundStack.back();
+                    NotFoundStack.pop_back();
+                    if(ThrowNotFound)
+                        ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
+                }
+            }
         }
-      }
-    }
 
-    const LexerConfiguration& GetConfiguration() const{
-      return LexerConfigurationInstance;
-    }
-  };
-}; // ! Namespace Sydonia
+        JSON &NextTemporary(){
+            if(TemporariesUsed == Temporaries.size())
+                Temporaries.emplace_back();
+            return Temporaries[TemporariesUsed++];
+        }
 
-#endif // ! SYDONIA_LEXER_HXX
+        // ! Called once a statement has consumed the value of its expression, the
+        // ! arguments a lazy callback has evaluated are kept until it returns and
+        // ! the slots a running loop iterates are kept until it ends
+        void ReleaseTemporaries(){
+            LastData.Value = nullptr;
+            if(DataEvalStack.empty() && LazyValues.empty())
+                TemporariesUsed = LoopStack.empty() ? 0 : LoopStack.back().Pinned;
+        }
 
-namespace Sydonia{
-    // ! Class for parsing a Sydonia Template
-    class Parser{
-        const ParserConfiguration &ParserConfigurationInstance;
-        Lexer LexerInstance;
-        TemplateStorage &TemplateStorageInstance;
-        const FunctionStorage &FunctionStorageInstance;
-        Token TokenInstance, PeekToken;
-        bool HavePeekToken {false};
-        size_t CurrentParenLevel {0};
-        size_t CurrentBracketLevel {0};
-        size_t CurrentBraceLevel {0};
-        std::string_view LiteralStart;
-        BlockNode* CurrentBlock {nullptr};
-        ExpressionListNode* CurrentExpressionList {nullptr};
-        std::stack<std::pair<FunctionNode*, size_t>> FunctionStack;
-        std::vector<std::shared_ptr<ExpressionNode>> Arguments;
-        std::stack<std::shared_ptr<FunctionNode>> OperatorStack;
-        std::stack<IfStatementNode*> IfStatementStack;
-        std::stack<ForStatementNode*> ForStatementStack;
-        std::stack<BlockStatementNode*> BlockStatementStack;
+        const JSON* EvaluateLazy(const AstNode &Node, const std::vector<ExpressionNode*> &Items, size_t Base, size_t Index){
+            if(Index >= Items.size())
+                ThrowRendererError("Callback asked for argument " + std::to_string(Index) + " of " + std::to_string(Items.size()), Node);
+            if(!LazyValues[Base + Index]){
+                Items[Index]->Accept(*this);
+                const auto Value = DataEvalStack.back();
+                DataEvalStack.pop_back();
+                if(!Value){
+                    const auto Missing = NotFoundStack.back();
+                    NotFoundStack.pop_back();
+                    ThrowRendererError("Variable '" + static_cast<std::string>(Missing->Name) + "' not found", *Missing);
+                }
+                LazyValues[Base + Index] = Value;
+            }
+            return LazyValues[Base + Index];
+        }
 
-        inline void ThrowParserError(const std::string &Message) const{
-            SYDONIA_THROW(ParserError(Message, LexerInstance.CurrentPosition()));
+        void CallLazy(const Callable &CallbackLocal, const AstNode &Node, const std::vector<ExpressionNode*> &Items){
+            const size_t Base = LazyValues.size();
+            LazyValues.resize(Base + Items.size(), nullptr);
+            LazyCall Call(*this, Node, Items, Base);
+            JSON &Result = NextTemporary();
+            CallbackLocal.LazyFunction(Call, Result);
+            LazyValues.resize(Base);
+            DataEvalStack.push_back(&Result);
         }
 
-        inline void GetNextToken(){
-            if(HavePeekToken){
-                TokenInstance = PeekToken;
-                HavePeekToken = false;
+        // ! Result callbacks write straight into a temporary, the others return one
+        void Call(const Callable &CallbackLocal, Arguments &Values){
+            if(CallbackLocal.ResultFunction){
+                JSON &Result = NextTemporary();
+                CallbackLocal.ResultFunction(ArgumentSpan(Values.data(), Values.size()), Result);
+                DataEvalStack.push_back(&Result);
             }else
-                TokenInstance = LexerInstance.Scan();
+                MakeResult(CallbackLocal.Function(Values));
         }
 
-        inline void GetPeekToken(){
-            if(!HavePeekToken){
-                PeekToken = LexerInstance.Scan();
-                HavePeekToken = true;
+        void Visit(const BlockNode &Node){
+            for(auto &SubNode : Node.Nodes){
+                SubNode->Accept(*this);
+                if(BreakRendering)
+                    break;
             }
         }
 
-        inline void AddLiteral(const char* ContentPointer){
-            std::string_view DataText(LiteralStart.data(), TokenInstance.Text.data() - LiteralStart.data() + TokenInstance.Text.size());
-            Arguments.emplace_back(std::make_shared<LiteralNode>(DataText, DataText.data() - ContentPointer));
+        void Visit(const TextNode &Node){
+            Output->Write(CurrentTemplate->Content.data() + Node.Position, Node.Length);
         }
 
-        inline void AddOperator(){
-            auto Function = OperatorStack.top();
-            OperatorStack.pop();
-            for(int Iterator = 0; Iterator < Function->NumberArgs; ++Iterator){
-                Function->Arguments.insert(Function->Arguments.begin(), Arguments.back());
-                Arguments.pop_back();
+        void Visit(const ExpressionNode &){}
+
+        void Visit(const LiteralNode &Node){
+            DataEvalStack.push_back(&Node.Value);
+        }
+
+        void Visit(const DataNode &Node){
+            PushData(Node);
+        }
+
+        const JSON* FindBinding(const DataNode &Node){
+            for(auto Iterator = Bindings.rbegin(); Iterator != Bindings.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head())
+                    continue;
+                const auto Result = Node.Find(*Iterator->Value, 1);
+                if(Iterator->Value == Iterator->Owned.get())
+                    LastData = DataOrigin {Result, true, Iterator->Name};
+                else
+                    LastData = BorrowedOrigin(Result, static_cast<size_t>(Bindings.rend() - Iterator) - 1);
+                return Result;
             }
-            Arguments.emplace_back(Function);
+            return nullptr;
         }
 
-        void AddToTemplateStorage(std::string_view Path, std::string &TemplateName){
-            if(TemplateStorageInstance.find(TemplateName) != TemplateStorageInstance.end())
-                return;
-            std::string OriginalPath = static_cast<std::string>(Path);
-            std::string OriginalName = TemplateName;
-            if(ParserConfigurationInstance.SearchIncludedTemplatesInFiles){
-                // ! Build the relative path
-                TemplateName = OriginalPath + OriginalName;
-                if(TemplateName.compare(0, 2, "./") == 0)
-                    TemplateName.erase(0, 2);
-                if(TemplateStorageInstance.find(TemplateName) == TemplateStorageInstance.end()){
-                    // ! Load file
-                    std::ifstream File;
-                    File.open(TemplateName);
-                    if(!File.fail()){
-                        std::string Text((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
-                        auto IncludeTemplate = Template(Text);
-                        TemplateStorageInstance.emplace(TemplateName, IncludeTemplate);
-                        ParseIntoTemplate(TemplateStorageInstance[TemplateName], TemplateName);
-                        return;
-                    }else if(!ParserConfigurationInstance.IncludeCallback)
-                        SYDONIA_THROW(FileError("Failed accessing file at '" + TemplateName + "'"));
+        // ! A binding that does not own its value borrows it from the container of
+        // ! the loop that made it
+        DataOrigin BorrowedOrigin(const JSON* Value, size_t Position) const{
+            for(auto Iterator = LoopStack.rbegin(); Iterator != LoopStack.rend(); ++Iterator)
+                if(Iterator->BindingBase <= Position)
+                    return DataOrigin {Value, Iterator->Assignable && !Iterator->Owned, Iterator->AssignedHead};
+            return DataOrigin {Value, true, {}};
+        }
+
+        // ! Resolves Loop.* against the running loops
+        const JSON* FindLoopData(const DataNode &Node){
+            using Member = DataNode::LoopAccess::Member;
+            static const JSON True(true), False(false);
+            const auto &Access = Node.LoopAccessInstance;
+            if(Access.Depth >= LoopStack.size())
+                return nullptr;
+            auto &Frame = LoopStack[LoopStack.size() - 1 - Access.Depth];
+            switch(Access.MemberInstance){
+                case Member::Index:
+                    Frame.IndexValue = Frame.Index;
+                    return &Frame.IndexValue;
+                case Member::Index1:
+                    Frame.Index1Value = Frame.Index + 1;
+                    return &Frame.Index1Value;
+                case Member::IsFirst:
+                    return (Frame.Index == 0) ? &True : &False;
+                case Member::IsLast:
+                    return (Frame.Index + 1 == Frame.Size) ? &True : &False;
+                default: {
+                    JSON &Value = NextTemporary();
+                    Value = MaterializeLoop(LoopStack.size() - 1);
+                    const auto Result = Node.Find(Value, 1);
+                    if(!Result)
+                        TemporariesUsed -= 1;
+                    return Result;
                 }
             }
+        }
 
-            // ! Try include callback
-            if(ParserConfigurationInstance.IncludeCallback){
-                auto IncludeTemplate = ParserConfigurationInstance.IncludeCallback(OriginalPath, OriginalName);
-                TemplateStorageInstance.emplace(TemplateName, IncludeTemplate);
+        JSON MaterializeLoop(size_t Position) const{
+            const auto &Frame = LoopStack[Position];
+            JSON Result;
+            Result["Index"] = Frame.Index;
+            Result["Index1"] = Frame.Index + 1;
+            Result["IsFirst"] = (Frame.Index == 0);
+            Result["IsLast"] = (Frame.Index + 1 == Frame.Size);
+            if(Position > 0)
+                Result["Parent"] = MaterializeLoop(Position - 1);
+            return Result;
+        }
+
+        void PushData(const DataNode &Node){
+            const JSON* Bound = !Bindings.empty() ? FindBinding(Node) : nullptr;
+            if(!Bound){
+                // ! Only the values made by Set can change while they are looped over
+                bool Assigned = false;
+                if(Node.LoopAccessInstance.MemberInstance != DataNode::LoopAccess::Member::None){
+                    // ! A value Set on Loop.* is kept over the one of the running loop
+                    Bound = Node.Find(AdditionalData);
+                    Assigned = Bound;
+                    if(!Bound)
+                        Bound = FindLoopData(Node);
+                }
+                if(!Bound)
+                    Assigned = (Bound = Node.Find(AdditionalData));
+                // ! Render invariant values stand in for the render data
+                if(!Bound && CurrentTemplate->InvariantData)
+                    Bound = Node.Find(*CurrentTemplate->InvariantData);
+                if(!Bound)
+                    Bound = Node.Find(*DataInput);
+                LastData = DataOrigin {Bound, Assigned, Node.Head()};
+            }
+            if(Bound)
+                DataEvalStack.push_back(Bound);
+            // ! Evaluate as the no argument callback bound while parsing
+            else if(Node.Callback && Node.Callback->LazyFunction){
+                static const std::vector<ExpressionNode*> NoArguments;
+                CallLazy(*Node.Callback, Node, NoArguments);
+            }else if(Node.Callback){
+                CallArguments.clear();
+                Call(*Node.Callback, CallArguments);
+            }else{
+                DataEvalStack.push_back(nullptr);
+                NotFoundStack.emplace_back(&Node);
             }
         }
 
-        std::string ParseFilename(const Token &TokenLocal) const{
-            if(TokenLocal.KindInstance != Token::Kind::String)
-                ThrowParserError("Expected string, got '" + TokenLocal.Describe() + "'");
-            if(TokenLocal.Text.length() < 2)
-                ThrowParserError("Expected filename, got '" + static_cast<std::string>(TokenLocal.Text) + "'");
-            // ! Remove first and last character ""
-            return std::string {TokenLocal.Text.substr(1, TokenLocal.Text.length() - 2)};
+        void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    Node.Arguments[0]->Accept(*this);
+                    ApplyAtId(Node);
+                } break;
+                case Operation::Default: {
+                    Node.Arguments[0]->Accept(*this);
+                    if(!PushIfDefined(Node)){
+                        Node.Arguments[1]->Accept(*this);
+                        DataEvalStack.push_back(PopArguments<1>(Node)[0]);
+                    }
+                } break;
+                case Operation::And:
+                case Operation::Or: {
+                    Node.Arguments[0]->Accept(*this);
+                    if(!PushIfDecided(Node)){
+                        Node.Arguments[1]->Accept(*this);
+                        PushTruthy(Node);
+                    }
+                } break;
+                default: {
+                    // ! A lazy callback evaluates its arguments itself
+                    if(Node.OperationInstance != Operation::Callback || !Node.Callback->LazyFunction)
+                        for(auto &Argument : Node.Arguments)
+                            Argument->Accept(*this);
+                    ApplyOperation(Node);
+                }
+            }
         }
 
-        bool ParseExpression(Template &TemplateLocal, Token::Kind Closing){
-            while(TokenInstance.KindInstance != Closing && TokenInstance.KindInstance != Token::Kind::Eof){
-                // ! Literals
-                switch(TokenInstance.KindInstance){
-                    case Token::Kind::String: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            LiteralStart = TokenInstance.Text;
-                            AddLiteral(TemplateLocal.Content.c_str());
-                        }
-                    } break;
-                    case Token::Kind::Number: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            LiteralStart = TokenInstance.Text;
-                            AddLiteral(TemplateLocal.Content.c_str());
-                        }
-                    } break;
-                    case Token::Kind::LeftBracket: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            LiteralStart = TokenInstance.Text;
-                        CurrentBracketLevel += 1;
-                    } break;
-                    case Token::Kind::LeftBrace: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            LiteralStart = TokenInstance.Text;
-                        CurrentBraceLevel += 1;
-                    } break;
-                    case Token::Kind::RightBracket: {
-                        if(CurrentBracketLevel == 0)
-                            ThrowParserError("Unexpected ']'");
-                        CurrentBracketLevel -= 1;
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            AddLiteral(TemplateLocal.Content.c_str());
-                    } break;
-                    case Token::Kind::RightBrace: {
-                        if(CurrentBraceLevel == 0)
-                            ThrowParserError("Unexpected '}'");
-                        CurrentBraceLevel -= 1;
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            AddLiteral(TemplateLocal.Content.c_str());
-                    } break;
-                    case Token::Kind::Id: {
-                        GetPeekToken();
-                        // ! Data literal
-                        if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("True") || TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("False") ||
-                            TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("NULL")){
-                                if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                                    LiteralStart = TokenInstance.Text;
-                                    AddLiteral(TemplateLocal.Content.c_str());
-                                }
-                            }
-                        // ! Operator
-                        else if(TokenInstance.Text == "And" || TokenInstance.Text == "Or" || TokenInstance.Text == "In" || TokenInstance.Text == "Not")
-                            goto ParseOperator;
-                        // ! Functions
-                        else if(PeekToken.KindInstance == Token::Kind::LeftParen){
-                            OperatorStack.emplace(std::make_shared<FunctionNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                            FunctionStack.emplace(OperatorStack.top().get(), CurrentParenLevel);
-                        // ! Variables
-                        }else
-                            Arguments.emplace_back(std::make_shared<DataNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                    // ! Operators
-                    } break;
-                    case Token::Kind::Equal:
-                    case Token::Kind::NotEqual:
-                    case Token::Kind::GreaterThan:
-                    case Token::Kind::GreaterEqual:
-                    case Token::Kind::LessThan:
-                    case Token::Kind::LessEqual:
-                    case Token::Kind::Plus:
-                    case Token::Kind::Minus:
-                    case Token::Kind::Times:
-                    case Token::Kind::Slash:
-                    case Token::Kind::Power:
-                    case Token::Kind::Percent:
-                    case Token::Kind::Dot: {
-                        ParseOperator:
-                            FunctionStorage::Operation OperationInstance;
-                            switch(TokenInstance.KindInstance){
-                                case Token::Kind::Id: {
-                                    if(TokenInstance.Text == "And")
-                                        OperationInstance = FunctionStorage::Operation::And;
-                                    else if(TokenInstance.Text == "Or")
-                                        OperationInstance = FunctionStorage::Operation::Or;
-                                    else if(TokenInstance.Text == "In")
-                                        OperationInstance = FunctionStorage::Operation::In;
-                                    else if(TokenInstance.Text == "Not")
-                                        OperationInstance = FunctionStorage::Operation::Not;
-                                    else
-                                        ThrowParserError("Unknown operator in parser.");
-                                } break;
-                                case Token::Kind::Equal: {
-                                    OperationInstance = FunctionStorage::Operation::Equal;
-                                } break;
-                                case Token::Kind::NotEqual: {
-                                    OperationInstance = FunctionStorage::Operation::NotEqual;
-                                } break;
-                                case Token::Kind::GreaterThan: {
-                                    OperationInstance = FunctionStorage::Operation::Greater;
-                                } break;
-                                case Token::Kind::GreaterEqual: {
-                                    OperationInstance = FunctionStorage::Operation::GreaterEqual;
-                                } break;
-                                case Token::Kind::LessThan: {
-                                    OperationInstance = FunctionStorage::Operation::Less;
-                                } break;
-                                case Token::Kind::LessEqual: {
-                                    OperationInstance = FunctionStorage::Operation::LessEqual;
-                                } break;
-                                case Token::Kind::Plus: {
-                                    OperationInstance = FunctionStorage::Operation::Add;
-                                } break;
-                                case Token::Kind::Minus: {
-                                    OperationInstance = FunctionStorage::Operation::Subtract;
-                                } break;
+        void ApplyAtId(const FunctionNode &Node){
+            const auto Container = PopArguments<1, false>(Node)[0];
+            Node.Arguments[1]->Accept(*this);
+            if(NotFoundStack.empty())
+                ThrowRendererError("COuld not find element with given name", Node);
+            const auto NodeID = NotFoundStack.back();
+            NotFoundStack.pop_back();
+            DataEvalStack.pop_back();
+            DataEvalStack.push_back(&Container->at(NodeID->Name));
+        }
+
+        // ! Keeps the evaluated first argument of Default() if it was found
+        bool PushIfDefined(const FunctionNode &Node){
+            const auto TestArguments = PopArguments<1, false>(Node)[0];
+            if(TestArguments)
+                DataEvalStack.push_back(TestArguments);
+            return TestArguments;
+        }
+
+        // ! Takes the evaluated first argument of And/Or and keeps the result when
+        // ! the argument decides it, the second one is left unevaluated then
+        bool PushIfDecided(const FunctionNode &Node){
+            const bool First = Truthy(PopArguments<1>(Node)[0]);
+            if(First != (Node.OperationInstance == Operation::Or))
+                return false;
+            MakeResult(First);
+            return true;
+        }
+
+        void PushTruthy(const FunctionNode &Node){
+            MakeResult(Truthy(PopArguments<1>(Node)[0]));
+        }
+
+        // ! Applies a function to its arguments, which must already be on the stack
+        void ApplyOperation(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::Not: {
+                    const auto Arguments = PopArguments<1>(Node);
+                    MakeResult(!Truthy(Arguments[0]));
+                } break;
+                case Operation::And: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Truthy(Arguments[0]) && Truthy(Arguments[1]));
+                } break;
+                case Operation::Or: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Truthy(Arguments[0]) || Truthy(Arguments[1]));
+                } break;
+                case Operation::In: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(std::find(Arguments[1]->begin(), Arguments[1]->end(), *Arguments[0]) != Arguments[1]->end());
+                } break;
+                case Operation::Equal: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Equal(*Arguments[0], *Arguments[1]));
+                } break;
+                case Operation::NotEqual: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Equal(*Arguments[0], *Arguments[1]));
+                } break;
+                case Operation::Greater: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Less(*Arguments[1], *Arguments[0]));
+                } break;
+                case Operation::GreaterEqual: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Less(*Arguments[0], *Arguments[1]));
+                } break;
+                case Operation::Less: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(Arithmetic::Less(*Arguments[0], *Arguments[1]));
+                } break;
+                case Operation::LessEqual: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    MakeResult(!Arithmetic::Less(*Arguments[1], *Arguments[0]));
+                } break;
+                case Operation::Add: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Add(*Arguments[0], *Arguments[1], PushTemporary());
+                } break;
+                case Operation::Subtract: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Subtract(*Arguments[0], *Arguments[1], PushTemporary());
+                } break;
+                case Operation::Multiplication: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Multiply(*Arguments[0], *Arguments[1], PushTemporary());
+                } break;
+                case Operation::Division: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    const auto Divisor = Arithmetic::AsFloat(*Arguments[1]);
+                    if(Divisor == 0)
+                        ThrowRendererError("Division by zero", Node);
+                    MakeResult(Arithmetic::AsFloat(*Arguments[0]) / Divisor);
+                } break;
+                case Operation::Power: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    Arithmetic::Power(*Arguments[0], *Arguments[1], PushTemporary());
+                } break;
+                case Operation::Modulo: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    if(!Arithmetic::Modulo(*Arguments[0], *Arguments[1], PushTemporary()))
+                        ThrowRendererError("Modulo by zero", Node);
+                } break;
+                case Operation::At: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    if(Arguments[0]->is_object())
+                        DataEvalStack.push_back(&Arguments[0]->at(Arguments[1]->get<std::string>()));
+                    else
+                        DataEvalStack.push_back(&Arguments[0]->at(Arguments[1]->get<int>()));
+                } break;
+                case Operation::DivisibleBy: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    const int Divisor = Arguments[1]->get<int>();
+                    MakeResult((Divisor != 0) && (Arguments[0]->get<int>() % Divisor == 0));
+                } break;
+                case Operation::Even: {
+                    MakeResult(PopArguments<1>(Node)[0]->get<int>() % 2 == 0);
+                } break;
+                case Operation::Exists: {
+                    auto &&Name = PopArguments<1>(Node)[0]->get_ref<const std::string&>();
+                    MakeResult(DataInput->contains(JSON::json_pointer(DataNode::ConvertDotToPointer(Name))));
+                } break;
+                case Operation::ExistsInObject: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    auto &&Name = Arguments[1]->get_ref<const std::string&>();
+                    MakeResult(Arguments[0]->find(Name) != Arguments[0]->end());
+                } break;
+                case Operation::First: {
+                    const auto Result = &PopArguments<1>(Node)[0]->front();
+                    DataEvalStack.push_back(Result);
+                } break;
+                case Operation::Float: {
+                    MakeResult(std::stod(PopArguments<1>(Node)[0]->get_ref<const std::string&>()));
+                } break;
+                case Operation::Int: {
+                    MakeResult(std::stoi(PopArguments<1>(Node)[0]->get_ref<const std::string&>()));
+                } break;
+                case Operation::Last: {
+                    const auto Result = &PopArguments<1>(Node)[0]->back();
+                    DataEvalStack.push_back(Result);
+                } break;
+                case Operation::Length: {
+                    const auto Value = PopArguments<1>(Node)[0];
+                    if(Value->is_string())
+                        MakeResult(Value->get_ref<const std::string&>().length());
+                    else
+                        MakeResult(Value->size());
+                } break;
+                case Operation::Lower: {
+                    std::string Result = PopArguments<1>(Node)[0]->get<std::string>();
+                    std::transform(Result.begin(), Result.end(), Result.begin(), ::tolower);
+                    MakeResult(std::move(Result));
+                } break;
+                case Operation::Max: {
+                    const auto Arguments = PopArguments<1>(Node);
+                    const auto Result = std::max_element(Arguments[0]->begin(), Arguments[0]->end());
+                    DataEvalStack.push_back(&(*Result));
+                } break;
+                case Operation::Min: {
+                    const auto Arguments = PopArguments<1>(Node);
+                    const auto Result = std::min_element(Arguments[0]->begin(), Arguments[0]->end());
+                    DataEvalStack.push_back(&(*Result));
+                } break;
+                case Operation::Odd: {
+                    MakeResult(PopArguments<1>(Node)[0]->get<int>() % 2 != 0);
+                } break;
+                case Operation::Range: {
+                    std::vector<int> Result(PopArguments<1>(Node)[0]->get<int>());
+                    std::iota(Result.begin(), Result.end(), 0);
+                    MakeResult(std::move(Result));
+                } break;
+                case Operation::Round: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    const int Precision = Arguments[1]->get<int>();
+                    const double Result = std::round(Arguments[0]->get<double>() * std::pow(10.0, Precision)) / std::pow(10.0, Precision);
+                    if(Precision == 0)
+                        MakeResult(int(Result));
+                    else
+                        MakeResult(Result);
+                } break;
+                case Operation::Sort: {
+                    const auto Arguments = PopArguments<1>(Node);
+                    JSON &Result = NextTemporary();
+                    Result = Arguments[0]->get<std::vector<JSON>>();
+                    std::sort(Result.begin(), Result.end());
+                    DataEvalStack.push_back(&Result);
+                } break;
+                case Operation::Upper: {
+                    std::string Result = PopArguments<1>(Node)[0]->get<std::string>();
+                    std::transform(Result.begin(), Result.end(), Result.begin(), ::toupper);
+                    MakeResult(std::move(Result));
+                } break;
+                case Operation::IsBoolean: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_boolean());
+                } break;
+                case Operation::IsNumber: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_number());
+                } break;
+                case Operation::IsInteger: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_number_integer());
+                } break;
+                case Operation::IsFloat: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_number_float());
+                } break;
+                case Operation::IsObject: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_object());
+                } break;
+                case Operation::IsArray: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_array());
+                } break;
+                case Operation::IsString: {
+                    MakeResult(PopArguments<1>(Node)[0]->is_string());
+                } break;
+                case Operation::Callback: {
+                    if(Node.Callback->LazyFunction){
+                        CallLazy(*Node.Callback, Node, Node.Arguments);
+                        break;
+                    }
+                    PopArgumentsInto(Node, CallArguments);
+                    Call(*Node.Callback, CallArguments);
+                } break;
+                case Operation::Super: {
+                    const auto Arguments = PopArgumentVector(Node);
+                    const size_t OldLevel = CurrentLevel;
+                    const size_t LevelDiff = (Arguments.size() != 1) ? Arguments[0]->get<int>() : 1;
+                    const size_t Level = CurrentLevel + LevelDiff;
+
+                    if(BlockStatementStack.empty())
+                        ThrowRendererError("Super() call is not withing a block", Node);
+                    
+                    if(Level < 1 || Level > TemplateStack.size() - 1)
+                        ThrowRendererError("Level of Super() call does not match parent templates (between 1 and " + std::to_string(TemplateStack.size() - 1) + ")", Node);
+
+                    const auto CurrentBlockStatement = BlockStatementStack.back();
+                    const Template* NewTemplate = TemplateStack.at(Level);
+                    const Template* OldTemplate = CurrentTemplate;
+                    const auto BlockIterator = NewTemplate->BlockStorage.find(CurrentBlockStatement->Name);
+                    if(BlockIterator != NewTemplate->BlockStorage.end()){
+                        CurrentTemplate = NewTemplate;
+                        CurrentLevel = Level;
+                        RenderBlock(*BlockIterator->second);
+                        CurrentLevel = OldLevel;
+                        CurrentTemplate = OldTemplate;
+                    }else
+                        ThrowRendererError("Could not find block with name '" + CurrentBlockStatement->Name + "'", Node);
+                    MakeResult(nullptr);
+                } break;
+                case Operation::Join: {
+                    const auto Arguments = PopArguments<2>(Node);
+                    const auto Separator = Arguments[1]->get<std::string>();
+                    std::ostringstream Stream;
+                    std::string Sep;
+                    for(const auto &Value : *Arguments[0]){
+                        Stream << Sep;
+                        if(Value.is_string())
+                            Stream << Value.get<std::string>();
+                        else
+                            Stream << Value.dump();
+                        Sep = Separator;
+                    }
+                    MakeResult(Stream.str());
+                } break;
+                case Operation::AtId:
+                case Operation::Default:
+                case Operation::ParenLeft:
+                case Operation::ParenRight:
+                case Operation::None:
+                    break;
+            }
+        }
+
+        void Visit(const ExpressionListNode &Node){
+            PrintData(EvalExpressionList(Node));
+            ReleaseTemporaries();
+        }
+
+        void Visit(const StatementNode &){}
+
+        void Visit(const ForStatementNode &){}
+
+        void Visit(const ForArrayStatementNode &Node){
+            const auto Result = EvalExpressionList(Node.Condition);
+            if(!Result->is_array())
+                ThrowRendererError("Object must be an array", Node);
+            const bool HasItems = BeginLoop(Node, Result);
+            ReleaseTemporaries();
+            if(HasItems){
+                do
+                    Node.Body.Accept(*this);
+                while(AdvanceLoop());
+            }
+        }
+
+        void Visit(const ForObjectStatementNode &Node){
+            const auto Result = EvalExpressionList(Node.Condition);
+            if(!Result->is_object())
+                ThrowRendererError("Object must be an object", Node);
+            const bool HasItems = BeginLoop(Node, Result);
+            ReleaseTemporaries();
+            if(HasItems){
+                do
+                    Node.Body.Accept(*this);
+                while(AdvanceLoop());
+            }
+        }
+
+        bool BeginLoop(const ForArrayStatementNode &Node, const JSON* Container){
+            if(Container->empty())
+                return false;
+            const auto Origin = OriginOf(Container);
+            LoopStack.push_back(LoopFrame {TemporariesUsed, Container, Origin.Assignable, Origin.Head, nullptr, Container->cbegin(), Container->cend(), 0, Container->size(), Bindings.size(), false, nullptr, nullptr});
+            Bindings.push_back(Binding {Node.Value, &*LoopStack.back().Iterator, nullptr});
+            return true;
+        }
+
+        bool BeginLoop(const ForObjectStatementNode &Node, const JSON* Container){
+            if(Container->empty())
+                return false;
+            const auto Origin = OriginOf(Container);
+            LoopStack.push_back(LoopFrame {TemporariesUsed, Container, Origin.Assignable, Origin.Head, nullptr, Container->cbegin(), Container->cend(), 0, Container->size(), Bindings.size(), true, nullptr, nullptr});
+            const auto Key = std::make_shared<JSON>(LoopStack.back().Iterator.key());
+            Bindings.push_back(Binding {Node.Key, Key.get(), Key});
+            Bindings.push_back(Binding {Node.Value, &LoopStack.back().Iterator.value(), nullptr});
+            return true;
+        }
+
+        // ! Where a loop container lives, a value reached from a lookup but not
+        // ! looked up itself may lie inside anything a Set can change
+        DataOrigin OriginOf(const JSON* Container) const{
+            if(Container == LastData.Value)
+                return LastData;
+            for(size_t Position = 0; Position < TemporariesUsed; ++Position)
+                if(&Temporaries[Position] == Container)
+                    return DataOrigin {Container, false, {}};
+            return DataOrigin {Container, true, {}};
+        }
+
+        // ! Moves the innermost loop to its next item, returns false once it is done
+        bool AdvanceLoop(){
+            auto &Frame = LoopStack.back();
+            ++Frame.Iterator;
+            ++Frame.Index;
+            if(Frame.Iterator == Frame.End){
+                Bindings.erase(Bindings.begin() + Frame.BindingBase, Bindings.end());
+                LoopStack.pop_back();
+                return false;
+            }
+            if(Frame.IsObject){
+                auto &Key = Bindings[Frame.BindingBase];
+                if(Key.Value != Key.Owned.get())
+                    Key.Owned = std::make_shared<JSON>();
+                *Key.Owned = Frame.Iterator.key();
+                Key.Value = Key.Owned.get();
+                Bindings[Frame.BindingBase + 1] = Binding {Bindings[Frame.BindingBase + 1].Name, &Frame.Iterator.value(), nullptr};
+            }else
+                Bindings[Frame.BindingBase] = Binding {Bindings[Frame.BindingBase].Name, &*Frame.Iterator, nullptr};
+            return true;
+        }
+
+        // ! Drops the loops started at or above Depth, used when rendering stops early
+        void UnwindLoops(size_t Depth){
+            while(LoopStack.size() > Depth){
+                Bindings.erase(Bindings.begin() + LoopStack.back().BindingBase, Bindings.end());
+                LoopStack.pop_back();
+            }
+        }
+
+        // ! Gives the running loops whose container lies inside Root their own copy
+        // ! of it, called before Root is changed in place by a Set on Head
+        void DetachLoops(const JSON &Root, std::string_view Head){
+            for(auto &Frame : LoopStack){
+                if(Frame.Owned || !Frame.Assignable)
+                    continue;
+                if(!Frame.AssignedHead.empty() && Frame.AssignedHead != Head)
+                    continue;
+                if(!Contains(Root, Frame.Container))
+                    continue;
+                Frame.Owned = std::make_shared<const JSON>(*Frame.Container);
+                Frame.Container = Frame.Owned.get();
+                Frame.Iterator = std::next(Frame.Container->cbegin(), Frame.Index);
+                Frame.End = Frame.Container->cend();
+                auto &Item = Bindings[Frame.BindingBase + (Frame.IsObject ? 1 : 0)];
+                if(Item.Value != Item.Owned.get())
+                    Item.Value = Frame.IsObject ? &Frame.Iterator.value() : &*Frame.Iterator;
+            }
+        }
+
+        static bool Contains(const JSON &Root, const JSON* Value){
+            if(&Root == Value)
+                return true;
+            if(Root.is_structured())
+                for(const auto &Item : Root)
+                    if(Contains(Item, Value))
+                        return true;
+            return false;
+        }
+
+        void Visit(const IfStatementNode &Node){
+            const bool Condition = Truthy(EvalExpressionList(Node.Condition));
+            ReleaseTemporaries();
+            if(Condition)
+                Node.TrueStatement.Accept(*this);
+            else if(Node.HasFalseStatement)
+                Node.FalseStatement.Accept(*this);
+        }
+
+        void Visit(const IncludeStatementNode &Node){
+            auto SubRenderer = Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+            const auto IncludedTemplate = TemplateStorageInstance.Find(Node.File);
+            SubRenderer.LoopStack = LoopStack;
+            // ! The pinned slots belong to this renderer's arena
+            for(auto &Frame : SubRenderer.LoopStack)
+                Frame.Pinned = 0;
+            SubRenderer.Bindings = Bindings;
+            if(IncludedTemplate)
+                SubRenderer.RenderTo(*Output, *IncludedTemplate, *DataInput, &AdditionalData);
+            else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
+                ThrowRendererError("Include '" + Node.File + "' not found", Node);
+        }
+        
+        void Visit(const ExtendsStatementNode &Node){
+            if(const Template* ParentTemplate = TemplateStorageInstance.Find(Node.File)){
+                RenderTo(*Output, *ParentTemplate, *DataInput, &AdditionalData);
+                BreakRendering = true;
+            }else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
+                ThrowRendererError("Extends '" + Node.File + "' not found", Node);
+        }
+
+        void Visit(const BlockStatementNode &Node){
+            const size_t OldLevel = CurrentLevel;
+            CurrentLevel = 0;
+            CurrentTemplate = TemplateStack.front();
+            const auto BlockIterator = CurrentTemplate->BlockStorage.find(Node.Name);
+            if(BlockIterator != CurrentTemplate->BlockStorage.end()){
+                BlockStatementStack.emplace_back(&Node);
+                RenderBlock(*BlockIterator->second);
+                BlockStatementStack.pop_back();
+            }
+            CurrentLevel = OldLevel;
+            CurrentTemplate = TemplateStack.back();
+        }
+
+        void Visit(const SetStatementNode &Node){
+            AssignData(Node, EvalExpressionList(Node.Expression));
+            ReleaseTemporaries();
+        }
+
+        void AssignData(const SetStatementNode &Node, const JSON* Value){
+            // ! Setting a loop variable copies it, the loop container is left untouched
+            for(auto Iterator = Bindings.rbegin(); Iterator != Bindings.rend(); ++Iterator){
+                if(Iterator->Name != Node.Head)
+                    continue;
+                JSON Result = *Value;
+                // ! The value is also shared with the renderer of an include
+                if(Iterator->Value != Iterator->Owned.get() || Iterator->Owned.use_count() > 1)
+                    Iterator->Owned = std::make_shared<JSON>(*Iterator->Value);
+                else
+                    DetachLoops(*Iterator->Owned, Node.Head);
+                if(Node.Tail.empty())
+                    *Iterator->Owned = std::move(Result);
+                else
+                    (*Iterator->Owned)[Node.Tail] = std::move(Result);
+                Iterator->Value = Iterator->Owned.get();
+                return;
+            }
+            JSON Result = *Value;
+            if(!LoopStack.empty() && AdditionalData.is_object()){
+                const auto Root = AdditionalData.find(Node.Head);
+                if(Root != AdditionalData.end())
+                    DetachLoops(*Root, Node.Head);
+            }
+            AdditionalData[Node.Pointer] = std::move(Result);
+        }
+
+        bool UsesProgram(const Template &TemplateLocal) const{
+            return RenderConfigurationInstance.UseCompiledProgram && TemplateLocal.ProgramInstance.IsCompiled() && !ShadowsInvariants(TemplateLocal);
+        }
+
+        // ! Whether a loop variable or a Set made outside of the template binds a
+        // ! name its program read from the invariant data
+        bool ShadowsInvariants(const Template &TemplateLocal) const{
+            for(const auto &Head : TemplateLocal.ProgramInstance.InvariantHeads){
+                for(const auto &BindingLocal : Bindings)
+                    if(BindingLocal.Name == Head)
+                        return true;
+                if(AdditionalData.is_object() && AdditionalData.find(Head) != AdditionalData.end())
+                    return true;
+            }
+            return false;
+        }
+
+        // ! Renders the body of a block that belongs to the current template
+        void RenderBlock(const BlockStatementNode &Node){
+            if(UsesProgram(*CurrentTemplate))
+                Execute(CurrentTemplate->ProgramInstance.Blocks.at(Node.Name));
+            else
+                Node.Block.Accept(*this);
+        }
+
+        // ! Runs the program of the current template from Entry until it returns
+        void Execute(size_t Entry){
+            const Template &ProgramTemplate = *CurrentTemplate;
+            const auto &Instructions = ProgramTemplate.ProgramInstance.Instructions;
+            const size_t LoopBase = LoopStack.size();
+            size_t Counter = Entry;
+            for(;;){
+                const Instruction &Step = Instructions[Counter];
+                switch(Step.OpcodeInstance){
+                    case Opcode::Text: {
+                        Output->Write(ProgramTemplate.Content.data() + Step.Operand, Step.Length);
+                    } break;
+                    case Opcode::Literal: {
+                        DataEvalStack.push_back(&static_cast<const LiteralNode*>(Step.Node)->Value);
+                    } break;
+                    case Opcode::Constant: {
+                        DataEvalStack.push_back(&ProgramTemplate.ProgramInstance.Constants[Step.Operand]);
+                    } break;
+                    case Opcode::ConstantText: {
+                        Output->Write(ProgramTemplate.ProgramInstance.Text.data() + Step.Operand, Step.Length);
+                    } break;
+                    case Opcode::Invariant: {
+                        DataEvalStack.push_back(ProgramTemplate.ProgramInstance.Invariants[Step.Operand]);
+                    } break;
+                    case Opcode::Data: {
+                        PushData(*static_cast<const DataNode*>(Step.Node));
+                    } break;
+                    case Opcode::Operation: {
+                        ApplyOperation(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::AtId: {
+                        ApplyAtId(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::JumpIfDefined: {
+                        if(PushIfDefined(*static_cast<const FunctionNode*>(Step.Node))){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::JumpIfDecided: {
+                        if(PushIfDecided(*static_cast<const FunctionNode*>(Step.Node))){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Truthy: {
+                        PushTruthy(*static_cast<const FunctionNode*>(Step.Node));
+                    } break;
+                    case Opcode::Print: {
+                        PrintData(PopExpressionResult(*static_cast<const ExpressionListNode*>(Step.Node)));
+                        ReleaseTemporaries();
+                    } break;
+                    case Opcode::Jump: {
+                        Counter = Step.Operand;
+                    } continue;
+                    case Opcode::JumpIfFalse: {
+                        const bool Condition = Truthy(PopExpressionResult(*static_cast<const ExpressionListNode*>(Step.Node)));
+                        ReleaseTemporaries();
+                        if(!Condition){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::ForArray: {
+                        const auto &Node = *static_cast<const ForArrayStatementNode*>(Step.Node);
+                        const auto Result = PopExpressionResult(Node.Condition);
+                        if(!Result->is_array())
+                            ThrowRendererError("Object must be an array", Node);
+                        const bool HasItems = BeginLoop(Node, Result);
+                        ReleaseTemporaries();
+                        if(!HasItems){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::ForObject: {
+                        const auto &Node = *static_cast<const ForObjectStatementNode*>(Step.Node);
+                        const auto Result = PopExpressionResult(Node.Condition);
+                        if(!Result->is_object())
+                            ThrowRendererError("Object must be an object", Node);
+                        const bool HasItems = BeginLoop(Node, Result);
+                        ReleaseTemporaries();
+                        if(!HasItems){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Next: {
+                        if(AdvanceLoop()){
+                            Counter = Step.Operand;
+                            continue;
+                        }
+                    } break;
+                    case Opcode::Include: {
+                        Visit(*static_cast<const IncludeStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Extends: {
+                        Visit(*static_cast<const ExtendsStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Block: {
+                        Visit(*static_cast<const BlockStatementNode*>(Step.Node));
+                    } break;
+                    case Opcode::Set: {
+                        const auto &Node = *static_cast<const SetStatementNode*>(Step.Node);
+                        AssignData(Node, PopExpressionResult(Node.Expression));
+                        ReleaseTemporaries();
+                    } break;
+                    case Opcode::Return:
+                        return;
+                }
+                if(BreakRendering){
+                    UnwindLoops(LoopBase);
+                    return;
+                }
+                ++Counter;
+            }
+        }
+
+        public:
+            Renderer(const RenderConfiguration &RenderConfigurationLocal, const TemplateLookup &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
+                : RenderConfigurationInstance(RenderConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal){}
+
+            static bool Truthy(const JSON* Data){
+                if(Data->is_boolean())
+                    return Data->get<bool>();
+                else if(Data->is_number())
+                    return (*Data != 0);
+                else if(Data->is_null())
+                    return false;
+                return !Data->empty();
+            }
+
+            // ! Applies a builtin to values that are already known, used to fold
+            // ! constants, the caller has to make sure the call can not fail
+            JSON Apply(const FunctionNode &Node, const Arguments &Values){
+                for(const auto Value : Values)
+                    DataEvalStack.push_back(Value);
+                ApplyOperation(Node);
+                JSON Result = *DataEvalStack.back();
+                DataEvalStack.pop_back();
+                ReleaseTemporaries();
+                return Result;
+            }
+
+            // ! Writes a value the way an expression prints it
+            void PrintTo(OutputSink &Sink, const JSON &Value){
+                Output = &Sink;
+                PrintData(&Value);
+            }
+            
+            void RenderTo(std::ostream &Stream, const Template &TemplateLocal, const JSON &Data, JSON* LoopData = nullptr){
+                OutputSink Sink(Stream);
+                RenderTo(Sink, TemplateLocal, Data, LoopData);
+            }
+
+            void RenderTo(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data, JSON* LoopData = nullptr){
+                Output = &Sink;
+                CurrentTemplate = &TemplateLocal;
+                DataInput = &Data;
+                if(LoopData && LoopData != &AdditionalData)
+                    AdditionalData = *LoopData;
+                TemplateStack.emplace_back(CurrentTemplate);
+                if(UsesProgram(*CurrentTemplate))
+                    Execute(0);
+                else
+                    CurrentTemplate->Root.Accept(*this);
+                ReleaseTemporaries();
+            }
+
+            // ! Renders the next piece of a streamed template, the values set by the
+            // ! previous pieces are kept
+            void RenderPiece(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data){
+                TemplateStack.clear();
+                RenderTo(Sink, TemplateLocal, Data);
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_RENDERER_HXX
+
+namespace Sydonia{
+    // ! Evaluates the parts of a template that do not depend on the render data,
+    // ! builtins are applied by a renderer so the result is the one a render
+    // ! would give, only calls that can not fail are folded since an error has
+    // ! to be reported when (and if) the expression is rendered
+    class ConstantFolder{
+        using Operation = FunctionStorage::Operation;
+
+        // ! Range() results longer than this are left to the render
+        static constexpr int MaximumRangeLength {65536};
+
+        const TemplateLookup TemplateStorageInstance;
+        const FunctionStorage &FunctionStorageInstance;
+        std::shared_ptr<const JSON> InvariantData;
+        // ! Built the first time something is folded
+        std::optional<Renderer> Evaluator;
+
+        Renderer &GetEvaluator(){
+            if(!Evaluator)
+                Evaluator.emplace(RenderConfiguration(), TemplateStorageInstance, FunctionStorageInstance);
+            return *Evaluator;
+        }
+
+        // ! A number the renderer may read with get<int>() without leaving the int range
+        static bool IsIntLike(const JSON* Value){
+            if(!Value->is_number())
+                return false;
+            if(!Value->is_number_float())
+                return true;
+            const double Number = Value->get<double>();
+            return Number > std::numeric_limits<int>::min() && Number < std::numeric_limits<int>::max();
+        }
+
+        static bool FitsInt(double Number){
+            return Number >= std::numeric_limits<int>::min() && Number <= std::numeric_limits<int>::max();
+        }
+
+        static bool IsRemainderDefined(const JSON* Dividend, const JSON* Divisor){
+            if(!IsIntLike(Dividend) || !IsIntLike(Divisor))
+                return false;
+            const int Value = Divisor->get<int>();
+            return Value != 0 && !(Value == -1 && Dividend->get<int>() == std::numeric_limits<int>::min());
+        }
+
+        // ! Whether the renderer gives the same value for these arguments on every
+        // ! render without throwing
+        static bool CanApply(const FunctionNode &Node, const Arguments &Values){
+            const auto Count = [&](size_t Expected){
+                return Values.size() == Expected;
+            };
+            switch(Node.OperationInstance){
+                case Operation::Not:
+                case Operation::Length:
+                case Operation::IsArray:
+                case Operation::IsBoolean:
+                case Operation::IsFloat:
+                case Operation::IsInteger:
+                case Operation::IsNumber:
+                case Operation::IsObject:
+                case Operation::IsString:
+                    return Count(1);
+                case Operation::And:
+                case Operation::Or:
+                case Operation::In:
+                case Operation::Equal:
+                case Operation::NotEqual:
+                case Operation::Greater:
+                case Operation::GreaterEqual:
+                case Operation::Less:
+                case Operation::LessEqual:
+                    return Count(2);
+                case Operation::Add:
+                    if(!Count(2))
+                        return false;
+                    return (Values[0]->is_string() && Values[1]->is_string()) || (Values[0]->is_number() && Values[1]->is_number());
+                // ! Integers that overflow become floats, these can not fail on numbers
+                case Operation::Subtract:
+                case Operation::Multiplication:
+                case Operation::Power:
+                    return Count(2) && Values[0]->is_number() && Values[1]->is_number();
+                case Operation::Division:
+                case Operation::Modulo:
+                    return Count(2) && Values[0]->is_number() && Values[1]->is_number() && Values[1]->get<double>() != 0;
+                case Operation::DivisibleBy:
+                    return Count(2) && IsIntLike(Values[0]) && IsIntLike(Values[1]) && (Values[1]->get<int>() == 0 || IsRemainderDefined(Values[0], Values[1]));
+                case Operation::Even:
+                case Operation::Odd:
+                    return Count(1) && IsIntLike(Values[0]);
+                case Operation::At: {
+                    if(!Count(2))
+                        return false;
+                    if(Values[0]->is_object())
+                        return Values[1]->is_string() && Values[0]->contains(Values[1]->get_ref<const std::string&>());
+                    return Values[0]->is_array() && IsIntLike(Values[1]) && Values[1]->get<int>() >= 0 &&
+                        static_cast<size_t>(Values[1]->get<int>()) < Values[0]->size();
+                }
+                case Operation::ExistsInObject:
+                    return Count(2) && Values[1]->is_string();
+                case Operation::First:
+                case Operation::Last:
+                case Operation::Max:
+                case Operation::Min:
+                    return Count(1) && !Values[0]->empty();
+                case Operation::Lower:
+                case Operation::Upper:
+                    return Count(1) && Values[0]->is_string();
+                case Operation::Range:
+                    return Count(1) && IsIntLike(Values[0]) && Values[0]->get<int>() >= 0 && Values[0]->get<int>() <= MaximumRangeLength;
+                case Operation::Round: {
+                    if(!Count(2) || !Values[0]->is_number() || !IsIntLike(Values[1]))
+                        return false;
+                    return Values[1]->get<int>() != 0 || FitsInt(std::round(Values[0]->get<double>()));
+                }
+                case Operation::Sort:
+                    return Count(1) && Values[0]->is_array();
+                case Operation::Join:
+                    return Count(2) && Values[1]->is_string();
+                // ! Exists looks at the render data, Float and Int leave parse errors
+                // ! to the render, callbacks and Super() may have side effects
+                default:
+                    return false;
+            }
+        }
+
+        public:
+            explicit ConstantFolder(const TemplateLookup &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal, std::shared_ptr<const JSON> InvariantDataLocal)
+                : TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal), InvariantData(std::move(InvariantDataLocal)){}
+
+            // ! Applies a builtin to constant arguments, false when it has to wait for the render
+            bool Apply(const FunctionNode &Node, const Arguments &Values, JSON &Result){
+                if(!CanApply(Node, Values))
+                    return false;
+                Result = GetEvaluator().Apply(Node, Values);
+                return true;
+            }
+
+            bool HasInvariantData() const{
+                return InvariantData != nullptr;
+            }
+
+            // ! Value of a variable whose head was declared render invariant
+            const JSON* FindInvariant(const DataNode &Node) const{
+                return InvariantData ? Node.Find(*InvariantData) : nullptr;
+            }
+
+            bool Truthy(const JSON &Value) const{
+                return Renderer::Truthy(&Value);
+            }
+
+            // ! Appends the text a render would print for Value
+            void Print(const JSON &Value, std::string &Output){
+                OutputSink Sink(Output);
+                GetEvaluator().PrintTo(Sink, Value);
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_CONSTANT_FOLDER_HXX
+
+namespace Sydonia{
+    // ! Class for lowering the AST of a template into a flat program, given a
+    // ! folder it also evaluates what does not depend on the render data, drops
+    // ! the branches of constant conditions and joins the text around them
+    class Compiler : public NodeVisitor{
+        using Operation = FunctionStorage::Operation;
+        using Opcode = Instruction::Opcode;
+
+        // ! Longest text copied out of the template content to join it with more text
+        static constexpr size_t MaximumJoinedText {1024};
+
+        Program ProgramInstance;
+        std::vector<const BlockStatementNode*> PendingBlocks;
+        ConstantFolder* Folder;
+        std::string_view Content;
+        // ! Instruction a jump lands on last, text is not joined across it
+        size_t Label {0};
+        // ! Whether the expression compiled last left a single constant instruction
+        bool IsConstant {false};
+        // ! Names the template binds itself, the loop variables in scope and every
+        // ! Set, they are never read from the invariant data
+        std::vector<std::string_view> LocalNames;
+
+        bool IsLocalName(std::string_view Name) const{
+            return std::find(LocalNames.begin(), LocalNames.end(), Name) != LocalNames.end();
+        }
+
+        size_t Emit(Opcode OpcodeLocal, const AstNode* Node = nullptr, size_t Operand = 0, size_t Length = 0){
+            ProgramInstance.Instructions.emplace_back(OpcodeLocal, Node, Operand, Length);
+            return ProgramInstance.Instructions.size() - 1;
+        }
+
+        void PatchJump(size_t Index){
+            ProgramInstance.Instructions[Index].Operand = ProgramInstance.Instructions.size();
+            Label = ProgramInstance.Instructions.size();
+        }
+
+        void CompileExpressionList(const ExpressionListNode &Node){
+            IsConstant = false;
+            if(Node.Root)
+                Node.Root->Accept(*this);
+        }
+
+        void EmitConstant(JSON &&Value){
+            Emit(Opcode::Constant, nullptr, ProgramInstance.Constants.size());
+            ProgramInstance.Constants.emplace_back(std::move(Value));
+            IsConstant = true;
+        }
+
+        const JSON* ConstantValue(const Instruction &Step) const{
+            switch(Step.OpcodeInstance){
+                case Opcode::Literal:
+                    return &static_cast<const LiteralNode*>(Step.Node)->Value;
+                case Opcode::Constant:
+                    return &ProgramInstance.Constants[Step.Operand];
+                default:
+                    return ProgramInstance.Invariants[Step.Operand];
+            }
+        }
+
+        // ! Removes the last instruction, which pushes a constant
+        void DropConstant(){
+            const Instruction &Step = ProgramInstance.Instructions.back();
+            if(Step.OpcodeInstance == Opcode::Constant && Step.Operand + 1 == ProgramInstance.Constants.size())
+                ProgramInstance.Constants.pop_back();
+            else if(Step.OpcodeInstance == Opcode::Invariant && Step.Operand + 1 == ProgramInstance.Invariants.size())
+                ProgramInstance.Invariants.pop_back();
+            ProgramInstance.Instructions.pop_back();
+        }
+
+        // ! Replaces the constant arguments on top of the program by the result
+        // ! of the function, false when it has to be applied when rendering
+        bool FoldOperation(const FunctionNode &Node){
+            const size_t Count = Node.Arguments.size();
+            Arguments Values(Count);
+            for(size_t Iterator = 0; Iterator < Count; Iterator += 1)
+                Values[Iterator] = ConstantValue(ProgramInstance.Instructions[ProgramInstance.Instructions.size() - Count + Iterator]);
+            JSON Result;
+            if(!Folder->Apply(Node, Values, Result))
+                return false;
+            for(size_t Iterator = 0; Iterator < Count; Iterator += 1)
+                DropConstant();
+            EmitConstant(std::move(Result));
+            return true;
+        }
+
+        // ! The previous instruction when it writes text that more text can be added to
+        Instruction* OpenText(){
+            if(!Folder || ProgramInstance.Instructions.size() <= Label)
+                return nullptr;
+            Instruction &Last = ProgramInstance.Instructions.back();
+            if(Last.OpcodeInstance != Opcode::Text && Last.OpcodeInstance != Opcode::ConstantText)
+                return nullptr;
+            return &Last;
+        }
+
+        // ! Appends Text to the previous text instruction, which is moved out of
+        // ! the template content first, false when they are better kept apart
+        bool JoinText(std::string_view Text){
+            Instruction* Last = OpenText();
+            if(!Last || Last->Length + Text.size() > MaximumJoinedText)
+                return false;
+            if(Last->OpcodeInstance == Opcode::Text){
+                Last->OpcodeInstance = Opcode::ConstantText;
+                const size_t Position = Last->Operand;
+                Last->Operand = ProgramInstance.Text.size();
+                ProgramInstance.Text.append(Content.substr(Position, Last->Length));
+            }
+            ProgramInstance.Text.append(Text);
+            Last->Length += Text.size();
+            return true;
+        }
+
+        // ! Compiles a branch that is never taken and throws the code away, the
+        // ! blocks in it are kept since a child template may still render them
+        void DropBranch(const BlockNode &Branch){
+            const size_t Instructions = ProgramInstance.Instructions.size(), Constants = ProgramInstance.Constants.size();
+            const size_t Invariants = ProgramInstance.Invariants.size(), Text = ProgramInstance.Text.size();
+            const size_t PreviousLabel = Label;
+            Label = Instructions;
+            Branch.Accept(*this);
+            ProgramInstance.Instructions.erase(ProgramInstance.Instructions.begin() + Instructions, ProgramInstance.Instructions.end());
+            ProgramInstance.Constants.resize(Constants);
+            ProgramInstance.Invariants.resize(Invariants);
+            ProgramInstance.Text.resize(Text);
+            Label = PreviousLabel;
+        }
+
+        void EmitConstantText(std::string_view Text){
+            if(Text.empty() || JoinText(Text))
+                return;
+            Emit(Opcode::ConstantText, nullptr, ProgramInstance.Text.size(), Text.size());
+            ProgramInstance.Text.append(Text);
+        }
+
+        void Visit(const BlockNode &Node){
+            for(auto &SubNode : Node.Nodes)
+                SubNode->Accept(*this);
+        }
+
+        void Visit(const TextNode &Node){
+            Instruction* Last = OpenText();
+            if(Last && Last->OpcodeInstance == Opcode::Text && Last->Operand + Last->Length == Node.Position){
+                Last->Length += Node.Length;
+                return;
+            }
+            if(!JoinText(Content.substr(Node.Position, Node.Length)))
+                Emit(Opcode::Text, &Node, Node.Position, Node.Length);
+        }
+
+        void Visit(const ExpressionNode&){}
+
+        void Visit(const LiteralNode &Node){
+            Emit(Opcode::Literal, &Node);
+            IsConstant = Folder;
+        }
+
+        void Visit(const DataNode &Node){
+            const bool CanFold = Folder && Node.LoopAccessInstance.MemberInstance == DataNode::LoopAccess::Member::None && !IsLocalName(Node.Head());
+            const JSON* Value = CanFold ? Folder->FindInvariant(Node) : nullptr;
+            if(Value){
+                Emit(Opcode::Invariant, &Node, ProgramInstance.Invariants.size());
+                ProgramInstance.Invariants.emplace_back(Value);
+                auto &Heads = ProgramInstance.InvariantHeads;
+                if(std::find(Heads.begin(), Heads.end(), Node.Head()) == Heads.end())
+                    Heads.emplace_back(Node.Head());
+            }else
+                Emit(Opcode::Data, &Node);
+            IsConstant = Value;
+        }
+
+        void Visit(const FunctionNode &Node){
+            switch(Node.OperationInstance){
+                case Operation::AtId: {
+                    if(!Node.Arguments.empty())
+                        Node.Arguments[0]->Accept(*this);
+                    Emit(Opcode::AtId, &Node);
+                    IsConstant = false;
+                } break;
+                case Operation::Default: {
+                    // ! The fallback is only evaluated when the first argument is missing
+                    Node.Arguments[0]->Accept(*this);
+                    if(IsConstant)
+                        break;
+                    const size_t Jump = Emit(Opcode::JumpIfDefined, &Node);
+                    Node.Arguments[1]->Accept(*this);
+                    PatchJump(Jump);
+                    IsConstant = false;
+                } break;
+                case Operation::And:
+                case Operation::Or: {
+                    // ! The second argument is only evaluated when the first one does not decide
+                    Node.Arguments[0]->Accept(*this);
+                    if(IsConstant){
+                        const bool First = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                        DropConstant();
+                        if(First == (Node.OperationInstance == Operation::Or)){
+                            EmitConstant(First);
+                            break;
+                        }
+                        Node.Arguments[1]->Accept(*this);
+                        if(IsConstant){
+                            const bool Second = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                            DropConstant();
+                            EmitConstant(Second);
+                            break;
+                        }
+                        Emit(Opcode::Truthy, &Node);
+                        break;
+                    }
+                    const size_t Jump = Emit(Opcode::JumpIfDecided, &Node);
+                    Node.Arguments[1]->Accept(*this);
+                    Emit(Opcode::Truthy, &Node);
+                    PatchJump(Jump);
+                    IsConstant = false;
+                } break;
+                default: {
+                    // ! A lazy callback evaluates its arguments itself
+                    if(Node.OperationInstance == Operation::Callback && Node.Callback->LazyFunction){
+                        Emit(Opcode::Operation, &Node);
+                        IsConstant = false;
+                        break;
+                    }
+                    bool Constant = Folder;
+                    for(auto &Argument : Node.Arguments){
+                        Argument->Accept(*this);
+                        Constant = Constant && IsConstant;
+                    }
+                    if(Constant && FoldOperation(Node))
+                        break;
+                    Emit(Opcode::Operation, &Node);
+                    IsConstant = false;
+                }
+            }
+        }
+
+        void Visit(const ExpressionListNode &Node){
+            CompileExpressionList(Node);
+            if(IsConstant){
+                std::string Text;
+                Folder->Print(*ConstantValue(ProgramInstance.Instructions.back()), Text);
+                DropConstant();
+                EmitConstantText(Text);
+                return;
+            }
+            Emit(Opcode::Print, &Node);
+        }
+
+        void Visit(const StatementNode&){}
+        void Visit(const ForStatementNode&){}
+
+        void Visit(const ForArrayStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            const size_t Exit = Emit(Opcode::ForArray, &Node);
+            LocalNames.emplace_back(Node.Value);
+            Node.Body.Accept(*this);
+            LocalNames.pop_back();
+            Emit(Opcode::Next, &Node, Exit + 1);
+            PatchJump(Exit);
+        }
+
+        void Visit(const ForObjectStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            const size_t Exit = Emit(Opcode::ForObject, &Node);
+            LocalNames.emplace_back(Node.Key);
+            LocalNames.emplace_back(Node.Value);
+            Node.Body.Accept(*this);
+            LocalNames.resize(LocalNames.size() - 2);
+            Emit(Opcode::Next, &Node, Exit + 1);
+            PatchJump(Exit);
+        }
+
+        void Visit(const IfStatementNode &Node){
+            CompileExpressionList(Node.Condition);
+            if(IsConstant){
+                // ! Only the branch taken is compiled
+                const bool Taken = Folder->Truthy(*ConstantValue(ProgramInstance.Instructions.back()));
+                DropConstant();
+                if(Taken){
+                    Node.TrueStatement.Accept(*this);
+                    DropBranch(Node.FalseStatement);
+                }else{
+                    DropBranch(Node.TrueStatement);
+                    Node.FalseStatement.Accept(*this);
+                }
+                return;
+            }
+            const size_t FalseJump = Emit(Opcode::JumpIfFalse, &Node.Condition);
+            Node.TrueStatement.Accept(*this);
+            if(Node.HasFalseStatement){
+                const size_t EndJump = Emit(Opcode::Jump, &Node);
+                PatchJump(FalseJump);
+                Node.FalseStatement.Accept(*this);
+                PatchJump(EndJump);
+            }else
+                PatchJump(FalseJump);
+        }
+
+        void Visit(const IncludeStatementNode &Node){
+            Emit(Opcode::Include, &Node);
+        }
+
+        void Visit(const ExtendsStatementNode &Node){
+            Emit(Opcode::Extends, &Node);
+        }
+
+        void Visit(const BlockStatementNode &Node){
+            // ! Block bodies are placed out of line, the renderer decides which
+            // ! template in the inheritance chain provides the body to run
+            Emit(Opcode::Block, &Node);
+            PendingBlocks.emplace_back(&Node);
+        }
+
+        void Visit(const SetStatementNode &Node){
+            CompileExpressionList(Node.Expression);
+            Emit(Opcode::Set, &Node);
+        }
+
+        public:
+            explicit Compiler(ConstantFolder* FolderLocal = nullptr): Folder(FolderLocal){}
+
+            Program Compile(const Template &TemplateLocal){
+                ProgramInstance = Program();
+                PendingBlocks.clear();
+                Content = TemplateLocal.Content;
+                Label = 0;
+                LocalNames.clear();
+                if(Folder && Folder->HasInvariantData()){
+                    StatisticsVisitor Statistics;
+                    TemplateLocal.Root.Accept(Statistics);
+                    LocalNames = std::move(Statistics.AssignedNames);
+                }
+                TemplateLocal.Root.Accept(*this);
+                Emit(Opcode::Return);
+                for(size_t Iterator = 0; Iterator < PendingBlocks.size(); Iterator += 1){
+                    const auto Block = PendingBlocks[Iterator];
+                    Label = ProgramInstance.Instructions.size();
+                    ProgramInstance.Blocks.emplace(Block->Name, Label);
+                    Block->Block.Accept(*this);
+                    Emit(Opcode::Return);
+                }
+                return std::move(ProgramInstance);
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_COMPILER_HXX
+
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_LEXER_HXX
+#define SYDONIA_LEXER_HXX
+
+#include <cctype>
+#include <locale>
+
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_CHARACTER_SCANNER_HXX
+#define SYDONIA_CHARACTER_SCANNER_HXX
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SYDONIA_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SYDONIA_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace Sydonia{
+    // ! Finds the next byte that belongs to a small set of characters, the
+    // ! lexer uses it to skip over static text until a possible opener, up to
+    // ! four characters are compared 32 (AVX2) or 16 (SSE2) bytes at a time
+    // ! and a lookup table handles larger sets and the remaining bytes
+    class CharacterScanner{
+        static constexpr size_t MaximumVectorCharacters {4};
+
+        std::array<bool, 256> Table {};
+        std::array<char, MaximumVectorCharacters> Characters {};
+        size_t Count {0};
+
+        static unsigned CountTrailingZeros(std::uint32_t Mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long Index;
+            _BitScanForward(&Index, Mask);
+            return static_cast<unsigned>(Index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(Mask));
+#endif
+        }
+
+        public:
+            explicit CharacterScanner(std::string_view Set){
+                for(const char Character : Set){
+                    if(Table[static_cast<unsigned char>(Character)])
+                        continue;
+                    Table[static_cast<unsigned char>(Character)] = true;
+                    if(Count < MaximumVectorCharacters)
+                        Characters[Count] = Character;
+                    Count += 1;
+                }
+                // ! Unused slots repeat the first character so every block is
+                // ! compared against a fixed number of characters
+                for(size_t Iterator = Count; Iterator < MaximumVectorCharacters && Count > 0; Iterator += 1)
+                    Characters[Iterator] = Characters[0];
+            }
+
+            // ! Position of the first character of the set at or after From for which
+            // ! Accept returns true, or npos, every candidate of a block is offered
+            // ! to Accept before the next block is loaded
+            template<typename Predicate>
+            size_t Find(std::string_view Input, size_t From, Predicate &&Accept) const{
+                const char* Data = Input.data();
+                const size_t Size = Input.size();
+                size_t Position = From;
+                if(Count == 0)
+                    return std::string_view::npos;
+                if(Count == 1){
+                    while(Position < Size){
+                        const void* Found = std::memchr(Data + Position, Characters[0], Size - Position);
+                        if(!Found)
+                            return std::string_view::npos;
+                        Position = static_cast<const char*>(Found) - Data;
+                        if(Accept(Position))
+                            return Position;
+                        Position += 1;
+                    }
+                    return std::string_view::npos;
+                }
+                if(Count <= MaximumVectorCharacters){
+#if defined(SYDONIA_SCAN_AVX2)
+                    const __m256i First = _mm256_set1_epi8(Characters[0]), Second = _mm256_set1_epi8(Characters[1]);
+                    const __m256i Third = _mm256_set1_epi8(Characters[2]), Fourth = _mm256_set1_epi8(Characters[3]);
+                    for(; Position + 32 <= Size; Position += 32){
+                        const __m256i Block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Data + Position));
+                        const __m256i Matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(Block, First), _mm256_cmpeq_epi8(Block, Second)),
+                                                                _mm256_or_si256(_mm256_cmpeq_epi8(Block, Third), _mm256_cmpeq_epi8(Block, Fourth)));
+                        for(std::uint32_t Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(Matches)); Mask; Mask &= Mask - 1)
+                            if(Accept(Position + CountTrailingZeros(Mask)))
+                                return Position + CountTrailingZeros(Mask);
+                    }
+#elif defined(SYDONIA_SCAN_SSE2)
+                    const __m128i First = _mm_set1_epi8(Characters[0]), Second = _mm_set1_epi8(Characters[1]);
+                    const __m128i Third = _mm_set1_epi8(Characters[2]), Fourth = _mm_set1_epi8(Characters[3]);
+                    for(; Position + 16 <= Size; Position += 16){
+                        const __m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + Position));
+                        const __m128i Matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, First), _mm_cmpeq_epi8(Block, Second)),
+                                                             _mm_or_si128(_mm_cmpeq_epi8(Block, Third), _mm_cmpeq_epi8(Block, Fourth)));
+                        for(std::uint32_t Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(Matches)); Mask; Mask &= Mask - 1)
+                            if(Accept(Position + CountTrailingZeros(Mask)))
+                                return Position + CountTrailingZeros(Mask);
+                    }
+#endif
+                }
+                for(; Position < Size; Position += 1)
+                    if(Table[static_cast<unsigned char>(Data[Position])] && Accept(Position))
+                        return Position;
+                return std::string_view::npos;
+            }
+
+            // ! Position of the first character of the set at or after From, or npos
+            size_t Find(std::string_view Input, size_t From) const{
+                return Find(Input, From, [](size_t){
+                    return true;
+                });
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_CHARACTER_SCANNER_HXX
+
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TOKEN_HXX
+#define SYDONIA_TOKEN_HXX
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Sydonia{
+    // ! Helper struct for the Sydonia Lexer
+    struct Token{
+        enum class Kind{
+            Text,
+            ExpressionOpen,     // {{
+            ExpressionClose,    // }}
+            LineStatementOpen,  // ##
+            LineStatementClose, // \n
+            StatementOpen,      // {%
+            StatementClose,     // %}
+            CommentOpen,        // {#
+            CommentClose,       // #}
+            Id,                 // this, this.foo
+            Number,             // 1, 2, -1, 5.2, -5.3
+            String,             // "this"
+            Plus,               // +
+            Minus,              // -
+            Times,              // *
+            Slash,              // /
+            Percent,            // %
+            Power,              // ^
+            Comma,              // ,
+            Dot,                // .
+            Colon,              // :
+            LeftParen,          // (
+            RightParen,         // )
+            LeftBracket,        // [
+            RightBracket,       // ]
+            LeftBrace,          // {
+            RightBrace,         // }
+            Equal,              // ==
+            NotEqual,           // !=
+            GreaterThan,        // >
+            GreaterEqual,       // >=
+            LessThan,           // <
+            LessEqual,          // <=
+            Unknown,
+            Eof,
+        };
+
+        // ! Identifiers that are reserved words, they keep the Id kind so they can
+        // ! still be used where any name is accepted
+        enum class Keyword : std::uint8_t{
+            None,
+            If,
+            Else,
+            EndIf,
+            Block,
+            EndBlock,
+            For,
+            EndFor,
+            In,
+            Include,
+            Extends,
+            Set,
+            And,
+            Or,
+            Not,
+            True,
+            False,
+            Null,
+        };
+
+        Kind KindInstance {Kind::Unknown};
+        Keyword KeywordInstance {Keyword::None};
+        std::string_view Text;
+
+        explicit constexpr Token() = default;
+        explicit constexpr Token(Kind KindLocalInstance, std::string_view TextLocal)
+            : KindInstance(KindLocalInstance), Text(TextLocal){}
+        explicit constexpr Token(Kind KindLocalInstance, Keyword KeywordLocal, std::string_view TextLocal)
+            : KindInstance(KindLocalInstance), KeywordInstance(KeywordLocal), Text(TextLocal){}
+
+        bool Is(Keyword KeywordLocal) const{
+            return KindInstance == Kind::Id && KeywordInstance == KeywordLocal;
+        }
+
+        std::string Describe() const{
+            switch(KindInstance){
+                case Kind::Text:
+                    return "<Text>";
+                case Kind::LineStatementClose:
+                    return "<Eol>";
+                case Kind::Eof:
+                    return "<Eof>";
+                default:
+                    return static_cast<std::string>(Text);
+            }
+        } 
+    };
+
+    namespace Keywords{
+        struct Entry{
+            std::string_view Text;
+            Token::Keyword KeywordInstance {Token::Keyword::None};
+        };
+
+        constexpr std::array<Entry, 17> List {{
+            {"If", Token::Keyword::If}, {"Else", Token::Keyword::Else}, {"EndIf", Token::Keyword::EndIf},
+            {"Block", Token::Keyword::Block}, {"EndBlock", Token::Keyword::EndBlock}, {"For", Token::Keyword::For},
+            {"EndFor", Token::Keyword::EndFor}, {"In", Token::Keyword::In}, {"Include", Token::Keyword::Include},
+            {"Extends", Token::Keyword::Extends}, {"Set", Token::Keyword::Set}, {"And", Token::Keyword::And},
+            {"Or", Token::Keyword::Or}, {"Not", Token::Keyword::Not}, {"True", Token::Keyword::True},
+            {"False", Token::Keyword::False}, {"NULL", Token::Keyword::Null},
+        }};
+
+        constexpr size_t TableSize {32};
+
+        // ! Perfect hash over the keyword list, length plus first and last
+        // ! character tell every keyword apart
+        constexpr size_t Hash(std::string_view Text){
+            return (Text.size() * 4 + static_cast<unsigned char>(Text.front()) * 20 + static_cast<unsigned char>(Text.back())) % TableSize;
+        }
+
+        constexpr std::array<Entry, TableSize> BuildTable(){
+            std::array<Entry, TableSize> Result {};
+            for(const auto &EntryInstance : List)
+                Result[Hash(EntryInstance.Text)] = EntryInstance;
+            return Result;
+        }
+
+        constexpr std::array<Entry, TableSize> Table = BuildTable();
+
+        constexpr bool IsPerfect(){
+            for(const auto &EntryInstance : List)
+                if(Table[Hash(EntryInstance.Text)].KeywordInstance != EntryInstance.KeywordInstance)
+                    return false;
+            return true;
+        }
+
+        static_assert(IsPerfect(), "Two keywords share a slot of the keyword table");
+
+        // ! Keyword spelled by Text, None for any other identifier
+        inline Token::Keyword Classify(std::string_view Text){
+            if(Text.size() < 2 || Text.size() > 8)
+                return Token::Keyword::None;
+            const Entry &EntryInstance = Table[Hash(Text)];
+            return EntryInstance.Text == Text ? EntryInstance.KeywordInstance : Token::Keyword::None;
+        }
+    }; // ! Keywords namespace
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TOKEN_HXX
+
+namespace Sydonia{
+  // ! Class for lexing an Sydonia Template.
+  class Lexer{
+    enum class State{
+      Text,
+      ExpressionStart,
+      ExpressionStartForceLstrip,
+      ExpressionBody,
+      LineStart,
+      LineBody,
+      StatementStart,
+      StatementStartNoLstrip,
+      StatementStartForceLstrip,
+      StatementBody,
+      CommentStart,
+      CommentStartForceLstrip,
+      CommentBody,
+    };
+
+    enum class MinusState{
+      Operator,
+      Number,
+    };
+
+    const LexerConfiguration& LexerConfigurationInstance;
+    const CharacterScanner OpenScanner;
+
+    State StateInstance;
+    MinusState MinusStateInstance;
+    std::string_view M_IN;
+    size_t TokenStart;
+    size_t Position;
+
+    Token ScanBody(std::string_view Close, Token::Kind CloseKind, std::string_view CloseTrim = std::string_view(), bool Trim = false){
+    Again:
+      // ! Skip whitespace (except for \n as it might be a close)
+      if(TokenStart >= M_IN.size())
+        return MakeToken(Token::Kind::Eof);
+      const char Character = M_IN[TokenStart];
+      if(Character == ' ' || Character == '\t' || Character == '\r') {
+        TokenStart += 1;
+        goto Again;
+      }
+
+      // ! Check for close
+      if(!CloseTrim.empty() && StringView::StartsWith(M_IN.substr(TokenStart), CloseTrim)){
+        StateInstance = State::Text;
+        Position = TokenStart + CloseTrim.size();
+        const Token TokenInstance = MakeToken(CloseKind);
+        SkipWhiteSpacesAndNewLines();
+        return TokenInstance;
+      }
+
+      if(StringView::StartsWith(M_IN.substr(TokenStart), Close)){
+        StateInstance = State::Text;
+        Position = TokenStart + Close.size();
+        const Token TokenInstance = MakeToken(CloseKind);
+        if(Trim)
+          SkipWhiteSpacesAndFirstNewLine();
+        return TokenInstance;
+      }
+
+      // ! Skip \n
+      if(Character == '\n'){
+        TokenStart += 1;
+        goto Again;
+      }
+
+      Position = TokenStart + 1;
+      if(std::isalpha(Character)){
+        MinusStateInstance = MinusState::Operator;
+        return ScanID();
+      }
+
+      const MinusState CurrentMinusState = MinusStateInstance;
+      if(MinusStateInstance == MinusState::Operator)
+        MinusStateInstance = MinusState::Number;
+
+      switch(Character){
+        case '+':
+          return MakeToken(Token::Kind::Plus);
+        case '-':
+          if(CurrentMinusState == MinusState::Operator)
+            return MakeToken(Token::Kind::Minus);
+          return ScanNumber();
+        case '*':
+          return MakeToken(Token::Kind::Times);
+        case '/':
+          return MakeToken(Token::Kind::Slash);
+        case '^':
+          return MakeToken(Token::Kind::Power);
+        case '%':
+          return MakeToken(Token::Kind::Percent);
+        case '.':
+          return MakeToken(Token::Kind::Dot);
+        case ',':
+          return MakeToken(Token::Kind::Comma);
+        case ':':
+          return MakeToken(Token::Kind::Colon);
+        case '(':
+          return MakeToken(Token::Kind::LeftParen);
+        case ')':
+          MinusStateInstance = MinusState::Operator;
+          return MakeToken(Token::Kind::RightParen);
+        case '[':
+          return MakeToken(Token::Kind::LeftBracket);
+        case ']':
+          MinusStateInstance = MinusState::Operator;
+          return MakeToken(Token::Kind::RightBracket);
+        case '{':
+          return MakeToken(Token::Kind::LeftBrace);
+        case '}':
+          MinusStateInstance = MinusState::Operator;
+          return MakeToken(Token::Kind::RightBrace);
+        case '>':
+          if(Position < M_IN.size() && M_IN[Position] == '='){
+            Position += 1;
+            return MakeToken(Token::Kind::GreaterEqual);
+          }
+          return MakeToken(Token::Kind::GreaterThan);
+        case '<':
+          if (Position < M_IN.size() && M_IN[Position] == '='){
+            Position += 1;
+            return MakeToken(Token::Kind::LessEqual);
+          }
+          return MakeToken(Token::Kind::LessThan);
+        case '=':
+          if(Position < M_IN.size() && M_IN[Position] == '='){
+            Position += 1;
+            return MakeToken(Token::Kind::Equal);
+          }
+          return MakeToken(Token::Kind::Unknown);
+        case '!':
+          if(Position < M_IN.size() && M_IN[Position] == '='){
+            Position += 1;
+            return MakeToken(Token::Kind::NotEqual);
+          }
+          return MakeToken(Token::Kind::Unknown);
+        case '\"':
+          return ScanString();
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+          MinusStateInstance = MinusState::Operator;
+          return ScanNumber();
+        case '_':
+        case '@':
+        case '$':
+          MinusStateInstance = MinusState::Operator;
+          return ScanID();
+        default:
+          return MakeToken(Token::Kind::Unknown);
+      }
+    }
+
+    Token ScanID(){
+      for(;;){
+        if(Position >= M_IN.size())
+          break;
+        const char Character = M_IN[Position];
+        if(!std::isalnum(Character) && Character != '.' && Character != '/' && Character != '_' && Character != '-')
+          break;
+        Position += 1;
+      }
+      const std::string_view Text = StringView::Slice(M_IN, TokenStart, Position);
+      return Token(Token::Kind::Id, Keywords::Classify(Text), Text);
+    }
+
+    Token ScanNumber(){
+      for(;;){
+        if(Position >= M_IN.size())
+          break;
+        const char Character = M_IN[Position];
+        // ! Be very permissive in lexer (we'll catch errors when conversion happens)
+        if(!(std::isdigit(Character) || Character == '.' || Character == 'e' || Character == 'E' || (Character == '+' && (Position == 0 || M_IN[Position - 1] == 'e' || M_IN[Position - 1] == 'E')) || (Character == '-' && (Position == 0 || M_IN[Position - 1] == 'e' || M_IN[Position - 1] == 'E'))))
+          break;
+        Position += 1;
+      }
+      return MakeToken(Token::Kind::Number);
+    }
+
+    Token ScanString(){
+      bool Escape {false};
+      for(;;){
+        if(Position >= M_IN.size())
+          break;
+        const char Character = M_IN[Position++];
+        if(Escape)
+          Escape = false;
+        else if(Character == '\\')
+          Escape = true;
+        else if(Character == M_IN[TokenStart])
+          break;
+      }
+      return MakeToken(Token::Kind::String);
+    }
+
+    Token MakeToken(Token::Kind KindLocal) const{
+      return Token(KindLocal, StringView::Slice(M_IN, TokenStart, Position));
+    }
+
+    void SkipWhiteSpacesAndNewLines(){
+      if(Position < M_IN.size())
+        while(Position < M_IN.size() && (M_IN[Position] == ' ' || M_IN[Position] == '\t' || M_IN[Position] == '\n' || M_IN[Position] == '\r'))
+          Position += 1;
+    }
+
+    void SkipWhiteSpacesAndFirstNewLine() {
+      if(Position < M_IN.size())
+        while(Position < M_IN.size() && (M_IN[Position] == ' ' || M_IN[Position] == '\t'))
+          Position += 1;
+
+      if(Position < M_IN.size()){
+        const char Character = M_IN[Position];
+        if(Character == '\n')
+          Position += 1;
+        else if(Character == '\r'){
+          Position += 1;
+          if(Position < M_IN.size() && M_IN[Position] == '\n')
+            Position += 1;
+        }
+      }
+    }
+
+    static std::string_view ClearFinalLineIfWhiteSpace(std::string_view Text){
+      std::string_view Result = Text;
+      while(!Result.empty()){
+        const char Character = Result.back();
+        if (Character == ' ' || Character == '\t')
+          Result.remove_suffix(1);
+        else if (Character == '\n' || Character == '\r')
+          break;
+        else
+          return Text;
+      }
+      return Result;
+    }
+
+    // ! Openers that start at Offset, a variant (force lstrip and so on) only
+    // ! counts together with its plain opener and a line statement only at the
+    // ! start of a line
+    OpenerMatcher::Set MatchOpeners(size_t Offset) const{
+      OpenerMatcher::Set Matches = LexerConfigurationInstance.OpenerMatcherInstance.Match(M_IN.substr(Offset));
+      if(Offset != 0 && M_IN[Offset - 1] != '\n')
+        Matches &= ~OpenerMatcher::Bit(Opener::LineStatement);
+      constexpr OpenerMatcher::Set Plain = OpenerMatcher::Bit(Opener::Expression) | OpenerMatcher::Bit(Opener::Statement) |
+        OpenerMatcher::Bit(Opener::Comment) | OpenerMatcher::Bit(Opener::LineStatement);
+      return (Matches & Plain) ? Matches : 0;
+    }
+
+  public:
+    explicit Lexer(const LexerConfiguration& LexerConfigurationLocal)
+      : LexerConfigurationInstance(LexerConfigurationLocal), OpenScanner(LexerConfigurationLocal.OpenCharacters), StateInstance(State::Text), 
+        MinusStateInstance(MinusState::Number){}
+
+    SourceLocation CurrentPosition() const{
+      return GetSourceLocation(M_IN, TokenStart);
+    }
+
+    // ! Starts lexing Input in the text state at Offset, which has to be the
+    // ! start of a text token when it isn't zero
+    void Start(std::string_view Input, size_t Offset = 0){
+      M_IN = Input;
+      StateInstance = State::Text;
+      MinusStateInstance = MinusState::Number;
+
+      // ! Consume byte order mark (BOM) for UTF-8
+      if(StringView::StartsWith(M_IN, "\xEF\xBB\xBF")){
+        M_IN = M_IN.substr(3);
+        Offset = (Offset > 3) ? Offset - 3 : 0;
+      }
+      TokenStart = Offset;
+      Position = Offset;
+    }
+
+    Token Scan(){
+      TokenStart = Position;
+
+    Again:
+      if(TokenStart >= M_IN.size())
+        return MakeToken(Token::Kind::Eof);
+
+      switch(StateInstance){
+        default:
+        case State::Text: {
+          // ! Fast-scan to first open character, classifying each candidate once
+          OpenerMatcher::Set Matches = 0;
+          const size_t OpenStart = OpenScanner.Find(M_IN, Position, [this, &Matches](size_t Candidate){
+            Matches = MatchOpeners(Candidate);
+            return Matches != 0;
+          });
+          if(OpenStart == std::string_view::npos){
+            // ! Didn't find open, return remaining text as text token
+            Position = M_IN.size();
+            return MakeToken(Token::Kind::Text);
+          }
+          Position = OpenStart;
+
+          // ! Pick the opening sequence, and get the close
+          const auto Has = [Matches](Opener OpenerLocal){
+            return (Matches & OpenerMatcher::Bit(OpenerLocal)) != 0;
+          };
+          bool MustLstrip = false;
+          if(Has(Opener::Expression)){
+            if(Has(Opener::ExpressionForceLstrip)){
+              StateInstance = State::ExpressionStartForceLstrip;
+              MustLstrip = true;
+            }else
+              StateInstance = State::ExpressionStart;
+          }else if(Has(Opener::Statement)){
+            if(Has(Opener::StatementNoLstrip))
+              StateInstance = State::StatementStartNoLstrip;
+            else if(Has(Opener::StatementForceLstrip)){
+              StateInstance = State::StatementStartForceLstrip;
+              MustLstrip = true;
+            }else{
+              StateInstance = State::StatementStart;
+              MustLstrip = LexerConfigurationInstance.LstripBlocks;
+            }
+          }else if(Has(Opener::Comment)){
+            if(Has(Opener::CommentForceLstrip)){
+              StateInstance = State::CommentStartForceLstrip;
+              MustLstrip = true;
+            }else{
+              StateInstance = State::CommentStart;
+              MustLstrip = LexerConfigurationInstance.LstripBlocks;
+            }
+          }else
+            StateInstance = State::LineStart;
+          // ! Every tag starts lexing the same way, whatever the previous one ended with
+          MinusStateInstance = MinusState::Number;
+
+          std::string_view Text = StringView::Slice(M_IN, TokenStart, Position);
+          if(MustLstrip)
+            Text = ClearFinalLineIfWhiteSpace(Text);
+
+          if(Text.empty()){
+            // ! // don't generate empty token
+            goto Again; 
+          }
+          return Token(Token::Kind::Text, Text);
+        }
+        case State::ExpressionStart: {
+          StateInstance = State::ExpressionBody;
+          Position += LexerConfigurationInstance.ExpressionOpen.size();
+          return MakeToken(Token::Kind::ExpressionOpen);
+        }
+        case State::ExpressionStartForceLstrip: {
+          StateInstance = State::ExpressionBody;
+          Position += LexerConfigurationInstance.ExpressionOpenForceLstrip.size();
+          return MakeToken(Token::Kind::ExpressionOpen);
+        }
+        case State::LineStart: {
+          StateInstance = State::LineBody;
+          Position += LexerConfigurationInstance.LineStatement.size();
+          return MakeToken(Token::Kind::LineStatementOpen);
+        }
+        case State::StatementStart: {
+          StateInstance = State::StatementBody;
+          Position += LexerConfigurationInstance.StatementOpen.size();
+          return MakeToken(Token::Kind::StatementOpen);
+        }
+        case State::StatementStartNoLstrip: {
+          StateInstance = State::StatementBody;
+          Position += LexerConfigurationInstance.StatementOpenNoLstrip.size();
+          return MakeToken(Token::Kind::StatementOpen);
+        }
+        case State::StatementStartForceLstrip: {
+          StateInstance = State::StatementBody;
+          Position += LexerConfigurationInstance.StatementOpenForceLstrip.size();
+          return MakeToken(Token::Kind::StatementOpen);
+        }
+        case State::CommentStart: {
+          StateInstance = State::CommentBody;
+          Position += LexerConfigurationInstance.CommentOpen.size();
+          return MakeToken(Token::Kind::CommentOpen);
+        }
+        case State::CommentStartForceLstrip: {
+          StateInstance = State::CommentBody;
+          Position += LexerConfigurationInstance.CommentOpenForceLstrip.size();
+          return MakeToken(Token::Kind::CommentOpen);
+        }
+        case State::ExpressionBody:
+          return ScanBody(LexerConfigurationInstance.ExpressionClose, 
+                    Token::Kind::ExpressionClose, LexerConfigurationInstance.ExpressionCloseForceRstrip);
+        case State::LineBody:
+          return ScanBody("\n", Token::Kind::LineStatementClose);
+        case State::StatementBody:
+          return ScanBody(LexerConfigurationInstance.StatementClose, 
+                  Token::Kind::StatementClose, LexerConfigurationInstance.StatementCloseForceRstrip, LexerConfigurationInstance.TrimBlocks);
+        case State::CommentBody: {
+          // ! Fast-scan to comment close
+          const size_t End = M_IN.substr(Position).find(LexerConfigurationInstance.CommentClose);
+          if(End == std::string_view::npos){
+            Position = M_IN.size();
+            return MakeToken(Token::Kind::Eof);
+          }
+
+          // ! Check for trim pattern
+          const bool MustRstrip = StringView::StartsWith(M_IN.substr(Position + End - 1), LexerConfigurationInstance.CommentCloseForceRstrip);
+
+          // ! Return the entire comment in the close token
+          StateInstance = State::Text;
+          Position += End + LexerConfigurationInstance.CommentClose.size();
+          Token TokenInstance = MakeToken(Token::Kind::CommentClose);
+          if(MustRstrip || LexerConfigurationInstance.TrimBlocks) 
+            SkipWhiteSpacesAndFirstNewLine();
+          return TokenInstance;
+        }
+      }
+    }
+
+    const LexerConfiguration& GetConfiguration() const{
+      return LexerConfigurationInstance;
+    }
+  };
+}; // ! Namespace Sydonia
+
+#endif // ! SYDONIA_LEXER_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_LITERALS_HXX
+#define SYDONIA_LITERALS_HXX
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace Sydonia{
+    // ! Decoding of literal tokens straight into values, the result is the same
+    // ! JSON::parse gives for the token text
+    namespace Literals{
+        inline bool IsDigit(char Character){
+            return Character >= '0' && Character <= '9';
+        }
+
+        inline bool DecodeFloat(std::string_view Text, JSON &Value){
+            double Result = 0;
+#if defined(__cpp_lib_to_chars)
+            const auto Status = std::from_chars(Text.data(), Text.data() + Text.size(), Result);
+            if(Status.ec == std::errc()){
+                Value = Result;
+                return true;
+            }
+#endif
+            // ! Out of range (underflow is accepted as JSON::parse does)
+            const std::string Terminated(Text);
+            Result = std::strtod(Terminated.c_str(), nullptr);
+            if(!std::isfinite(Result))
+                return false;
+            Value = Result;
+            return true;
+        }
+
+        // ! Number in JSON syntax, a non negative integer becomes unsigned and a
+        // ! negative one signed, integers that do not fit become floats
+        inline bool DecodeNumber(std::string_view Text, JSON &Value){
+            size_t Iterator = 0;
+            const bool Negative = !Text.empty() && Text[0] == '-';
+            if(Negative)
+                Iterator += 1;
+            if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                return false;
+            if(Text[Iterator] == '0')
+                Iterator += 1;
+            else
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            bool IsInteger = true;
+            if(Iterator < Text.size() && Text[Iterator] == '.'){
+                IsInteger = false;
+                Iterator += 1;
+                if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                    return false;
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            }
+            if(Iterator < Text.size() && (Text[Iterator] == 'e' || Text[Iterator] == 'E')){
+                IsInteger = false;
+                Iterator += 1;
+                if(Iterator < Text.size() && (Text[Iterator] == '+' || Text[Iterator] == '-'))
+                    Iterator += 1;
+                if(Iterator >= Text.size() || !IsDigit(Text[Iterator]))
+                    return false;
+                while(Iterator < Text.size() && IsDigit(Text[Iterator]))
+                    Iterator += 1;
+            }
+            if(Iterator != Text.size())
+                return false;
+
+            if(IsInteger){
+                const char* First = Text.data();
+                const char* Last = Text.data() + Text.size();
+                if(Negative){
+                    std::int64_t Result;
+                    if(std::from_chars(First, Last, Result).ec == std::errc()){
+                        Value = Result;
+                        return true;
+                    }
+                }else{
+                    std::uint64_t Result;
+                    if(std::from_chars(First, Last, Result).ec == std::errc()){
+                        Value = Result;
+                        return true;
+                    }
+                }
+            }
+            return DecodeFloat(Text, Value);
+        }
+
+        inline void AppendCodePoint(std::string &Output, std::uint32_t CodePoint){
+            if(CodePoint < 0x80)
+                Output += static_cast<char>(CodePoint);
+            else if(CodePoint < 0x800){
+                Output += static_cast<char>(0xC0 | (CodePoint >> 6));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }else if(CodePoint < 0x10000){
+                Output += static_cast<char>(0xE0 | (CodePoint >> 12));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }else{
+                Output += static_cast<char>(0xF0 | (CodePoint >> 18));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+                Output += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+                Output += static_cast<char>(0x80 | (CodePoint & 0x3F));
+            }
+        }
+
+        inline bool ReadHex(std::string_view Text, size_t Position, std::uint32_t &CodePoint){
+            if(Position + 4 > Text.size())
+                return false;
+            CodePoint = 0;
+            for(size_t Iterator = Position; Iterator < Position + 4; Iterator += 1){
+                const char Character = Text[Iterator];
+                CodePoint <<= 4;
+                if(IsDigit(Character))
+                    CodePoint |= Character - '0';
+                else if(Character >= 'a' && Character <= 'f')
+                    CodePoint |= Character - 'a' + 10;
+                else if(Character >= 'A' && Character <= 'F')
+                    CodePoint |= Character - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        }
+
+        // ! Double quoted string token with JSON escapes, the runs between escapes
+        // ! are copied at once
+        inline bool DecodeString(std::string_view Text, std::string &Output){
+            if(Text.size() < 2 || Text.front() != '"' || Text.back() != '"')
+                return false;
+            const size_t End = Text.size() - 1;
+            Output.clear();
+            Output.reserve(End - 1);
+            size_t Iterator = 1;
+            while(Iterator < End){
+                size_t RunEnd = Iterator;
+                while(RunEnd < End && Text[RunEnd] != '\\'){
+                    if(static_cast<unsigned char>(Text[RunEnd]) < 0x20)
+                        return false;
+                    RunEnd += 1;
+                }
+                Output.append(Text.data() + Iterator, RunEnd - Iterator);
+                if(RunEnd == End)
+                    return true;
+                // ! The lexer ends the token at the first quote that is not escaped
+                if(RunEnd + 1 >= End)
+                    return false;
+                Iterator = RunEnd + 2;
+                switch(Text[RunEnd + 1]){
+                    case '"': Output += '"'; break;
+                    case '\\': Output += '\\'; break;
+                    case '/': Output += '/'; break;
+                    case 'b': Output += '\b'; break;
+                    case 'f': Output += '\f'; break;
+                    case 'n': Output += '\n'; break;
+                    case 'r': Output += '\r'; break;
+                    case 't': Output += '\t'; break;
+                    case 'u': {
+                        std::uint32_t CodePoint;
+                        if(!ReadHex(Text.substr(0, End), Iterator, CodePoint))
+                            return false;
+                        Iterator += 4;
+                        if(CodePoint >= 0xDC00 && CodePoint <= 0xDFFF)
+                            return false;
+                        if(CodePoint >= 0xD800 && CodePoint <= 0xDBFF){
+                            std::uint32_t Low;
+                            if(Iterator + 2 > End || Text[Iterator] != '\\' || Text[Iterator + 1] != 'u' ||
+                                !ReadHex(Text.substr(0, End), Iterator + 2, Low) || Low < 0xDC00 || Low > 0xDFFF)
+                                return false;
+                            Iterator += 6;
+                            CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+                        }
+                        AppendCodePoint(Output, CodePoint);
+                    } break;
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // ! Builds an array or object literal from its tokens as the parser reads
+        // ! them, every call returns false when the token can not appear there
+        class Builder{
+            enum class Expect : std::uint8_t{
+                ValueOrClose,
+                Value,
+                KeyOrClose,
+                Key,
+                Colon,
+                CommaOrClose,
+            };
+
+            struct Level{
+                JSON Value;
+                std::string Key;
+                Expect ExpectInstance;
+            };
+
+            std::vector<Level> Levels;
+
+            bool ExpectsValue() const{
+                return Levels.empty() || Levels.back().ExpectInstance == Expect::ValueOrClose || Levels.back().ExpectInstance == Expect::Value;
+            }
+
+            public:
+                size_t Depth() const{
+                    return Levels.size();
+                }
+
+                void Clear(){
+                    Levels.clear();
+                }
+
+                bool Open(bool IsObject){
+                    if(!ExpectsValue())
+                        return false;
+                    Levels.push_back({IsObject ? JSON::object() : JSON::array(), std::string(), IsObject ? Expect::KeyOrClose : Expect::ValueOrClose});
+                    return true;
+                }
+
+                bool Add(JSON &&Value){
+                    if(Levels.empty())
+                        return false;
+                    Level &Current = Levels.back();
+                    switch(Current.ExpectInstance){
+                        case Expect::ValueOrClose:
+                        case Expect::Value: {
+                            if(Current.Value.is_array())
+                                Current.Value.push_back(std::move(Value));
+                            else
+                                Current.Value[Current.Key] = std::move(Value);
+                            Current.ExpectInstance = Expect::CommaOrClose;
+                        } return true;
+                        case Expect::KeyOrClose:
+                        case Expect::Key: {
+                            if(!Value.is_string())
+                                return false;
+                            Current.Key = std::move(Value.get_ref<std::string&>());
+                            Current.ExpectInstance = Expect::Colon;
+                        } return true;
+                        default:
+                            return false;
+                    }
+                }
+
+                bool Comma(){
+                    if(Levels.empty() || Levels.back().ExpectInstance != Expect::CommaOrClose)
+                        return false;
+                    Levels.back().ExpectInstance = Levels.back().Value.is_array() ? Expect::Value : Expect::Key;
+                    return true;
+                }
+
+                bool Colon(){
+                    if(Levels.empty() || Levels.back().ExpectInstance != Expect::Colon)
+                        return false;
+                    Levels.back().ExpectInstance = Expect::Value;
+                    return true;
+                }
+
+                // ! Closes the innermost literal, Result holds the whole literal once
+                // ! the outermost one is closed
+                bool Close(bool IsObject, JSON &Result){
+                    if(Levels.empty() || Levels.back().Value.is_object() != IsObject)
+                        return false;
+                    const Expect ExpectLocal = Levels.back().ExpectInstance;
+                    if(ExpectLocal != Expect::CommaOrClose && ExpectLocal != Expect::ValueOrClose && ExpectLocal != Expect::KeyOrClose)
+                        return false;
+                    JSON Value = std::move(Levels.back().Value);
+                    Levels.pop_back();
+                    if(Levels.empty()){
+                        Result = std::move(Value);
+                        return true;
+                    }
+                    return Add(std::move(Value));
+                }
+        };
+    }; // ! Literals namespace
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_LITERALS_HXX
+
+namespace Sydonia{
+    // ! Class for parsing a Sydonia Template
+    class Parser{
+        const ParserConfiguration &ParserConfigurationInstance;
+        Lexer LexerInstance;
+        // ! Templates this parse discovered, those of SharedTemplates are only read
+        TemplateStorage &TemplateStorageInstance;
+        const TemplateSnapshot* SharedTemplates;
+        const FunctionStorage &FunctionStorageInstance;
+        Token TokenInstance, PeekToken;
+        bool HavePeekToken {false};
+        size_t CurrentParenLevel {0};
+        Literals::Builder LiteralBuilder;
+        std::string_view LiteralStart;
+        NodeArena* Arena {nullptr};
+        BlockNode* CurrentBlock {nullptr};
+        ExpressionListNode* CurrentExpressionList {nullptr};
+        std::stack<std::pair<FunctionNode*, size_t>> FunctionStack;
+        std::vector<ExpressionNode*> Arguments;
+        std::stack<FunctionNode*> OperatorStack;
+        std::stack<IfStatementNode*> IfStatementStack;
+        std::stack<ForStatementNode*> ForStatementStack;
+        std::stack<BlockStatementNode*> BlockStatementStack;
+
+        // ! Root nodes of a previous parse that follow an edit, a reparse takes them
+        // ! over once it produces one of their text nodes at the shifted position
+        struct Splice{
+            std::vector<AstNode*> Nodes;
+            std::vector<std::pair<std::string, BlockStatementNode*>> Blocks;
+            size_t Next {0};
+            // ! First byte after the inserted text in the new content
+            size_t EditEnd {0};
+            std::ptrdiff_t Delta {0};
+        };
+        Splice* SpliceInstance {nullptr};
+
+        // ! Moves every node of a subtree by Delta bytes, the nodes are created
+        // ! mutable by the arena so dropping the visitor's const is fine
+        class PositionShifter : public NodeVisitor{
+            const std::ptrdiff_t Delta;
+
+            void Shift(const AstNode &Node){
+                const_cast<AstNode&>(Node).Position += Delta;
+            }
+
+            void Visit(const BlockNode &Node){
+                Shift(Node);
+                for(auto &SubNode : Node.Nodes)
+                    SubNode->Accept(*this);
+            }
+
+            void Visit(const TextNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ExpressionNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const LiteralNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const DataNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const FunctionNode &Node){
+                Shift(Node);
+                for(auto &SubNode : Node.Arguments)
+                    SubNode->Accept(*this);
+            }
+
+            void Visit(const ExpressionListNode &Node){
+                Shift(Node);
+                if(Node.Root)
+                    Node.Root->Accept(*this);
+            }
+
+            void Visit(const StatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ForStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ForArrayStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.Body.Accept(*this);
+            }
+
+            void Visit(const ForObjectStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.Body.Accept(*this);
+            }
+
+            void Visit(const IfStatementNode &Node){
+                Shift(Node);
+                Node.Condition.Accept(*this);
+                Node.TrueStatement.Accept(*this);
+                Node.FalseStatement.Accept(*this);
+            }
+
+            void Visit(const IncludeStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const ExtendsStatementNode &Node){
+                Shift(Node);
+            }
+
+            void Visit(const BlockStatementNode &Node){
+                Shift(Node);
+                Node.Block.Accept(*this);
+            }
+
+            void Visit(const SetStatementNode &Node){
+                Shift(Node);
+                Node.Expression.Accept(*this);
+            }
+
+            public:
+                explicit PositionShifter(std::ptrdiff_t DeltaLocal): Delta(DeltaLocal){}
+        };
+
+        inline void ThrowParserError(const std::string &Message) const{
+            SYDONIA_THROW(ParserError(Message, LexerInstance.CurrentPosition()));
+        }
+
+        inline void GetNextToken(){
+            if(HavePeekToken){
+                TokenInstance = PeekToken;
+                HavePeekToken = false;
+            }else
+                TokenInstance = LexerInstance.Scan();
+        }
+
+        inline void GetPeekToken(){
+            if(!HavePeekToken){
+                PeekToken = LexerInstance.Scan();
+                HavePeekToken = true;
+            }
+        }
+
+        template<typename NodeType, typename... Parameters>
+        inline NodeType* CreateNode(Parameters&&... ParametersLocal){
+            return Arena->Create<NodeType>(std::forward<Parameters>(ParametersLocal)...);
+        }
+
+        inline void AddLiteral(JSON &&Value, std::string_view Start, const char* ContentPointer){
+            Arguments.emplace_back(CreateNode<LiteralNode>(std::move(Value), Start.data() - ContentPointer));
+        }
+
+        // ! Value of a string, number or constant token, false for any other token
+        bool DecodeLiteral(JSON &Value){
+            switch(TokenInstance.KindInstance){
+                case Token::Kind::String: {
+                    std::string Text;
+                    if(!Literals::DecodeString(TokenInstance.Text, Text))
+                        ThrowParserError("Invalid string literal " + static_cast<std::string>(TokenInstance.Text));
+                    Value = std::move(Text);
+                } return true;
+                case Token::Kind::Number: {
+                    if(!Literals::DecodeNumber(TokenInstance.Text, Value))
+                        ThrowParserError("Invalid number literal '" + static_cast<std::string>(TokenInstance.Text) + "'");
+                } return true;
+                case Token::Kind::Id: {
+                    switch(TokenInstance.KeywordInstance){
+                        case Token::Keyword::True:
+                            Value = true;
+                            return true;
+                        case Token::Keyword::False:
+                            Value = false;
+                            return true;
+                        case Token::Keyword::Null:
+                            Value = nullptr;
+                            return true;
+                        default:
+                            return false;
+                    }
+                }
+                default:
+                    return false;
+            }
+        }
+
+        // ! Feeds a token inside an array or object literal to the builder, the
+        // ! literal is added once its outermost bracket is closed
+        void ParseLiteralToken(Template &TemplateLocal){
+            JSON Value;
+            bool Valid = true;
+            switch(TokenInstance.KindInstance){
+                case Token::Kind::LeftBracket:
+                case Token::Kind::LeftBrace:
+                    Valid = LiteralBuilder.Open(TokenInstance.KindInstance == Token::Kind::LeftBrace);
+                    break;
+                case Token::Kind::RightBracket:
+                case Token::Kind::RightBrace: {
+                    Valid = LiteralBuilder.Close(TokenInstance.KindInstance == Token::Kind::RightBrace, Value);
+                    if(Valid && LiteralBuilder.Depth() == 0)
+                        AddLiteral(std::move(Value), LiteralStart, TemplateLocal.Content.data());
+                } break;
+                case Token::Kind::Comma:
+                    Valid = LiteralBuilder.Comma();
+                    break;
+                case Token::Kind::Colon:
+                    Valid = LiteralBuilder.Colon();
+                    break;
+                default: {
+                    if(!DecodeLiteral(Value))
+                        ThrowParserError("Unexpected '" + TokenInstance.Describe() + "' in literal");
+                    Valid = LiteralBuilder.Add(std::move(Value));
+                } break;
+            }
+            if(!Valid)
+                ThrowParserError("Malformed literal");
+        }
+
+        inline void AddOperator(){
+            auto Function = OperatorStack.top();
+            OperatorStack.pop();
+            for(int Iterator = 0; Iterator < Function->NumberArgs; ++Iterator){
+                Function->Arguments.insert(Function->Arguments.begin(), Arguments.back());
+                Arguments.pop_back();
+            }
+            Arguments.emplace_back(Function);
+        }
+
+        std::shared_ptr<const TemplateSource> OpenFile(const std::string &Filename) const{
+            return ParserConfigurationInstance.MapTemplateFiles ? TemplateSource::Map(Filename) : TemplateSource::Read(Filename);
+        }
+
+        bool IsKnownTemplate(const std::string &TemplateName) const{
+            return TemplateLookup(TemplateStorageInstance, SharedTemplates).Find(TemplateName) != nullptr;
+        }
+
+        void AddToTemplateStorage(std::string_view Path, std::string &TemplateName){
+            if(IsKnownTemplate(TemplateName))
+                return;
+            std::string OriginalPath = static_cast<std::string>(Path);
+            std::string OriginalName = TemplateName;
+            if(ParserConfigurationInstance.SearchIncludedTemplatesInFiles){
+                // ! Build the relative path
+                TemplateName = OriginalPath + OriginalName;
+                if(TemplateName.compare(0, 2, "./") == 0)
+                    TemplateName.erase(0, 2);
+                if(!IsKnownTemplate(TemplateName)){
+                    // ! Load file
+                    if(auto Source = OpenFile(TemplateName)){
+                        auto IncludeTemplate = std::make_shared<Template>(std::move(Source));
+                        TemplateStorageInstance.emplace(TemplateName, IncludeTemplate);
+                        ParseIntoTemplate(*IncludeTemplate, TemplateName);
+                        return;
+                    }else if(!ParserConfigurationInstance.IncludeCallback)
+                        SYDONIA_THROW(FileError("Failed accessing file at '" + TemplateName + "'"));
+                }
+            }
+
+            // ! Try include callback
+            if(ParserConfigurationInstance.IncludeCallback){
+                auto IncludeTemplate = ParserConfigurationInstance.IncludeCallback(OriginalPath, OriginalName);
+                TemplateStorageInstance.emplace(TemplateName, std::make_shared<const Template>(std::move(IncludeTemplate)));
+            }
+        }
+
+        std::string ParseFilename(const Token &TokenLocal) const{
+            if(TokenLocal.KindInstance != Token::Kind::String)
+                ThrowParserError("Expected string, got '" + TokenLocal.Describe() + "'");
+            if(TokenLocal.Text.length() < 2)
+                ThrowParserError("Expected filename, got '" + static_cast<std::string>(TokenLocal.Text) + "'");
+            // ! Remove first and last character ""
+            return std::string {TokenLocal.Text.substr(1, TokenLocal.Text.length() - 2)};
+        }
+
+        bool ParseExpression(Template &TemplateLocal, Token::Kind Closing){
+            // ! Nesting left open by a malformed expression must not leak into this one
+            CurrentParenLevel = 0;
+            LiteralBuilder.Clear();
+            FunctionStack = {};
+            OperatorStack = {};
+            Arguments.clear();
+            while(TokenInstance.KindInstance != Closing && TokenInstance.KindInstance != Token::Kind::Eof){
+                if(LiteralBuilder.Depth() != 0){
+                    ParseLiteralToken(TemplateLocal);
+                    GetNextToken();
+                    continue;
+                }
+                // ! Literals
+                switch(TokenInstance.KindInstance){
+                    case Token::Kind::String:
+                    case Token::Kind::Number: {
+                        JSON Value;
+                        DecodeLiteral(Value);
+                        AddLiteral(std::move(Value), TokenInstance.Text, TemplateLocal.Content.data());
+                    } break;
+                    case Token::Kind::LeftBracket:
+                    case Token::Kind::LeftBrace: {
+                        LiteralStart = TokenInstance.Text;
+                        LiteralBuilder.Open(TokenInstance.KindInstance == Token::Kind::LeftBrace);
+                    } break;
+                    case Token::Kind::RightBracket: {
+                        ThrowParserError("Unexpected ']'");
+                    } break;
+                    case Token::Kind::RightBrace: {
+                        ThrowParserError("Unexpected '}'");
+                    } break;
+                    case Token::Kind::Id: {
+                        GetPeekToken();
+                        JSON Value;
+                        // ! Data literal
+                        if(DecodeLiteral(Value))
+                            AddLiteral(std::move(Value), TokenInstance.Text, TemplateLocal.Content.data());
+                        // ! Operator
+                        else if(TokenInstance.KeywordInstance == Token::Keyword::And || TokenInstance.KeywordInstance == Token::Keyword::Or ||
+                            TokenInstance.KeywordInstance == Token::Keyword::In || TokenInstance.KeywordInstance == Token::Keyword::Not)
+                            goto ParseOperator;
+                        // ! Functions
+                        else if(PeekToken.KindInstance == Token::Kind::LeftParen){
+                            OperatorStack.emplace(CreateNode<FunctionNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                            FunctionStack.emplace(OperatorStack.top(), CurrentParenLevel);
+                        // ! Variables
+                        }else{
+                            auto Data = CreateNode<DataNode>(static_cast<std::string>(TokenInstance.Text), TokenInstance.Text.data() - TemplateLocal.Content.data());
+                            // ! Bound now so a missing variable is not looked up on every render
+                            const auto &FunctionData = FunctionStorageInstance.FindFunction(TokenInstance.Text, 0);
+                            if(FunctionData.OperationInstance == FunctionStorage::Operation::Callback)
+                                Data->Callback = FunctionData.Callback;
+                            Arguments.emplace_back(Data);
+                        }
+                    // ! Operators
+                    } break;
+                    case Token::Kind::Equal:
+                    case Token::Kind::NotEqual:
+                    case Token::Kind::GreaterThan:
+                    case Token::Kind::GreaterEqual:
+                    case Token::Kind::LessThan:
+                    case Token::Kind::LessEqual:
+                    case Token::Kind::Plus:
+                    case Token::Kind::Minus:
+                    case Token::Kind::Times:
+                    case Token::Kind::Slash:
+                    case Token::Kind::Power:
+                    case Token::Kind::Percent:
+                    case Token::Kind::Dot: {
+                        ParseOperator:
+                            FunctionStorage::Operation OperationInstance;
+                            switch(TokenInstance.KindInstance){
+                                case Token::Kind::Id: {
+                                    switch(TokenInstance.KeywordInstance){
+                                        case Token::Keyword::And:
+                                            OperationInstance = FunctionStorage::Operation::And;
+                                            break;
+                                        case Token::Keyword::Or:
+                                            OperationInstance = FunctionStorage::Operation::Or;
+                                            break;
+                                        case Token::Keyword::In:
+                                            OperationInstance = FunctionStorage::Operation::In;
+                                            break;
+                                        case Token::Keyword::Not:
+                                            OperationInstance = FunctionStorage::Operation::Not;
+                                            break;
+                                        default:
+                                            ThrowParserError("Unknown operator in parser.");
+                                    }
+                                } break;
+                                case Token::Kind::Equal: {
+                                    OperationInstance = FunctionStorage::Operation::Equal;
+                                } break;
+                                case Token::Kind::NotEqual: {
+                                    OperationInstance = FunctionStorage::Operation::NotEqual;
+                                } break;
+                                case Token::Kind::GreaterThan: {
+                                    OperationInstance = FunctionStorage::Operation::Greater;
+                                } break;
+                                case Token::Kind::GreaterEqual: {
+                                    OperationInstance = FunctionStorage::Operation::GreaterEqual;
+                                } break;
+                                case Token::Kind::LessThan: {
+                                    OperationInstance = FunctionStorage::Operation::Less;
+                                } break;
+                                case Token::Kind::LessEqual: {
+                                    OperationInstance = FunctionStorage::Operation::LessEqual;
+                                } break;
+                                case Token::Kind::Plus: {
+                                    OperationInstance = FunctionStorage::Operation::Add;
+                                } break;
+                                case Token::Kind::Minus: {
+                                    OperationInstance = FunctionStorage::Operation::Subtract;
+                                } break;
                                 case Token::Kind::Times: {
                                     OperationInstance = FunctionStorage::Operation::Multiplication;
                                 } break;
@@ -1651,7 +5606,7 @@ namespace Sydonia{
                                     ThrowParserError("Unknown operator in parser.");
                                 }
                             }
-                            auto FunctionNodeInstance = std::make_shared<FunctionNode>(OperationInstance, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
+                            auto FunctionNodeInstance = CreateNode<FunctionNode>(OperationInstance, TokenInstance.Text.data() - TemplateLocal.Content.data());
                             while(!OperatorStack.empty() &&
                                 ((OperatorStack.top()->Precedence > FunctionNodeInstance->Precedence) ||
                                 (OperatorStack.top()->Precedence == FunctionNodeInstance->Precedence && FunctionNodeInstance->AssociativityInstance == FunctionNode::Associativity::Left)) && 
@@ -1661,19 +5616,16 @@ namespace Sydonia{
                             OperatorStack.emplace(FunctionNodeInstance);
                     } break;
                     case Token::Kind::Comma: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0){
-                            if(FunctionStack.empty())
-                                ThrowParserError("Unexpected ','");
-                            FunctionStack.top().first->NumberArgs += 1;
-                        }
+                        if(FunctionStack.empty())
+                            ThrowParserError("Unexpected ','");
+                        FunctionStack.top().first->NumberArgs += 1;
                     } break;
                     case Token::Kind::Colon: {
-                        if(CurrentBraceLevel == 0 && CurrentBracketLevel == 0)
-                            ThrowParserError("Unexpected ':'");
+                        ThrowParserError("Unexpected ':'");
                     } break;
                     case Token::Kind::LeftParen: {
                         CurrentParenLevel += 1;
-                        OperatorStack.emplace(std::make_shared<FunctionNode>(FunctionStorage::Operation::ParenLeft, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
+                        OperatorStack.emplace(CreateNode<FunctionNode>(FunctionStorage::Operation::ParenLeft, TokenInstance.Text.data() - TemplateLocal.Content.data()));
                         GetPeekToken();
                         if(PeekToken.KindInstance == Token::Kind::RightParen)
                             if(!FunctionStack.empty() && FunctionStack.top().second == CurrentParenLevel - 1)
@@ -1687,7 +5639,7 @@ namespace Sydonia{
                             OperatorStack.pop();
                         if(!FunctionStack.empty() && FunctionStack.top().second == CurrentParenLevel){
                             auto Function = FunctionStack.top().first;
-                            auto FunctionData = FunctionStorageInstance.FindFunction(Function->Name, Function->NumberArgs);
+                            const auto &FunctionData = FunctionStorageInstance.FindFunction(Function->Name, Function->NumberArgs);
                             if(FunctionData.OperationInstance == FunctionStorage::Operation::None)
                                 ThrowParserError("Unknown function " + Function->Name);
                             Function->OperationInstance = FunctionData.OperationInstance;
@@ -1700,808 +5652,691 @@ namespace Sydonia{
                         }
                     }
                     default:
-                        break;
-                }
-                GetNextToken();
-            }
-            while(!OperatorStack.empty())
-                AddOperator();
-            if(Arguments.size() == 1){
-                CurrentExpressionList->Root = Arguments[0];
-                Arguments = {};
-            }else if(Arguments.size() > 1)
-                ThrowParserError("Malformed expression");
-            return true;
-        }
-
-        bool ParseStatement(Template &TemplateLocal, Token::Kind Closing, std::string_view Path){
-            if(TokenInstance.KindInstance != Token::Kind::Id)
-                return false;
-            if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("If")){
-                GetNextToken();
-                auto IfStatementNodeInstance = std::make_shared<IfStatementNode>(CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
-                IfStatementStack.emplace(IfStatementNodeInstance.get());
-                CurrentBlock = &IfStatementNodeInstance->TrueStatement;
-                CurrentExpressionList = &IfStatementNodeInstance->Condition;
-                if(!ParseExpression(TemplateLocal, Closing))
-                    return false;
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Else")){
-                if(IfStatementStack.empty())
-                    ThrowParserError("Else without matching If");
-                auto &IfStatementData = IfStatementStack.top();
-                GetNextToken();
-                IfStatementData->HasFalseStatement = true;
-                CurrentBlock = &IfStatementData->FalseStatement;
-                // ! Chained Else If
-                if(TokenInstance.KindInstance == Token::Kind::Id && TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("If")){
-                    GetNextToken();
-                    auto IfStatementNodeInstance = std::make_shared<IfStatementNode>(true, CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                    CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
-                    IfStatementStack.emplace(IfStatementNodeInstance.get());
-                    CurrentBlock = &IfStatementNodeInstance->TrueStatement;
-                    CurrentExpressionList = &IfStatementNodeInstance->Condition;
-                    if(!ParseExpression(TemplateLocal, Closing))
-                        return false;
-                }
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndIf")){
-                if(IfStatementStack.empty())
-                    ThrowParserError("EndIf without matching If");
-                // ! Nested if statements
-                while(IfStatementStack.top()->IsNested)
-                    IfStatementStack.pop();
-                auto &IfStatementData = IfStatementStack.top();
-                GetNextToken();
-                CurrentBlock = IfStatementData->Parent;
-                IfStatementStack.pop();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Block")){
-                GetNextToken();
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected block name, got '" + TokenInstance.Describe() + "'");
-                const std::string BlockName = static_cast<std::string>(TokenInstance.Text);
-                auto BlockStatementNodeInstance = std::make_shared<BlockStatementNode>(CurrentBlock, BlockName, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(BlockStatementNodeInstance);
-                BlockStatementStack.emplace(BlockStatementNodeInstance.get());
-                CurrentBlock = &BlockStatementNodeInstance->Block;
-                auto Success = TemplateLocal.BlockStorage.emplace(BlockName, BlockStatementNodeInstance);
-                if(!Success.second)
-                    ThrowParserError("Block with the name '" + BlockName + "' does already exists");
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndBlock")){
-                if(BlockStatementStack.empty())
-                    ThrowParserError("EndBlock without matching block");
-                auto &BlockStatementData = BlockStatementStack.top();
-                GetNextToken();
-                CurrentBlock = BlockStatementData->Parent;
-                BlockStatementStack.top();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("For")){
-                GetNextToken();
-                // ! Options: For X, Y In Obj
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
-                Token ValueToken = TokenInstance;
-                GetNextToken();
-                // ! Object type
-                std::shared_ptr<ForStatementNode> ForStatementNodeInstance;
-                if(TokenInstance.KindInstance == Token::Kind::Comma){
-                    GetNextToken();
-                    if(TokenInstance.KindInstance != Token::Kind::Id)
-                        ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
-                    Token KeyToken = std::move(ValueToken);
-                    ValueToken = TokenInstance;
-                    GetNextToken();
-                    ForStatementNodeInstance = std::make_shared<ForObjectStatementNode>(static_cast<std::string>(KeyToken.Text), static_cast<std::string>(ValueToken.Text),
-                                                                                        CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                    // ! Array type
-                }else{
-                    ForStatementNodeInstance = std::make_shared<ForArrayStatementNode>(static_cast<std::string>(ValueToken.Text), CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                    CurrentBlock->Nodes.emplace_back(ForStatementNodeInstance);
-                    ForStatementStack.emplace(ForStatementNodeInstance.get());
-                    CurrentBlock = &ForStatementNodeInstance->Body;
-                    CurrentExpressionList = &ForStatementNodeInstance->Condition;
-                    if(TokenInstance.KindInstance != Token::Kind::Id || TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("In"))
-                        ThrowParserError("Expected 'In', got '" + TokenInstance.Describe() + "'");
-                    GetNextToken();
-                    if(!ParseExpression(TemplateLocal, Closing))
-                        return false;
-                }
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("EndFor")){
-                if(ForStatementStack.empty())
-                    ThrowParserError("EndFor without matching For");
-                auto &ForStatementData = ForStatementStack.top();
-                GetNextToken();
-                CurrentBlock = ForStatementData->Parent;
-                ForStatementStack.pop();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Include")){
-                GetNextToken();
-                std::string TemplateName = ParseFilename(TokenInstance);
-                AddToTemplateStorage(Path, TemplateName);
-                CurrentBlock->Nodes.emplace_back(std::make_shared<IncludeStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Extends")){
-                GetNextToken();
-                std::string TemplateName = ParseFilename(TokenInstance);
-                AddToTemplateStorage(Path, TemplateName);
-                CurrentBlock->Nodes.emplace_back(std::make_shared<ExtendsStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.c_str()));
-                GetNextToken();
-            }else if(TokenInstance.Text == static_cast<decltype(TokenInstance.Text)>("Set")){
-                GetNextToken();
-                if(TokenInstance.KindInstance != Token::Kind::Id)
-                    ThrowParserError("Expected variable name, got '" + TokenInstance.Describe() + "'");
-                std::string Key = static_cast<std::string>(TokenInstance.Text);
-                GetNextToken();
-                auto SetStatementNodeInstance = std::make_shared<SetStatementNode>(Key, TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                CurrentBlock->Nodes.emplace_back(SetStatementNodeInstance);
-                CurrentExpressionList = &SetStatementNodeInstance->Expression;
-                if(TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("="))
-                    ThrowParserError("Expected '=', got '" + TokenInstance.Describe() + "'");
-                GetNextToken();
-                if(!ParseExpression(TemplateLocal, Closing))
-                    return false;
-            }else
-                return false;
-            return true;
-        }
-
-        void ParseInto(Template &TemplateLocal, std::string_view Path){
-            LexerInstance.Start(TemplateLocal.Content);
-            CurrentBlock = &TemplateLocal.Root;
-            for(;;){
-                GetNextToken();
-                switch(TokenInstance.KindInstance){
-                    case Token::Kind::Eof: {
-                        if(!IfStatementStack.empty())
-                            ThrowParserError("Unmatched If");
-                        if(!ForStatementStack.empty())
-                            ThrowParserError("Unmatched For");
-                    } return;
-                    case Token::Kind::Text: {
-                        CurrentBlock->Nodes.emplace_back(std::make_shared<TextNode>(TokenInstance.Text.data() - TemplateLocal.Content.c_str(), TokenInstance.Text.size()));
-                    } break;
-                    case Token::Kind::StatementOpen: {
-                        GetNextToken();
-                        if(!ParseStatement(TemplateLocal, Token::Kind::StatementClose, Path))
-                            ThrowParserError("Expected statement, got '" + TokenInstance.Describe() + "'");
-                        if(TokenInstance.KindInstance != Token::Kind::StatementClose)
-                            ThrowParserError("Expected statement close, got '" + TokenInstance.Describe() + "'");
-                    } break;
-                    case Token::Kind::LineStatementOpen: {
-                        GetNextToken();
-                        if(!ParseStatement(TemplateLocal, Token::Kind::LineStatementClose, Path))
-                            ThrowParserError("Expected statement, got '" + TokenInstance.Describe() + "'");
-                        if(TokenInstance.KindInstance != Token::Kind::LineStatementClose && TokenInstance.KindInstance != Token::Kind::Eof)
-                            ThrowParserError("Expected line statement close, got '" + TokenInstance.Describe() + "'");
-                    } break;
-                    case Token::Kind::ExpressionOpen: {
-                        GetNextToken();
-                        auto ExpressionListNodeInstance = std::make_shared<ExpressionListNode>(TokenInstance.Text.data() - TemplateLocal.Content.c_str());
-                        CurrentBlock->Nodes.emplace_back(ExpressionListNodeInstance);
-                        CurrentExpressionList = ExpressionListNodeInstance.get();
-                        if(!ParseExpression(TemplateLocal, Token::Kind::ExpressionClose))
-                            ThrowParserError("Expected expression, got '" + TokenInstance.Describe() + "'");
-                        if(TokenInstance.KindInstance != Token::Kind::ExpressionClose)
-                            ThrowParserError("Expected expression close, got '" + TokenInstance.Describe() + "'");
-                    } break;
-                    case Token::Kind::CommentOpen: {
-                        GetNextToken();
-                        if(TokenInstance.KindInstance != Token::Kind::CommentClose)
-                            ThrowParserError("Expected comment close, got '" + TokenInstance.Describe() + "'");
-                    } break;
-                    default: {
-                        ThrowParserError("Unexpected token '" + TokenInstance.Describe() + "'");
-                    } break;
-                }
-            }
-        }
-        
-        public:
-            explicit Parser(const ParserConfiguration &ParserConfigurationLocal, const LexerConfiguration &LexerConfigurationLocal,
-                            TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
-                : ParserConfigurationInstance(ParserConfigurationLocal), LexerInstance(LexerConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal){}
-            
-            Template Parse(std::string_view Input, std::string_view Path){
-                auto Result = Template(static_cast<std::string>(Input));
-                ParseInto(Result, Path);
-                return Result;
-            }
-
-            Template Parse(std::string_view Input){
-                return Parse(Input, "./");
-            }
-
-            void ParseIntoTemplate(Template &TemplateLocal, std::string_view Filename){
-                std::string_view Path = Filename.substr(0, Filename.find_last_of("/\\") + 1);
-                auto SubParser = Parser(ParserConfigurationInstance, LexerInstance.GetConfiguration(), 
-                                        TemplateStorageInstance, FunctionStorageInstance);
-                SubParser.ParseInto(TemplateLocal, Path);
-            }
-
-            std::string LoadFile(const std::string &Filename){
-                std::ifstream File;
-                File.open(Filename);
-                if(File.fail())
-                    SYDONIA_THROW(FileError("Failed accessing file at '" + Filename + "'"));
-                std::string Text((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
-                return Text;
-            }
-    };
-}; // ! Sydonia namespace
-
-#endif // ! SYDONIA_PARSER_HXX
-/***
- * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
- * Licensed under the MIT license. See LICENSE file in the project root 
- * for full license information.
- *
- * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
- *
- * For related information - https://github.com/CodeWithRodi/Sydonia/
- *
- * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
- ****/
-
-#ifndef SYDONIA_RENDERER_HXX
-#define SYDONIA_RENDERER_HXX
-
-#include <algorithm>
-#include <numeric>
-#include <string>
-#include <utility>
-#include <vector>
-
-namespace Sydonia{
-    // ! Class for rendering a template with data
-    class Renderer : public NodeVisitor{
-        using Operation = FunctionStorage::Operation;
-
-        const RenderConfiguration RenderConfigurationInstance;
-        const TemplateStorage &TemplateStorageInstance;
-        const FunctionStorage &FunctionStorageInstance;
-        
-        const Template* CurrentTemplate;
-        size_t CurrentLevel {0};
-        std::vector<const Template*> TemplateStack;
-        std::vector<const BlockStatementNode*> BlockStatementStack;
-        
-        const JSON* DataInput;
-        std::ostream* OutputStream;
-
-        JSON AdditionalData;
-        JSON* CurrentLoopData = &AdditionalData["Loop"];
-
-        std::vector<std::shared_ptr<JSON>> DataTempStack;
-        std::stack<const JSON*> DataEvalStack;
-        std::stack<const DataNode*> NotFoundStack;
-
-        bool BreakRendering {false};
-
-        static bool Truthy(const JSON* Data){
-            if(Data->is_boolean())
-                return Data->get<bool>();
-            else if(Data->is_number())
-                return (*Data != 0);
-            else if(Data->is_null())
-                return false;
-            return !Data->empty();
-        }
-
-        void PrintData(const std::shared_ptr<JSON> Value){
-            if(Value->is_string())
-                *OutputStream << Value->get_ref<const JSON::string_t&>();
-            else if(Value->is_number_integer())
-                *OutputStream << Value->get<const JSON::number_integer_t>();
-            else if(Value->is_null()){}
-            else
-                *OutputStream << Value->dump();
-        }
-
-        const std::shared_ptr<JSON> EvalExpressionList(const ExpressionListNode &ExpressionList){
-            if(!ExpressionList.Root)
-                ThrowRendererError("Empty expression", ExpressionList);
-            ExpressionList.Root->Accept(*this);
-            if(DataEvalStack.empty())
-                ThrowRendererError("Empty expression", ExpressionList);
-            else if(DataEvalStack.size() != 1)
-                ThrowRendererError("Malformed expression", ExpressionList);
-            const auto Result = DataEvalStack.top();
-            DataEvalStack.pop();
-            if(!Result){
-                if(NotFoundStack.empty())
-                    ThrowRendererError("Expression could not be evaluated", ExpressionList);
-                auto Node = NotFoundStack.top();
-                NotFoundStack.pop();
-                ThrowRendererError("Variable '" + static_cast<std::string>(Node->Name) + "' not found", *Node);
-            }
-            return std::make_shared<JSON>(*Result);
-        }
-
-        void ThrowRendererError(const std::string &Message, const AstNode &Node){
-            SourceLocation Location = GetSourceLocation(CurrentTemplate->Content, Node.Position);
-            SYDONIA_THROW(RenderError(Message, Location));
-        }
-
-        void MakeResult(const JSON &&Result){
-            auto ResultPointer = std::make_shared<JSON>(Result);
-            DataTempStack.push_back(ResultPointer);
-            DataEvalStack.push(ResultPointer.get());
-        }
-
-        template <size_t N, size_t NStart = 0, bool ThrowNotFound = true> std::array<const JSON*, N> GetArguments(const FunctionNode &Node){
-            if(Node.Arguments.size() < NStart + N)
-                ThrowRendererError("Function needs " + std::to_string(NStart + N) + " variables, but has only found " + std::to_string(Node.Arguments.size()), Node);
-            for(size_t Iterator = NStart; Iterator < NStart + N; Iterator += 1)
-                Node.Arguments[Iterator]->Accept(*this);
-            if(DataEvalStack.size() < N)
-                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
-            std::array<const JSON*, N> Result;
-            for(size_t Iterator = 0; Iterator < N; Iterator += 1){
-                Result[N - Iterator - 1] = DataEvalStack.top();
-                DataEvalStack.pop();
-                if(!Result[N - Iterator - 1]){
-                    const auto DataNode = NotFoundStack.top();
-                    NotFoundStack.pop();
-                    if(ThrowNotFound)
-                        ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
-                }
-            }
-            return Result;
-        }
-
-        template <bool ThrowNotFound = true> Arguments GetArgumentVector(const FunctionNode &Node){
-            const size_t N = Node.Arguments.size();
-            for(auto Arg : Node.Arguments)
-                Arg->Accept(*this);
-            if(DataEvalStack.size() < N)
-                ThrowRendererError("Function needs " + std::to_string(N) + " variables, but has only found " + std::to_string(DataEvalStack.size()), Node);
-            Arguments Result {N};
-            for(size_t Iterator = 0; Iterator < N; Iterator += 1){
-                Result[N - Iterator - 1] = DataEvalStack.top();
-                DataEvalStack.pop();
-                if(!Result[N - Iterator - 1]){
-                    const auto DataNode = NotFoundStack.top();
-                    NotFoundStack.pop();
-                    if(ThrowNotFound)
-                        ThrowRendererError("Variable '" + static_cast<std::string>(DataNode->Name) + "' not found", *DataNode);
-                }
-            }
-            return Result;
-        }
-
-        void Visit(const BlockNode &Node){
-            for(auto &SubNode : Node.Nodes){
-                SubNode->Accept(*this);
-                if(BreakRendering)
-                    break;
+                        break;
+                }
+                GetNextToken();
             }
+            if(LiteralBuilder.Depth() != 0)
+                ThrowParserError("Unclosed literal");
+            while(!OperatorStack.empty())
+                AddOperator();
+            if(Arguments.size() == 1){
+                CurrentExpressionList->Root = Arguments[0];
+                Arguments = {};
+            }else if(Arguments.size() > 1)
+                ThrowParserError("Malformed expression");
+            return true;
         }
 
-        void Visit(const TextNode &Node){
-            OutputStream->write(CurrentTemplate->Content.c_str() + Node.Position, Node.Length);
-        }
-
-        void Visit(const ExpressionNode &){}
-
-        void Visit(const LiteralNode &Node){
-            DataEvalStack.push(&Node.Value);
-        }
-
-        void Visit(const DataNode &Node){
-            if(AdditionalData.contains(Node.Pointer))
-                DataEvalStack.push(&(AdditionalData[Node.Pointer]));
-            else if(DataInput->contains(Node.Pointer))
-                DataEvalStack.push(&(*DataInput)[Node.Pointer]);
-            else{
-                // ! Try to evaluate as a no argument callback
-                const auto FunctionData = FunctionStorageInstance.FindFunction(Node.Name, 0);
-                if(FunctionData.OperationInstance == FunctionStorage::Operation::Callback){
-                    Arguments EmptyArgs {};
-                    const auto Value = std::make_shared<JSON>(FunctionData.Callback(EmptyArgs));
-                    DataTempStack.push_back(Value);
-                    DataEvalStack.push(Value.get());
-                }else{
-                    DataEvalStack.push(nullptr);
-                    NotFoundStack.emplace(&Node);
-                }
-            }
+        // ! Whether the current block is a branch of an If, closing statements have
+        // ! to match the innermost open one so the root block is only reached once
+        // ! every statement is closed
+        bool IsBranchOf(const IfStatementNode* IfStatementNodeInstance) const{
+            return CurrentBlock == &IfStatementNodeInstance->TrueStatement || CurrentBlock == &IfStatementNodeInstance->FalseStatement;
         }
 
-        void Visit(const FunctionNode &Node){
-            switch(Node.OperationInstance){
-                case Operation::Not: {
-                    const auto Arguments = GetArguments<1>(Node);
-                    MakeResult(!Truthy(Arguments[0]));
-                } break;
-                case Operation::And: {
-                    MakeResult(Truthy(GetArguments<1, 0>(Node)[0]) && Truthy(GetArguments<1, 1>(Node)[0]));
-                } break;
-                case Operation::Or: {
-                    MakeResult(Truthy(GetArguments<1, 0>(Node)[0]) || Truthy(GetArguments<1, 1>(Node)[0]));
-                } break;
-                case Operation::In: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(std::find(Arguments[1]->begin(), Arguments[1]->end(), *Arguments[0]) != Arguments[1]->end());
-                } break;
-                case Operation::Equal: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] == *Arguments[1]);
-                } break;
-                case Operation::NotEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] != *Arguments[1]);
-                } break;
-                case Operation::Greater: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] > *Arguments[1]);
-                } break;
-                case Operation::GreaterEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] >= *Arguments[1]);
-                } break;
-                case Operation::Less: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] < *Arguments[1]);
-                } break;
-                case Operation::LessEqual: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(*Arguments[0] <= *Arguments[1]);
+        bool ParseStatement(Template &TemplateLocal, Token::Kind Closing, std::string_view Path){
+            if(TokenInstance.KindInstance != Token::Kind::Id)
+                return false;
+            switch(TokenInstance.KeywordInstance){
+                case Token::Keyword::If: {
+                    GetNextToken();
+                    auto IfStatementNodeInstance = CreateNode<IfStatementNode>(CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                    CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
+                    IfStatementStack.emplace(IfStatementNodeInstance);
+                    CurrentBlock = &IfStatementNodeInstance->TrueStatement;
+                    CurrentExpressionList = &IfStatementNodeInstance->Condition;
+                    if(!ParseExpression(TemplateLocal, Closing))
+                        return false;
                 } break;
-                case Operation::Add: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_string() && Arguments[1]->is_string())
-                        MakeResult(Arguments[0]->get_ref<const std::string&>() + Arguments[1]->get_ref<const std::string&>());
-                    else if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() + Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() + Arguments[1]->get<double>());
+                case Token::Keyword::Else: {
+                    if(IfStatementStack.empty() || !IsBranchOf(IfStatementStack.top()))
+                        ThrowParserError("Else without matching If");
+                    auto &IfStatementData = IfStatementStack.top();
+                    GetNextToken();
+                    IfStatementData->HasFalseStatement = true;
+                    CurrentBlock = &IfStatementData->FalseStatement;
+                    // ! Chained Else If
+                    if(TokenInstance.Is(Token::Keyword::If)){
+                        GetNextToken();
+                        auto IfStatementNodeInstance = CreateNode<IfStatementNode>(true, CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        CurrentBlock->Nodes.emplace_back(IfStatementNodeInstance);
+                        IfStatementStack.emplace(IfStatementNodeInstance);
+                        CurrentBlock = &IfStatementNodeInstance->TrueStatement;
+                        CurrentExpressionList = &IfStatementNodeInstance->Condition;
+                        if(!ParseExpression(TemplateLocal, Closing))
+                            return false;
+                    }
                 } break;
-                case Operation::Subtract: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() - Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() - Arguments[1]->get<double>());
+                case Token::Keyword::EndIf: {
+                    if(IfStatementStack.empty() || !IsBranchOf(IfStatementStack.top()))
+                        ThrowParserError("EndIf without matching If");
+                    // ! Nested if statements
+                    while(IfStatementStack.top()->IsNested)
+                        IfStatementStack.pop();
+                    auto &IfStatementData = IfStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = IfStatementData->Parent;
+                    IfStatementStack.pop();
                 } break;
-                case Operation::Multiplication: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->is_number_integer())
-                        MakeResult(Arguments[0]->get<int>() * Arguments[1]->get<int>());
-                    else
-                        MakeResult(Arguments[0]->get<double>() * Arguments[1]->get<double>());
+                case Token::Keyword::Block: {
+                    GetNextToken();
+                    if(TokenInstance.KindInstance != Token::Kind::Id)
+                        ThrowParserError("Expected block name, got '" + TokenInstance.Describe() + "'");
+                    const std::string BlockName = static_cast<std::string>(TokenInstance.Text);
+                    auto BlockStatementNodeInstance = CreateNode<BlockStatementNode>(CurrentBlock, BlockName, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                    CurrentBlock->Nodes.emplace_back(BlockStatementNodeInstance);
+                    BlockStatementStack.emplace(BlockStatementNodeInstance);
+                    CurrentBlock = &BlockStatementNodeInstance->Block;
+                    auto Success = TemplateLocal.BlockStorage.emplace(BlockName, BlockStatementNodeInstance);
+                    if(!Success.second)
+                        ThrowParserError("Block with the name '" + BlockName + "' does already exists");
+                    GetNextToken();
                 } break;
-                case Operation::Division: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[1]->get<double>() == 0)
-                        ThrowRendererError("Division by zero", Node);
-                    MakeResult(Arguments[0]->get<double>() / Arguments[1]->get<double>());
+                case Token::Keyword::EndBlock: {
+                    if(BlockStatementStack.empty() || CurrentBlock != &BlockStatementStack.top()->Block)
+                        ThrowParserError("EndBlock without matching block");
+                    auto &BlockStatementData = BlockStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = BlockStatementData->Parent;
+                    BlockStatementStack.pop();
                 } break;
-                case Operation::Power: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_number_integer() && Arguments[1]->get<int>() >= 0){
-                        int Result = static_cast<int>(std::pow(Arguments[0]->get<int>(), Arguments[1]->get<int>()));
-                        MakeResult(Result);
+                case Token::Keyword::For: {
+                    GetNextToken();
+                    // ! Options: For X, Y In Obj
+                    if(TokenInstance.KindInstance != Token::Kind::Id)
+                        ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
+                    Token ValueToken = TokenInstance;
+                    GetNextToken();
+                    // ! Object type
+                    ForStatementNode* ForStatementNodeInstance;
+                    if(TokenInstance.KindInstance == Token::Kind::Comma){
+                        GetNextToken();
+                        if(TokenInstance.KindInstance != Token::Kind::Id)
+                            ThrowParserError("Expected id, got '" + TokenInstance.Describe() + "'");
+                        Token KeyToken = std::move(ValueToken);
+                        ValueToken = TokenInstance;
+                        GetNextToken();
+                        ForStatementNodeInstance = CreateNode<ForObjectStatementNode>(static_cast<std::string>(KeyToken.Text), static_cast<std::string>(ValueToken.Text),
+                                                                                            CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        // ! Array type
                     }else{
-                        double Result = std::pow(Arguments[0]->get<double>(), Arguments[1]->get<int>());
-                        MakeResult(Result);
+                        ForStatementNodeInstance = CreateNode<ForArrayStatementNode>(static_cast<std::string>(ValueToken.Text), CurrentBlock, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        CurrentBlock->Nodes.emplace_back(ForStatementNodeInstance);
+                        ForStatementStack.emplace(ForStatementNodeInstance);
+                        CurrentBlock = &ForStatementNodeInstance->Body;
+                        CurrentExpressionList = &ForStatementNodeInstance->Condition;
+                        if(!TokenInstance.Is(Token::Keyword::In))
+                            ThrowParserError("Expected 'In', got '" + TokenInstance.Describe() + "'");
+                        GetNextToken();
+                        if(!ParseExpression(TemplateLocal, Closing))
+                            return false;
                     }
                 } break;
-                case Operation::Modulo: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    MakeResult(Arguments[0]->get<int>() % Arguments[1]->get<int>());
-                } break;
-                case Operation::AtId: {
-                    const auto Container = GetArguments<1, 0, false>(Node)[0];
-                    Node.Arguments[1]->Accept(*this);
-                    if(NotFoundStack.empty())
-                        ThrowRendererError("COuld not find element with given name", Node);
-                    const auto NodeID = NotFoundStack.top();
-                    NotFoundStack.pop();
-                    DataEvalStack.pop();
-                    DataEvalStack.push(&Container->at(NodeID->Name));
-                } break;
-                case Operation::At: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    if(Arguments[0]->is_object())
-                        DataEvalStack.push(&Arguments[0]->at(Arguments[1]->get<std::string>()));
-                    else
-                        DataEvalStack.push(&Arguments[0]->at(Arguments[1]->get<int>()));
-                } break;
-                case Operation::Default: {
-                    const auto TestArguments = GetArguments<1, 0, false>(Node)[0];
-                    DataEvalStack.push(TestArguments ? TestArguments : GetArguments<1, 1>(Node)[0]);
-                } break;
-                case Operation::DivisibleBy: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    const int Divisor = Arguments[1]->get<int>();
-                    MakeResult((Divisor != 0) && (Arguments[0]->get<int>() % Divisor == 0));
-                } break;
-                case Operation::Even: {
-                    MakeResult(GetArguments<1>(Node)[0]->get<int>() % 2 == 0);
-                } break;
-                case Operation::Exists: {
-                    auto &&Name = GetArguments<1>(Node)[0]->get_ref<const std::string&>();
-                    MakeResult(DataInput->contains(JSON::json_pointer(DataNode::ConvertDotToPointer(Name))));
-                } break;
-                case Operation::ExistsInObject: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    auto &&Name = Arguments[1]->get_ref<const std::string&>();
-                    MakeResult(Arguments[0]->find(Name) != Arguments[0]->end());
-                } break;
-                case Operation::First: {
-                    const auto Result = &GetArguments<1>(Node)[0]->front();
-                    DataEvalStack.push(Result);
-                } break;
-                case Operation::Float: {
-                    MakeResult(std::stod(GetArguments<1>(Node)[0]->get_ref<const std::string&>()));
-                } break;
-                case Operation::Int: {
-                    MakeResult(std::stoi(GetArguments<1>(Node)[0]->get_ref<const std::string&>()));
-                } break;
-                case Operation::Last: {
-                    const auto Result = &GetArguments<1>(Node)[0]->back();
-                    DataEvalStack.push(Result);
-                } break;
-                case Operation::Length: {
-                    const auto Value = GetArguments<1>(Node)[0];
-                    if(Value->is_string())
-                        MakeResult(Value->get_ref<const std::string&>().length());
-                    else
-                        MakeResult(Value->size());
-                } break;
-                case Operation::Lower: {
-                    std::string Result = GetArguments<1>(Node)[0]->get<std::string>();
-                    std::transform(Result.begin(), Result.end(), Result.begin(), ::tolower);
-                    MakeResult(std::move(Result));
-                } break;
-                case Operation::Max: {
-                    const auto Arguments = GetArguments<1>(Node);
-                    const auto Result = std::max_element(Arguments[0]->begin(), Arguments[0]->end());
-                    DataEvalStack.push(&(*Result));
-                } break;
-                case Operation::Min: {
-                    const auto Arguments = GetArguments<1>(Node);
-                    const auto Result = std::min_element(Arguments[0]->begin(), Arguments[0]->end());
-                    DataEvalStack.push(&(*Result));
-                } break;
-                case Operation::Odd: {
-                    MakeResult(GetArguments<1>(Node)[0]->get<int>() % 2 != 0);
-                } break;
-                case Operation::Range: {
-                    std::vector<int> Result(GetArguments<1>(Node)[0]->get<int>());
-                    std::iota(Result.begin(), Result.end(), 0);
-                    MakeResult(std::move(Result));
-                } break;
-                case Operation::Round: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    const int Precision = Arguments[1]->get<int>();
-                    const double Result = std::round(Arguments[0]->get<double>() * std::pow(10.0, Precision)) / std::pow(10.0, Precision);
-                    if(Precision == 0)
-                        MakeResult(int(Result));
-                    else
-                        MakeResult(Result);
-                } break;
-                case Operation::Sort: {
-                    auto ResultPointer = std::make_shared<JSON>(GetArguments<1>(Node)[0]->get<std::vector<JSON>>());
-                    std::sort(ResultPointer->begin(), ResultPointer->end());
-                    DataTempStack.push_back(ResultPointer);
-                    DataEvalStack.push(ResultPointer.get());
-                } break;
-                case Operation::Upper: {
-                    std::string Result = GetArguments<1>(Node)[0]->get<std::string>();
-                    std::transform(Result.begin(), Result.end(), Result.begin(), ::toupper);
-                    MakeResult(std::move(Result));
-                } break;
-                case Operation::IsBoolean: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_boolean());
-                } break;
-                case Operation::IsNumber: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number());
-                } break;
-                case Operation::IsInteger: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number_integer());
-                } break;
-                case Operation::IsFloat: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_number_float());
-                } break;
-                case Operation::IsObject: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_object());
+                case Token::Keyword::EndFor: {
+                    if(ForStatementStack.empty() || CurrentBlock != &ForStatementStack.top()->Body)
+                        ThrowParserError("EndFor without matching For");
+                    auto &ForStatementData = ForStatementStack.top();
+                    GetNextToken();
+                    CurrentBlock = ForStatementData->Parent;
+                    ForStatementStack.pop();
                 } break;
-                case Operation::IsArray: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_array());
+                case Token::Keyword::Include: {
+                    GetNextToken();
+                    std::string TemplateName = ParseFilename(TokenInstance);
+                    AddToTemplateStorage(Path, TemplateName);
+                    CurrentBlock->Nodes.emplace_back(CreateNode<IncludeStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                    GetNextToken();
                 } break;
-                case Operation::IsString: {
-                    MakeResult(GetArguments<1>(Node)[0]->is_string());
+                case Token::Keyword::Extends: {
+                    GetNextToken();
+                    std::string TemplateName = ParseFilename(TokenInstance);
+                    AddToTemplateStorage(Path, TemplateName);
+                    CurrentBlock->Nodes.emplace_back(CreateNode<ExtendsStatementNode>(TemplateName, TokenInstance.Text.data() - TemplateLocal.Content.data()));
+                    GetNextToken();
                 } break;
-                case Operation::Callback: {
-                    auto Arguments = GetArgumentVector(Node);
-                    MakeResult(Node.Callback(Arguments));
+                case Token::Keyword::Set: {
+                    GetNextToken();
+                    if(TokenInstance.KindInstance != Token::Kind::Id)
+                        ThrowParserError("Expected variable name, got '" + TokenInstance.Describe() + "'");
+                    std::string Key = static_cast<std::string>(TokenInstance.Text);
+                    GetNextToken();
+                    auto SetStatementNodeInstance = CreateNode<SetStatementNode>(Key, TokenInstance.Text.data() - TemplateLocal.Content.data());
+                    CurrentBlock->Nodes.emplace_back(SetStatementNodeInstance);
+                    CurrentExpressionList = &SetStatementNodeInstance->Expression;
+                    if(TokenInstance.Text != static_cast<decltype(TokenInstance.Text)>("="))
+                        ThrowParserError("Expected '=', got '" + TokenInstance.Describe() + "'");
+                    GetNextToken();
+                    if(!ParseExpression(TemplateLocal, Closing))
+                        return false;
                 } break;
-                case Operation::Super: {
-                    const auto Arguments = GetArgumentVector(Node);
-                    const size_t OldLevel = CurrentLevel;
-                    const size_t LevelDiff = (Arguments.size() != 1) ? Arguments[0]->get<int>() : 1;
-                    const size_t Level = CurrentLevel + LevelDiff;
+                default:
+                    return false;
+            }
+            return true;
+        }
 
-                    if(BlockStatementStack.empty())
-                        ThrowRendererError("Super() call is not withing a block", Node);
-                    
-                    if(Level < 1 || Level > TemplateStack.size() - 1)
-                        ThrowRendererError("Level of Super() call does not match parent templates (between 1 and " + std::to_string(TemplateStack.size() - 1) + ")", Node);
+        // ! Appends the spliced nodes to the root once the text node just lexed is
+        // ! one of them, the rest of the content is then known to parse the same
+        bool TakeSplice(Template &TemplateLocal, size_t TextPosition, size_t Length){
+            Splice &SpliceLocal = *SpliceInstance;
+            if(TextPosition < SpliceLocal.EditEnd)
+                return false;
+            const size_t PreviousPosition = static_cast<size_t>(static_cast<std::ptrdiff_t>(TextPosition) - SpliceLocal.Delta);
+            while(SpliceLocal.Next < SpliceLocal.Nodes.size() && SpliceLocal.Nodes[SpliceLocal.Next]->Position < PreviousPosition)
+                SpliceLocal.Next += 1;
+            if(SpliceLocal.Next == SpliceLocal.Nodes.size())
+                return false;
+            const auto TextNodeInstance = dynamic_cast<const TextNode*>(SpliceLocal.Nodes[SpliceLocal.Next]);
+            if(!TextNodeInstance || TextNodeInstance->Position != PreviousPosition || TextNodeInstance->Length != Length)
+                return false;
+            // ! A block name taken by the new nodes is reported by the regular parse
+            for(const auto &Block : SpliceLocal.Blocks)
+                if(Block.second->Position >= PreviousPosition && TemplateLocal.BlockStorage.count(Block.first))
+                    return false;
+            for(const auto &Block : SpliceLocal.Blocks)
+                if(Block.second->Position >= PreviousPosition)
+                    TemplateLocal.BlockStorage.emplace(Block.first, Block.second);
+            PositionShifter Shifter(SpliceLocal.Delta);
+            for(size_t Iterator = SpliceLocal.Next; Iterator < SpliceLocal.Nodes.size(); Iterator += 1){
+                SpliceLocal.Nodes[Iterator]->Accept(Shifter);
+                TemplateLocal.Root.Nodes.emplace_back(SpliceLocal.Nodes[Iterator]);
+            }
+            return true;
+        }
+
+        void FinishTemplate(Template &TemplateLocal){
+            if(!SpliceInstance)
+                TemplateLocal.ParsedNodeCount = Arena->Size();
+            TemplateLocal.InvariantData = ParserConfigurationInstance.InvariantData;
+            if(ParserConfigurationInstance.FoldConstants){
+                ConstantFolder Folder(TemplateLookup(TemplateStorageInstance, SharedTemplates), FunctionStorageInstance, TemplateLocal.InvariantData);
+                TemplateLocal.ProgramInstance = Compiler(&Folder).Compile(TemplateLocal);
+            }else
+                TemplateLocal.ProgramInstance = Compiler().Compile(TemplateLocal);
+            TemplateLocal.EstimateOutputSize();
+        }
+
+        void ParseInto(Template &TemplateLocal, std::string_view Path, size_t Offset = 0){
+            LexerInstance.Start(TemplateLocal.Content, Offset);
+            Arena = TemplateLocal.Arena.get();
+            CurrentBlock = &TemplateLocal.Root;
+            for(;;){
+                GetNextToken();
+                switch(TokenInstance.KindInstance){
+                    case Token::Kind::Eof: {
+                        if(!IfStatementStack.empty())
+                            ThrowParserError("Unmatched If");
+                        if(!ForStatementStack.empty())
+                            ThrowParserError("Unmatched For");
+                        if(!BlockStatementStack.empty())
+                            ThrowParserError("Unmatched Block");
+                        FinishTemplate(TemplateLocal);
+                    } return;
+                    case Token::Kind::Text: {
+                        const size_t TextPosition = TokenInstance.Text.data() - TemplateLocal.Content.data();
+                        if(SpliceInstance && CurrentBlock == &TemplateLocal.Root && TakeSplice(TemplateLocal, TextPosition, TokenInstance.Text.size())){
+                                FinishTemplate(TemplateLocal);
+                                return;
+                            }
+                        CurrentBlock->Nodes.emplace_back(CreateNode<TextNode>(TextPosition, TokenInstance.Text.size()));
+                    } break;
+                    case Token::Kind::StatementOpen: {
+                        GetNextToken();
+                        if(!ParseStatement(TemplateLocal, Token::Kind::StatementClose, Path))
+                            ThrowParserError("Expected statement, got '" + TokenInstance.Describe() + "'");
+                        if(TokenInstance.KindInstance != Token::Kind::StatementClose)
+                            ThrowParserError("Expected statement close, got '" + TokenInstance.Describe() + "'");
+                    } break;
+                    case Token::Kind::LineStatementOpen: {
+                        GetNextToken();
+                        if(!ParseStatement(TemplateLocal, Token::Kind::LineStatementClose, Path))
+                            ThrowParserError("Expected statement, got '" + TokenInstance.Describe() + "'");
+                        if(TokenInstance.KindInstance != Token::Kind::LineStatementClose && TokenInstance.KindInstance != Token::Kind::Eof)
+                            ThrowParserError("Expected line statement close, got '" + TokenInstance.Describe() + "'");
+                    } break;
+                    case Token::Kind::ExpressionOpen: {
+                        GetNextToken();
+                        auto ExpressionListNodeInstance = CreateNode<ExpressionListNode>(TokenInstance.Text.data() - TemplateLocal.Content.data());
+                        CurrentBlock->Nodes.emplace_back(ExpressionListNodeInstance);
+                        CurrentExpressionList = ExpressionListNodeInstance;
+                        if(!ParseExpression(TemplateLocal, Token::Kind::ExpressionClose))
+                            ThrowParserError("Expected expression, got '" + TokenInstance.Describe() + "'");
+                        if(TokenInstance.KindInstance != Token::Kind::ExpressionClose)
+                            ThrowParserError("Expected expression close, got '" + TokenInstance.Describe() + "'");
+                    } break;
+                    case Token::Kind::CommentOpen: {
+                        GetNextToken();
+                        if(TokenInstance.KindInstance != Token::Kind::CommentClose)
+                            ThrowParserError("Expected comment close, got '" + TokenInstance.Describe() + "'");
+                    } break;
+                    default: {
+                        ThrowParserError("Unexpected token '" + TokenInstance.Describe() + "'");
+                    } break;
+                }
+            }
+        }
+        
+        public:
+            // ! Includes are looked up in SharedTemplatesLocal too, the new ones are
+            // ! added to TemplateStorageLocal
+            explicit Parser(const ParserConfiguration &ParserConfigurationLocal, const LexerConfiguration &LexerConfigurationLocal,
+                            TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal, const TemplateSnapshot* SharedTemplatesLocal = nullptr)
+                : ParserConfigurationInstance(ParserConfigurationLocal), LexerInstance(LexerConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal),
+                  SharedTemplates(SharedTemplatesLocal), FunctionStorageInstance(FunctionStorageLocal){}
+            
+            Template Parse(std::string_view Input, std::string_view Path){
+                auto Result = Template(static_cast<std::string>(Input));
+                ParseInto(Result, Path);
+                return Result;
+            }
+
+            Template Parse(std::string_view Input){
+                return Parse(Input, "./");
+            }
 
-                    const auto CurrentBlockStatement = BlockStatementStack.back();
-                    const Template* NewTemplate = TemplateStack.at(Level);
-                    const Template* OldTemplate = CurrentTemplate;
-                    const auto BlockIterator = NewTemplate->BlockStorage.find(CurrentBlockStatement->Name);
-                    if(BlockIterator != NewTemplate->BlockStorage.end()){
-                        CurrentTemplate = NewTemplate;
-                        CurrentLevel = Level;
-                        BlockIterator->second->Block.Accept(*this);
-                        CurrentLevel = OldLevel;
-                        CurrentTemplate = OldTemplate;
-                    }else
-                        ThrowRendererError("Could not find block with name '" + CurrentBlockStatement->Name + "'", Node);
-                    MakeResult(nullptr);
-                } break;
-                case Operation::Join: {
-                    const auto Arguments = GetArguments<2>(Node);
-                    const auto Separator = Arguments[1]->get<std::string>();
-                    std::ostringstream Stream;
-                    std::string Sep;
-                    for(const auto &Value : *Arguments[0]){
-                        Stream << Sep;
-                        if(Value.is_string())
-                            Stream << Value.get<std::string>();
-                        else
-                            Stream << Value.dump();
-                        Sep = Separator;
+            // ! Parses a piece of a template that starts at Offset of Input, the
+            // ! content is moved into the template instead of being copied
+            Template Parse(std::string Input, size_t Offset, std::string_view Path){
+                Template Result(std::move(Input));
+                ParseInto(Result, Path, Offset);
+                return Result;
+            }
+
+            // ! Parses the content of Previous with Edit applied, only the root nodes
+            // ! around the edit are parsed again, the nodes before it are shared and
+            // ! the ones after it are moved over, so Previous must not be used once
+            // ! this returns, it is left as it was when parsing fails
+            Template Reparse(Template &Previous, const TemplateEdit &Edit, std::string_view Path){
+                if(Edit.Offset > Previous.Content.size() || Edit.Length > Previous.Content.size() - Edit.Offset)
+                    SYDONIA_THROW(ParserError("Edit exceeds the template content", GetSourceLocation(Previous.Content, Previous.Content.size())));
+                std::string Content;
+                Content.reserve(Previous.Content.size() - Edit.Length + Edit.Text.size());
+                Content.append(Previous.Content.substr(0, Edit.Offset)).append(Edit.Text).append(Previous.Content.substr(Edit.Offset + Edit.Length));
+                // ! Copies of the template share its nodes, and the replaced nodes of
+                // ! earlier reparses pile up in the arena
+                if(Previous.Arena.use_count() != 1 || Previous.Arena->Size() > 2 * Previous.ParsedNodeCount + 1024)
+                    return Parse(Content, Path);
+
+                // ! Restart at the last root text node before the edit, the lexer and
+                // ! the parser are in their initial state there
+                const auto &Nodes = Previous.Root.Nodes;
+                size_t Restart = 0, RestartPosition = 0;
+                for(size_t Iterator = 0; Iterator < Nodes.size() && Nodes[Iterator]->Position < Edit.Offset; Iterator += 1)
+                    if(dynamic_cast<const TextNode*>(Nodes[Iterator])){
+                        Restart = Iterator;
+                        RestartPosition = Nodes[Iterator]->Position;
                     }
-                    MakeResult(Stream.str());
-                } break;
-                case Operation::ParenLeft:
-                case Operation::ParenRight:
-                case Operation::None:
-                    break;
+
+                Template Result(std::move(Content));
+                Result.Arena = Previous.Arena;
+                Result.ParsedNodeCount = Previous.ParsedNodeCount;
+                Result.Root.Nodes.assign(Nodes.begin(), Nodes.begin() + Restart);
+                Splice SpliceLocal;
+                SpliceLocal.Nodes.assign(Nodes.begin() + Restart, Nodes.end());
+                SpliceLocal.EditEnd = Edit.Offset + Edit.Text.size();
+                SpliceLocal.Delta = static_cast<std::ptrdiff_t>(Edit.Text.size()) - static_cast<std::ptrdiff_t>(Edit.Length);
+                for(const auto &Block : Previous.BlockStorage)
+                    if(Block.second->Position < RestartPosition)
+                        Result.BlockStorage.emplace(Block);
+                    else
+                        SpliceLocal.Blocks.emplace_back(Block);
+
+                SpliceInstance = &SpliceLocal;
+                ParseInto(Result, Path, RestartPosition);
+                SpliceInstance = nullptr;
+                return Result;
             }
-        }
 
-        void Visit(const ExpressionListNode &Node){
-            PrintData(EvalExpressionList(Node));
-        }
+            Template Reparse(Template &Previous, const TemplateEdit &Edit){
+                return Reparse(Previous, Edit, "./");
+            }
 
-        void Visit(const StatementNode &){}
+            void ParseIntoTemplate(Template &TemplateLocal, std::string_view Filename){
+                std::string_view Path = Filename.substr(0, Filename.find_last_of("/\\") + 1);
+                auto SubParser = Parser(ParserConfigurationInstance, LexerInstance.GetConfiguration(), 
+                                        TemplateStorageInstance, FunctionStorageInstance, SharedTemplates);
+                SubParser.ParseInto(TemplateLocal, Path);
+            }
 
-        void Visit(const ForStatementNode &){}
+            std::string LoadFile(const std::string &Filename){
+                std::string Text;
+                if(!ReadFile(Filename, Text))
+                    SYDONIA_THROW(FileError("Failed accessing file at '" + Filename + "'"));
+                return Text;
+            }
 
-        void Visit(const ForArrayStatementNode &Node){
-            const auto Result = EvalExpressionList(Node.Condition);
-            if(!Result->is_array())
-                ThrowRendererError("Object must be an array", Node);
-            if(!CurrentLoopData->empty()){
-                auto Temp = *CurrentLoopData;
-                (*CurrentLoopData)["Parent"] = std::move(Temp);
-            }
-            size_t Index = 0;
-            (*CurrentLoopData)["IsFirst"] = true;
-            (*CurrentLoopData)["IsLast"] = (Result->size() <= 1);
-            for(auto Iterator = Result->begin(); Iterator != Result->end(); ++Iterator){
-                AdditionalData[static_cast<std::string>(Node.Value)] = *Iterator;
-                (*CurrentLoopData)["Index"] = Index;
-                (*CurrentLoopData)["Index1"] = Index + 1;
-                if(Index == 1)
-                    (*CurrentLoopData)["IsFirst"] = false;
-                if(Index == Result->size() - 1)
-                    (*CurrentLoopData)["IsLast"] = true;
-                Node.Body.Accept(*this);
-                ++Index;
+            // ! Opens a template file the way the configuration asks for, mapped or copied
+            std::shared_ptr<const TemplateSource> LoadSource(const std::string &Filename){
+                auto Source = OpenFile(Filename);
+                if(!Source)
+                    SYDONIA_THROW(FileError("Failed accessing file at '" + Filename + "'"));
+                return Source;
             }
+    };
+}; // ! Sydonia namespace
 
-            AdditionalData[static_cast<std::string>(Node.Value)].clear();
-            if(!(*CurrentLoopData)["Parent"].empty()){
-                const auto Temp = (*CurrentLoopData)["Parent"];
-                *CurrentLoopData = std::move(Temp);
-            }else
-                CurrentLoopData = &AdditionalData["Loop"];
-        }
+#endif // ! SYDONIA_PARSER_HXX
 
-        void Visit(const ForObjectStatementNode &Node){
-            const auto Result = EvalExpressionList(Node.Condition);
-            if(!Result->is_object())
-                ThrowRendererError("Object must be an object", Node);
-            if(!CurrentLoopData->empty())
-                (*CurrentLoopData)["Parent"] = std::move(*CurrentLoopData);
-            size_t Index = 0;
-            (*CurrentLoopData)["IsFirst"] = true;
-            (*CurrentLoopData)["IsLast"] = (Result->size() <= 1);
-            for(auto Iterator = Result->begin(); Iterator != Result->end(); ++Iterator){
-                AdditionalData[static_cast<std::string>(Node.Key)] = Iterator.key();
-                AdditionalData[static_cast<std::string>(Node.Value)] = Iterator.value();
-                (*CurrentLoopData)["Index"] = Index;
-                (*CurrentLoopData)["Index1"] = Index + 1;
-                if(Index == 1)
-                    (*CurrentLoopData)["IsFirst"] = false;
-                if(Index == Result->size() - 1)
-                    (*CurrentLoopData)["IsLast"] = true;
-                Node.Body.Accept(*this);
-                ++Index;
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TEMPLATE_CACHE_HXX
+#define SYDONIA_TEMPLATE_CACHE_HXX
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Sydonia{
+    // ! Counters of a template cache
+    struct TemplateCacheStatistics{
+        size_t Hits {0};
+        size_t Misses {0};
+        size_t Evictions {0};
+        size_t Size {0};
+        size_t Capacity {0};
+    };
+
+    // ! Parsed templates keyed by file path, an entry is only returned while the
+    // ! file keeps the modification time and size it had when it was parsed, the
+    // ! least recently used entry is dropped once the capacity is reached
+    class TemplateCache{
+        struct Entry{
+            std::shared_ptr<const Template> TemplateInstance;
+            std::filesystem::file_time_type ModifiedTime;
+            std::uintmax_t FileSize;
+            std::list<std::string>::iterator Recency;
+        };
+
+        mutable std::mutex Mutex;
+        std::unordered_map<std::string, Entry> Entries;
+        // ! Most recently used path at the front
+        std::list<std::string> RecencyList;
+        TemplateCacheStatistics StatisticsInstance;
+
+        void Evict(size_t Capacity){
+            while(Entries.size() > Capacity){
+                Entries.erase(RecencyList.back());
+                RecencyList.pop_back();
+                StatisticsInstance.Evictions += 1;
             }
-            AdditionalData[static_cast<std::string>(Node.Key)].clear();
-            AdditionalData[static_cast<std::string>(Node.Value)].clear();
-            if(!(*CurrentLoopData)["Parent"].empty())
-                *CurrentLoopData = std::move((*CurrentLoopData)["Parent"]);
-            else
-                CurrentLoopData = &AdditionalData["Loop"];
         }
 
-        void Visit(const IfStatementNode &Node){
-            const auto Result = EvalExpressionList(Node.Condition);
-            if(Truthy(Result.get()))
-                Node.TrueStatement.Accept(*this);
-            else if(Node.HasFalseStatement)
-                Node.FalseStatement.Accept(*this);
-        }
+        public:
+            explicit TemplateCache(size_t Capacity = 64){
+                StatisticsInstance.Capacity = Capacity;
+            }
 
-        void Visit(const IncludeStatementNode &Node){
-            auto SubRenderer = Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-            const auto IncludedTemplateIterator = TemplateStorageInstance.find(Node.File);
-            if(IncludedTemplateIterator != TemplateStorageInstance.end())
-                SubRenderer.RenderTo(*OutputStream, IncludedTemplateIterator->second, *DataInput, &AdditionalData);
-            else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
-                ThrowRendererError("Include '" + Node.File + "' not found", Node);
-        }
-        
-        void Visit(const ExtendsStatementNode &Node){
-            const auto IncludedTemplateIterator = TemplateStorageInstance.find(Node.File);
-            if(IncludedTemplateIterator != TemplateStorageInstance.end()){
-                const Template* ParentTemplate = &IncludedTemplateIterator->second;
-                RenderTo(*OutputStream, *ParentTemplate, *DataInput, &AdditionalData);
-                BreakRendering = true;
-            }else if(RenderConfigurationInstance.ThrowAtMissingIncludes)
-                ThrowRendererError("Extends '" + Node.File + "' not found", Node);
-        }
+            // ! A copy starts empty with the same capacity
+            TemplateCache(const TemplateCache &Other): TemplateCache(Other.Statistics().Capacity){}
+
+            TemplateCache &operator=(const TemplateCache &Other){
+                if(this != &Other){
+                    const size_t Capacity = Other.Statistics().Capacity;
+                    std::lock_guard<std::mutex> Lock(Mutex);
+                    Entries.clear();
+                    RecencyList.clear();
+                    StatisticsInstance = TemplateCacheStatistics();
+                    StatisticsInstance.Capacity = Capacity;
+                }
+                return *this;
+            }
 
-        void Visit(const BlockStatementNode &Node){
-            const size_t OldLevel = CurrentLevel;
-            CurrentLevel = 0;
-            CurrentTemplate = TemplateStack.front();
-            const auto BlockIterator = CurrentTemplate->BlockStorage.find(Node.Name);
-            if(BlockIterator != CurrentTemplate->BlockStorage.end()){
-                BlockStatementStack.emplace_back(&Node);
-                BlockIterator->second->Block.Accept(*this);
-                BlockStatementStack.pop_back();
+            // ! Returns the template parsed from Path, calling Parse on a miss or when
+            // ! the file changed since it was cached, Parse runs outside of the lock
+            template<typename ParseFunction>
+            std::shared_ptr<const Template> Get(const std::string &Path, ParseFunction &&Parse){
+                std::error_code Error;
+                const auto ModifiedTime = std::filesystem::last_write_time(Path, Error);
+                const auto FileSize = Error ? 0 : std::filesystem::file_size(Path, Error);
+                if(Error){
+                    // ! Let the parser report the missing file
+                    {
+                        std::lock_guard<std::mutex> Lock(Mutex);
+                        StatisticsInstance.Misses += 1;
+                    }
+                    return std::make_shared<const Template>(Parse());
+                }
+                {
+                    std::lock_guard<std::mutex> Lock(Mutex);
+                    const auto Iterator = Entries.find(Path);
+                    if(Iterator != Entries.end()){
+                        if(Iterator->second.ModifiedTime == ModifiedTime && Iterator->second.FileSize == FileSize){
+                            RecencyList.splice(RecencyList.begin(), RecencyList, Iterator->second.Recency);
+                            StatisticsInstance.Hits += 1;
+                            return Iterator->second.TemplateInstance;
+                        }
+                        RecencyList.erase(Iterator->second.Recency);
+                        Entries.erase(Iterator);
+                    }
+                    StatisticsInstance.Misses += 1;
+                }
+                auto Result = std::make_shared<const Template>(Parse());
+                std::lock_guard<std::mutex> Lock(Mutex);
+                if(StatisticsInstance.Capacity == 0)
+                    return Result;
+                const auto Iterator = Entries.find(Path);
+                if(Iterator != Entries.end()){
+                    // ! Another thread parsed the same file meanwhile, keep the newest one
+                    Iterator->second.TemplateInstance = Result;
+                    Iterator->second.ModifiedTime = ModifiedTime;
+                    Iterator->second.FileSize = FileSize;
+                    RecencyList.splice(RecencyList.begin(), RecencyList, Iterator->second.Recency);
+                    return Result;
+                }
+                RecencyList.push_front(Path);
+                Entries.emplace(Path, Entry {Result, ModifiedTime, FileSize, RecencyList.begin()});
+                Evict(StatisticsInstance.Capacity);
+                return Result;
             }
-            CurrentLevel = OldLevel;
-            CurrentTemplate = TemplateStack.back();
+
+            // ! Sets the maximum number of cached templates, zero disables caching
+            void SetCapacity(size_t Capacity){
+                std::lock_guard<std::mutex> Lock(Mutex);
+                StatisticsInstance.Capacity = Capacity;
+                Evict(Capacity);
+            }
+
+            void Clear(){
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Entries.clear();
+                RecencyList.clear();
+            }
+
+            TemplateCacheStatistics Statistics() const{
+                std::lock_guard<std::mutex> Lock(Mutex);
+                auto Result = StatisticsInstance;
+                Result.Size = Entries.size();
+                return Result;
+            }
+    };
+}; // ! Sydonia namespace
+
+#endif // ! SYDONIA_TEMPLATE_CACHE_HXX
+/***
+ * Copyright (C) Rodolfo Herrera Hernandez. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root 
+ * for full license information.
+ *
+ * =+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ *
+ * For related information - https://github.com/CodeWithRodi/Sydonia/
+ *
+ * =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+ ****/
+
+#ifndef SYDONIA_TEMPLATE_STREAM_HXX
+#define SYDONIA_TEMPLATE_STREAM_HXX
+
+#include <algorithm>
+#include <istream>
+#include <string>
+
+namespace Sydonia{
+    // ! Splits a template read from a stream into pieces that parse on their own,
+    // ! a piece always ends in static text outside of any statement, so only the
+    // ! statement being read and a little trailing text are held in memory
+    class TemplateStream{
+        static constexpr size_t ChunkSize {65536};
+
+        std::istream &Input;
+        Lexer LexerInstance;
+        // ! Bytes at the end of the window that could still become an opener
+        const size_t OpenLookahead;
+        // ! Unread part of the template, after the first piece it starts with one
+        // ! byte standing for the one before it ('\n' or ' ') so the lexer knows
+        // ! whether it is at the start of a line
+        std::string Window;
+        size_t Start {0};
+        size_t ReadSize {ChunkSize};
+        bool Ended {false};
+
+        static size_t LongestOpener(const LexerConfiguration &Configuration){
+            return std::max({Configuration.StatementOpen.size(), Configuration.StatementOpenNoLstrip.size(), Configuration.StatementOpenForceLstrip.size(),
+                            Configuration.ExpressionOpen.size(), Configuration.ExpressionOpenForceLstrip.size(), Configuration.CommentOpen.size(),
+                            Configuration.CommentOpenForceLstrip.size(), Configuration.LineStatement.size()});
         }
 
-        void Visit(const SetStatementNode &Node){
-            std::string Pointer = Node.Key;
-            ReplaceSubString(Pointer, ".", "/");
-            Pointer = "/" + Pointer;
-            AdditionalData[JSON::json_pointer(Pointer)] = *EvalExpressionList(Node.Expression);
+        void Fill(){
+            const size_t Size = Window.size();
+            Window.resize(Size + ReadSize);
+            Input.read(&Window[Size], ReadSize);
+            Window.resize(Size + static_cast<size_t>(Input.gcount()));
+            if(Window.size() == Size)
+                Ended = true;
+        }
+
+        // ! Last offset of the window where it can be split, zero when there is
+        // ! none, the text before it has to be final whatever is read next
+        size_t FindCut(){
+            LexerInstance.Start(Window, Start);
+            const size_t Settled = (Window.size() > OpenLookahead) ? Window.size() - OpenLookahead : 0;
+            size_t Depth = 0, Cut = 0, PreviousEnd = Start;
+            for(;;){
+                const Token TokenInstance = LexerInstance.Scan();
+                if(TokenInstance.KindInstance == Token::Kind::Eof)
+                    break;
+                const size_t Begin = TokenInstance.Text.data() - Window.data();
+                size_t End = Begin + TokenInstance.Text.size();
+                switch(TokenInstance.KindInstance){
+                    case Token::Kind::Text: {
+                        if(Depth != 0 || Begin >= Settled)
+                            break;
+                        if(End <= Settled && End < Window.size()){
+                            // ! Followed by a whole opener, trimming already happened
+                            Cut = End;
+                            break;
+                        }
+                        // ! Runs into the unread part, keep the end of the last line when it
+                        // ! is blank so a trimming opener after it still sees all of it
+                        size_t Candidate = Settled;
+                        while(Candidate > Begin && Window[Candidate - 1] != '\n' && Window[Candidate - 1] != '\r' &&
+                            (Window[Candidate] == ' ' || Window[Candidate] == '\t'))
+                            Candidate -= 1;
+                        if(Candidate > Begin)
+                            Cut = Candidate;
+                    } break;
+                    case Token::Kind::StatementOpen:
+                    case Token::Kind::LineStatementOpen: {
+                        if(Depth == 0 && Begin == PreviousEnd && Begin > Start && Begin <= Settled)
+                            Cut = Begin;
+                        const Token Name = LexerInstance.Scan();
+                        if(Name.KindInstance == Token::Kind::Eof)
+                            return Cut;
+                        switch(Name.KeywordInstance){
+                            case Token::Keyword::If:
+                            case Token::Keyword::For:
+                            case Token::Keyword::Block:
+                                Depth += 1;
+                                break;
+                            case Token::Keyword::EndIf:
+                            case Token::Keyword::EndFor:
+                            case Token::Keyword::EndBlock:
+                                Depth -= (Depth > 0) ? 1 : 0;
+                                break;
+                            default:
+                                break;
+                        }
+                        End = (Name.Text.data() - Window.data()) + Name.Text.size();
+                    } break;
+                    case Token::Kind::ExpressionOpen:
+                    case Token::Kind::CommentOpen: {
+                        if(Depth == 0 && Begin == PreviousEnd && Begin > Start && Begin <= Settled)
+                            Cut = Begin;
+                    } break;
+                    default:
+                        break;
+                }
+                PreviousEnd = End;
+            }
+            return Cut;
         }
 
         public:
-            Renderer(const RenderConfiguration &RenderConfigurationLocal, const TemplateStorage &TemplateStorageLocal, const FunctionStorage &FunctionStorageLocal)
-                : RenderConfigurationInstance(RenderConfigurationLocal), TemplateStorageInstance(TemplateStorageLocal), FunctionStorageInstance(FunctionStorageLocal){}
-            
-            void RenderTo(std::ostream &Stream, const Template &TemplateLocal, const JSON &Data, JSON* LoopData = nullptr){
-                OutputStream = &Stream;
-                CurrentTemplate = &TemplateLocal;
-                DataInput = &Data;
-                if(LoopData){
-                    AdditionalData = *LoopData;
-                    CurrentLoopData = &AdditionalData["Loop"];
+            explicit TemplateStream(std::istream &InputLocal, const LexerConfiguration &LexerConfigurationLocal)
+                : Input(InputLocal), LexerInstance(LexerConfigurationLocal), OpenLookahead(LongestOpener(LexerConfigurationLocal)){}
+
+            // ! Moves the next piece into Piece, the template starts at Offset within
+            // ! it, returns false once the stream is exhausted
+            bool Next(std::string &Piece, size_t &Offset){
+                for(;;){
+                    if(Ended){
+                        if(Window.size() <= Start)
+                            return false;
+                        Piece = std::move(Window);
+                        Offset = Start;
+                        Window.clear();
+                        Start = 0;
+                        return true;
+                    }
+                    Fill();
+                    if(Ended)
+                        continue;
+                    const size_t Cut = FindCut();
+                    if(Cut > Start){
+                        std::string Rest(1, (Window[Cut - 1] == '\n') ? '\n' : ' ');
+                        Rest.append(Window, Cut, std::string::npos);
+                        Window.resize(Cut);
+                        Piece = std::move(Window);
+                        Offset = Start;
+                        Window = std::move(Rest);
+                        Start = 1;
+                        ReadSize = ChunkSize;
+                        return true;
+                    }
+                    // ! Inside a long statement, read more at once so the window is not
+                    // ! scanned over and over
+                    ReadSize *= 2;
                 }
-                TemplateStack.emplace_back(CurrentTemplate);
-                CurrentTemplate->Root.Accept(*this);
-                DataTempStack.clear();
             }
     };
 }; // ! Sydonia namespace
 
-#endif // ! SYDONIA_RENDERER_HXX
+#endif // ! SYDONIA_TEMPLATE_STREAM_HXX
 
 namespace Sydonia{
     // ! Class for changing the configuration
+    // !
+    // ! Once Freeze() has been called the configuration and the callbacks can no
+    // ! longer change, the environment can then parse and render from any number
+    // ! of threads at once (callbacks must be safe to call concurrently). The
+    // ! included templates are kept in an immutable snapshot, each render takes
+    // ! the current one and IncludeTemplate or a parse that discovers new
+    // ! includes publishes a new snapshot, renders already running keep theirs
     class Environment{
         std::string OutputPath;
         std::string InputPath;
@@ -2510,8 +6345,68 @@ namespace Sydonia{
         ParserConfiguration ParserConfigurationInstance;
         RenderConfiguration RenderConfigurationInstance;
 
+        // ! Lock of the template storage writers and the frozen flag, a copy of the
+        // ! environment gets its own lock and keeps whether it is frozen
+        struct Synchronization{
+            std::mutex TemplateStorageMutex;
+            std::atomic<bool> Frozen {false};
+
+            Synchronization() = default;
+
+            Synchronization(const Synchronization &Other): Frozen(Other.Frozen.load(std::memory_order_acquire)){}
+
+            Synchronization &operator=(const Synchronization &Other){
+                Frozen.store(Other.Frozen.load(std::memory_order_acquire), std::memory_order_release);
+                return *this;
+            }
+        };
+
         FunctionStorage FunctionStorageInstance;
-        TemplateStorage TemplateStorageInstance;
+        std::shared_ptr<const TemplateSnapshot> TemplateStorageInstance {std::make_shared<const TemplateSnapshot>()};
+        TemplateCache TemplateCacheInstance;
+        Synchronization SynchronizationInstance;
+
+        void ThrowIfFrozen() const{
+            if(IsFrozen())
+                SYDONIA_THROW(EnvironmentError("The environment is frozen and can not be modified"));
+        }
+
+        std::shared_ptr<const TemplateSnapshot> GetTemplateStorage() const{
+            return std::atomic_load(&TemplateStorageInstance);
+        }
+
+        // ! Publishes a snapshot with Added on top of the current one, an include a
+        // ! parse discovered never replaces a template published meanwhile
+        void PublishTemplates(TemplateStorage Added, bool Replace){
+            std::lock_guard<std::mutex> Lock(SynchronizationInstance.TemplateStorageMutex);
+            auto Current = GetTemplateStorage();
+            if(!Replace){
+                for(auto Iterator = Added.begin(); Iterator != Added.end();)
+                    Iterator = Current->Find(Iterator->first) ? Added.erase(Iterator) : std::next(Iterator);
+            }
+            std::atomic_store(&TemplateStorageInstance, TemplateSnapshot::Add(std::move(Current), std::move(Added)));
+        }
+
+        // ! Runs a parser that reads the current snapshot, the templates it discovered
+        // ! are published afterwards
+        template<typename ParseFunction>
+        Template ParseWithStorage(const ParserConfiguration &Configuration, ParseFunction &&Parse){
+            const auto Shared = GetTemplateStorage();
+            TemplateStorage Discovered;
+            Parser ParserLocal(Configuration, LexerConfigurationInstance, Discovered, FunctionStorageInstance, Shared.get());
+            Template Result = Parse(ParserLocal);
+            if(!Discovered.empty())
+                PublishTemplates(std::move(Discovered), false);
+            return Result;
+        }
+
+        Template ParseTemplate(const std::string &Filename, const ParserConfiguration &Configuration){
+            return ParseWithStorage(Configuration, [&](Parser &ParserLocal){
+                auto Result = Template(ParserLocal.LoadSource(InputPath + static_cast<std::string>(Filename)));
+                ParserLocal.ParseIntoTemplate(Result, InputPath + static_cast<std::string>(Filename));
+                return Result;
+            });
+        }
 
         public:
             Environment(): Environment(""){}
@@ -2522,86 +6417,195 @@ namespace Sydonia{
 
             // ! Sets the opener and closer for template statements
             void SetStatement(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.StatementOpen = Open;
                 LexerConfigurationInstance.StatementOpenNoLstrip = Open + "+";
                 LexerConfigurationInstance.StatementOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.StatementClose = Close;
                 LexerConfigurationInstance.StatementCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener for template line statement
             void SetLineStatement(const std::string &Open){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.LineStatement = Open;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener and closer for template expressions
             void SetExpression(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.ExpressionOpen = Open;
                 LexerConfigurationInstance.ExpressionOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.ExpressionClose = Close;
                 LexerConfigurationInstance.ExpressionCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the opener and closer for template comments
             void SetComment(const std::string &Open, const std::string &Close){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.CommentOpen = Open;
                 LexerConfigurationInstance.CommentOpenForceLstrip = Open + "-";
                 LexerConfigurationInstance.CommentClose = Close;
                 LexerConfigurationInstance.CommentCloseForceRstrip = "-" + Close;
                 LexerConfigurationInstance.UpdateOpenCharacters();
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether to remove the first newline after a block
             void SetTrimBlocks(bool TrimBlocks){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.TrimBlocks = TrimBlocks;
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether to strip the spaces and tabs from the start of a line to a block
             void SetLstripBlocks(bool LstripBlocks){
+                ThrowIfFrozen();
                 LexerConfigurationInstance.LstripBlocks = LstripBlocks;
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets the element notation syntax
             void SetSearchIncludedTemplatesInFiles(bool SearchInFiles){
+                ThrowIfFrozen();
                 ParserConfigurationInstance.SearchIncludedTemplatesInFiles = SearchInFiles;
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Sets whether template files are mapped into memory instead of copied,
+            // ! a mapped file must be replaced (not rewritten in place) while in use,
+            // ! files loaded through LoadTemplate are copied regardless
+            void SetMapTemplateFiles(bool MapTemplateFiles){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.MapTemplateFiles = MapTemplateFiles;
+            }
+
+            // ! Sets whether the parts of a template that do not depend on the render
+            // ! data are evaluated once when it is parsed
+            void SetFoldConstants(bool FoldConstants){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.FoldConstants = FoldConstants;
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Declares the top level keys of Data render invariant, templates parsed
+            // ! afterwards read them from Data and evaluate what depends on them once,
+            // ! they stand in for the render data, loop variables and Set win over them
+            void SetInvariantData(const JSON &Data){
+                ThrowIfFrozen();
+                ParserConfigurationInstance.InvariantData = std::make_shared<const JSON>(Data);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Sets whether a missing include will throw an error
             void SetThrowAtMissingIncludes(bool WillThrow){
+                ThrowIfFrozen();
                 RenderConfigurationInstance.ThrowAtMissingIncludes = WillThrow;
             }
 
+            // ! Sets whether templates are rendered from their compiled program, when
+            // ! disabled the AST is walked instead, which is useful as a reference
+            void SetUseCompiledProgram(bool UseCompiledProgram){
+                ThrowIfFrozen();
+                RenderConfigurationInstance.UseCompiledProgram = UseCompiledProgram;
+            }
+
+            // ! Forbids any further change to the configuration and the callbacks,
+            // ! see the class comment for what may be used concurrently afterwards
+            void Freeze(){
+                SynchronizationInstance.Frozen.store(true, std::memory_order_release);
+            }
+
+            bool IsFrozen() const{
+                return SynchronizationInstance.Frozen.load(std::memory_order_acquire);
+            }
+
             Template Parse(std::string_view Input){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-                return ParserLocal.Parse(Input);
+                return ParseWithStorage(ParserConfigurationInstance, [&](Parser &ParserLocal){
+                    return ParserLocal.Parse(Input);
+                });
+            }
+
+            // ! Applies Edit to a template parsed from a string, only the part of the
+            // ! template around the edit is parsed again, the template is left as it
+            // ! was when the edited content fails to parse
+            void Reparse(Template &TemplateLocal, const TemplateEdit &Edit){
+                TemplateLocal = ParseWithStorage(ParserConfigurationInstance, [&](Parser &ParserLocal){
+                    return ParserLocal.Reparse(TemplateLocal, Edit);
+                });
             }
 
             Template ParseTemplate(const std::string &Filename){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
-                auto Result = Template(ParserLocal.LoadFile(InputPath + static_cast<std::string>(Filename)));
-                ParserLocal.ParseIntoTemplate(Result, InputPath + static_cast<std::string>(Filename));
-                return Result;
+                return ParseTemplate(Filename, ParserConfigurationInstance);
             }
 
             Template ParseFile(const std::string &Filename){
                 return ParseTemplate(Filename);
             }
 
+            // ! Returns the parsed template of a file, it is only parsed again when
+            // ! the file was modified since the last time it was loaded or when a
+            // ! setter or a callback changed how it parses, the file is always
+            // ! copied, never mapped, as it may be rewritten in place
+            std::shared_ptr<const Template> LoadTemplate(const std::string &Filename){
+                return TemplateCacheInstance.Get(InputPath + Filename, [&](){
+                    auto Configuration = ParserConfigurationInstance;
+                    Configuration.MapTemplateFiles = false;
+                    return ParseTemplate(Filename, Configuration);
+                });
+            }
+
+            // ! Paths of the render data a template may read, through the templates
+            // ! it includes or extends too, see DependencyVisitor for their form
+            std::set<std::string> GetDependencies(const Template &TemplateLocal) const{
+                const auto Storage = GetTemplateStorage();
+                return DependencyVisitor(*Storage).Collect(TemplateLocal);
+            }
+
+            // ! Sets how many parsed template files are kept, zero disables the cache
+            void SetTemplateCacheCapacity(size_t Capacity){
+                TemplateCacheInstance.SetCapacity(Capacity);
+            }
+
+            void ClearTemplateCache(){
+                TemplateCacheInstance.Clear();
+            }
+
+            TemplateCacheStatistics GetTemplateCacheStatistics() const{
+                return TemplateCacheInstance.Statistics();
+            }
+
             std::string Render(std::string_view Input, const JSON &Data){
                 return Render(Parse(Input), Data);
             }
 
             std::string Render(const Template &TemplateLocal, const JSON &Data){
-                std::stringstream Stream;
-                RenderTo(Stream, TemplateLocal, Data);
-                return Stream.str();
+                std::string Result;
+                RenderInto(Result, TemplateLocal, Data);
+                return Result;
+            }
+
+            // ! Renders into the given string, its content is replaced but its
+            // ! capacity is kept so the same buffer can be reused across calls
+            std::string &RenderInto(std::string &Result, const Template &TemplateLocal, const JSON &Data){
+                Result.clear();
+                OutputSink Sink(Result);
+                RenderTo(Sink, TemplateLocal, Data);
+                return Result;
+            }
+
+            std::string &RenderInto(std::string &Result, std::string_view Input, const JSON &Data){
+                return RenderInto(Result, Parse(Input), Data);
             }
 
             std::string RenderFile(const std::string &Filename, const JSON &Data){
-                return Render(ParseTemplate(Filename), Data);
+                return Render(*LoadTemplate(Filename), Data);
             }
 
             std::string RenderFileWithJsonFile(const std::string &Filename, const std::string &FilenameData){
@@ -2611,13 +6615,13 @@ namespace Sydonia{
 
             void Write(const std::string &Filename, const JSON &Data, const std::string &FilenameOut){
                 std::ofstream File(OutputPath + FilenameOut);
-                File << RenderFile(Filename, Data);
+                RenderTo(File, *LoadTemplate(Filename), Data);
                 File.close();
             }
 
             void Write(const Template &TemplateLocal, const JSON &Data, const std::string &FilenameOut){
                 std::ofstream File(OutputPath + FilenameOut);
-                File << Render(TemplateLocal, Data);
+                RenderTo(File, TemplateLocal, Data);
                 File.close();
             }
 
@@ -2632,12 +6636,52 @@ namespace Sydonia{
             }
 
             std::ostream &RenderTo(std::ostream &Stream, const Template &TemplateLocal, const JSON &Data){
-                Renderer(RenderConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance).RenderTo(Stream, TemplateLocal, Data);
+                OutputSink Sink(Stream);
+                RenderTo(Sink, TemplateLocal, Data);
                 return Stream;
             }
 
+            // ! Reserves the expected output of the template up front (with an eighth
+            // ! of headroom) and feeds the actual size back into the estimate
+            OutputSink &RenderTo(OutputSink &Sink, const Template &TemplateLocal, const JSON &Data){
+                const size_t Expected = TemplateLocal.OutputSize.Get();
+                Sink.Reserve(Expected + Expected / 8);
+                const size_t Start = Sink.Size();
+                const auto Storage = GetTemplateStorage();
+                Renderer(RenderConfigurationInstance, *Storage, FunctionStorageInstance).RenderTo(Sink, TemplateLocal, Data);
+                TemplateLocal.OutputSize.Update(Sink.Size() - Start);
+                return Sink;
+            }
+
+            // ! Renders a template read from Input piece by piece, the static text of
+            // ! a piece is written out and dropped before the next one is read, so
+            // ! only the statement being parsed is held in memory, templates read
+            // ! this way can not extend another one
+            std::ostream &RenderStream(std::istream &Input, std::ostream &Output, const JSON &Data){
+                const auto Shared = GetTemplateStorage();
+                TemplateStorage Discovered;
+                TemplateStream Pieces(Input, LexerConfigurationInstance);
+                Renderer RendererLocal(RenderConfigurationInstance, TemplateLookup(Discovered, Shared.get()), FunctionStorageInstance);
+                OutputSink Sink(Output);
+                std::string Piece;
+                size_t Offset = 0;
+                while(Pieces.Next(Piece, Offset)){
+                    Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, Discovered, FunctionStorageInstance, Shared.get());
+                    const Template PieceTemplate = ParserLocal.Parse(std::move(Piece), Offset, "./");
+                    for(const auto &Step : PieceTemplate.ProgramInstance.Instructions)
+                        if(Step.OpcodeInstance == Instruction::Opcode::Extends)
+                            SYDONIA_THROW(ParserError("Extends is not supported in a streamed template", PieceTemplate.Locate(Step.Node->Position)));
+                    RendererLocal.RenderPiece(Sink, PieceTemplate, Data);
+                }
+                Sink.Flush();
+                if(!Discovered.empty())
+                    PublishTemplates(std::move(Discovered), false);
+                return Output;
+            }
+
             std::string LoadFile(const std::string &Filename){
-                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, TemplateStorageInstance, FunctionStorageInstance);
+                TemplateStorage Storage;
+                Parser ParserLocal(ParserConfigurationInstance, LexerConfigurationInstance, Storage, FunctionStorageInstance);
                 return ParserLocal.LoadFile(InputPath + Filename);
             }
 
@@ -2661,27 +6705,61 @@ namespace Sydonia{
 
             // ! Adds a callback with given number of arguments
             void AddCallback(const std::string &Name, int NumberArgs, const CallbackFunction &Callback){
+                ThrowIfFrozen();
                 FunctionStorageInstance.AddCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Adds a void callback with given number of arguments
             void AddVoidCallback(const std::string &Name, int NumberArgs, const VoidCallbackFunction &Callback){
+                ThrowIfFrozen();
                 FunctionStorageInstance.AddCallback(Name, NumberArgs, [Callback](Arguments &Args){
                     Callback(Args);
                     return JSON();
                 });
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Adds a variadic callback that writes its result into a slot
+            void AddResultCallback(const std::string &Name, const ResultCallbackFunction &Callback){
+                AddResultCallback(Name, -1, Callback);
+            }
+
+            // ! Adds a callback with given number of arguments that writes its result
+            // ! into a slot, nothing is allocated to call it
+            void AddResultCallback(const std::string &Name, int NumberArgs, const ResultCallbackFunction &Callback){
+                ThrowIfFrozen();
+                FunctionStorageInstance.AddResultCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
+            }
+
+            // ! Adds a variadic callback that evaluates its arguments on demand
+            void AddLazyCallback(const std::string &Name, const LazyCallbackFunction &Callback){
+                AddLazyCallback(Name, -1, Callback);
+            }
+
+            // ! Adds a callback with given number of arguments that evaluates them on
+            // ! demand, an argument that is never asked for is never evaluated
+            void AddLazyCallback(const std::string &Name, int NumberArgs, const LazyCallbackFunction &Callback){
+                ThrowIfFrozen();
+                FunctionStorageInstance.AddLazyCallback(Name, NumberArgs, Callback);
+                TemplateCacheInstance.Clear();
             }
 
             // ! Includes a template with a given name into the environment
             // ! then a template can be rendered in another template using
-            // ! the include "<Name>" syntax
+            // ! the include "<Name>" syntax, allowed on a frozen environment
             void IncludeTemplate(const std::string &Name, const Template &TemplateLocal){
-                TemplateStorageInstance[Name] = TemplateLocal;
+                TemplateStorage Added;
+                Added.emplace(Name, std::make_shared<const Template>(TemplateLocal));
+                PublishTemplates(std::move(Added), true);
             }
 
             // ! Sets a function that is called when an included file is not found
             void SetIncludeCallback(const std::function<Template(const std::string &, const std::string &)>& Callback){
+                ThrowIfFrozen();
                 ParserConfigurationInstance.IncludeCallback = Callback;
+                TemplateCacheInstance.Clear();
             }
     };
 